@@ -0,0 +1,134 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * batch_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "thread_pool.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * runs 'xbargen' on each design, in a directory of its own, 'jobs' processes at a time
+ */
+static double spawnEach(const string& xbargen, const vector<string>& designs, int jobs){
+	extern char** environ;
+	chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+	size_t next = 0;
+	int running = 0;
+	while(next<designs.size() || running>0){
+		if(next<designs.size() && running<jobs){
+			string dir = "spawn_"+to_string(next);
+			mkdir(dir.c_str(), 0777);
+			string input = "../"+designs[next];
+			const char* argv[] = {xbargen.c_str(), input.c_str(), "--vhdl", NULL};
+			//the child inherits the directory of the design and writes nothing on the terminal
+			pid_t pid;
+			posix_spawn_file_actions_t actions;
+			posix_spawn_file_actions_init(&actions);
+			posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+			if(chdir(dir.c_str())==0){
+				if(posix_spawn(&pid, xbargen.c_str(), &actions, NULL, (char**)argv, environ)==0)
+					running++;
+				if(chdir("..")!=0)
+					printf("ERROR: cannot go back to the work directory\n");
+			}
+			posix_spawn_file_actions_destroy(&actions);
+			next++;
+			continue;
+		}
+		int status;
+		if(wait(&status)>0)
+			running--;
+	}
+	return elapsedMs(t);
+}
+
+/**
+ * Usage: batch_bench [numDesigns [nodes [path/to/XbarGen]]]
+ * Generates 'numDesigns' random multi-level netlists of about 'nodes' signals (200 of 500 by default)
+ * and compiles them, with their VHDL files, in the same process with one worker and with one worker per
+ * hardware thread. If the XbarGen executable is given, the designs are also compiled spawning a process
+ * for each of them (one at a time and one per hardware thread), as a script would do.
+ */
+int main(int argc, char* argv[]){
+	int numDesigns = argc>1? atoi(argv[1]) : 200;
+	int nodes = argc>2? atoi(argv[2]) : 500;
+	string xbargen = argc>3? argv[3] : "";
+	if(!xbargen.empty() && xbargen[0]!='/'){
+		char cwd[4096];
+		if(getcwd(cwd, sizeof(cwd))!=NULL)
+			xbargen = string(cwd)+"/"+xbargen;
+	}
+
+	WorkDirectory workDir("batch_bench");
+	if(!workDir.isOpen()){
+		printf("ERROR: cannot create the work directory\n");
+		return 1;
+	}
+	mkdir("designs", 0777);
+	vector<string> designs;
+	for(int i=0; i<numDesigns; i++){
+		//designs of different sizes, so that the workers have to balance the load
+		int n = nodes/2 + (i*37)%(nodes+1);
+		designs.push_back("designs/d"+to_string(i)+".eqn");
+		generateRandomNetlist(designs.back(), 16+n/50, n, 1+n/100, 4, 4, 1000+i);
+	}
+	XbarGenContext context;
+	context.options.vhdl = true;
+	int threads = ThreadPool::hardwareThreads();
+
+	printf("%d designs of %d-%d signals, %d hardware threads\n", numDesigns, nodes/2, nodes/2+nodes, threads);
+	printf("%-28s %12s %12s\n", "mode", "time(ms)", "designs/s");
+	int workers[] = {1, threads};
+	for(int w=0; w<(threads>1? 2 : 1); w++){
+		BatchCompiler batch(context, "batch_out");
+		batch.addInputs("designs");
+		chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+		int failed = batch.run(workers[w]);
+		double ms = elapsedMs(t);
+		if(failed>0)
+			printf("ERROR: %d designs failed\n", failed);
+		printf("%-28s %12.1f %12.1f\n", ("in process, "+to_string(workers[w])+" workers").c_str(), ms, numDesigns*1000.0/ms);
+		removeTree("batch_out");
+	}
+	if(!xbargen.empty()){
+		for(int w=0; w<(threads>1? 2 : 1); w++){
+			double ms = spawnEach(xbargen, designs, workers[w]);
+			printf("%-28s %12.1f %12.1f\n", ("a process each, "+to_string(workers[w])+" at a time").c_str(), ms, numDesigns*1000.0/ms);
+			for(int i=0; i<numDesigns; i++)
+				removeTree("spawn_"+to_string(i));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * cache_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * compiles 'design' (with its VHDL files) in a new output directory, using the cache 'cacheDir' if it isn't empty
+ */
+static double compileOnce(XbarGenContext& context, const string& design, const string& cacheDir){
+	context.options.cacheDir = cacheDir;
+	removeTree("out");
+	mkdir("out", 0777);
+	chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+	if(!context.compile(design, "out/"))
+		printf("ERROR: %s not compiled\n", design.c_str());
+	return elapsedMs(t);
+}
+
+/**
+ * Usage: cache_bench [nodes [plaCubes]]
+ * Compiles a random multi-level netlist of 'nodes' signals (2000 by default) and a wide PLA of 'plaCubes'
+ * cubes (400 by default), with and without minimization: without the cache, with an empty cache (the
+ * crossbars are generated and stored) and with the cache filled by the previous run (they're all restored).
+ */
+int main(int argc, char* argv[]){
+	int nodes = argc>1? atoi(argv[1]) : 2000;
+	int plaCubes = argc>2? atoi(argv[2]) : 400;
+
+	WorkDirectory workDir("cache_bench");
+	if(!workDir.isOpen()){
+		printf("ERROR: cannot create the work directory\n");
+		return 1;
+	}
+	generateRandomNetlist("netlist.eqn", 16+nodes/50, nodes, 1+nodes/100, 4, 4, 1);
+	generateWidePLA("pla.eqn", 24, 8, plaCubes, 8, 1);
+	const char* designs[] = {"netlist.eqn", "pla.eqn"};
+
+	XbarGenContext context;
+	context.options.vhdl = true;
+	printf("%-12s %-10s %12s %12s %12s\n", "design", "minimize", "no cache", "cold(ms)", "warm(ms)");
+	for(int d=0; d<2; d++){
+		for(int m=0; m<2; m++){
+			context.options.minimize = m==1;
+			double none = compileOnce(context, designs[d], "");
+			double cold = compileOnce(context, designs[d], "cache");
+			double warm = compileOnce(context, designs[d], "cache");
+			printf("%-12s %-10s %12.1f %12.1f %12.1f\n", designs[d], m==1? "yes" : "no", none, cold, warm);
+			removeTree("cache");
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,141 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * cube_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace std;
+
+/**
+ * results of the kernels on a set of cubes (they must not depend on the kernels in use)
+ */
+struct cubeResults{
+	vector<int> first;
+	long long literals;
+	long long contained;
+	long long intersecting;
+	uint64_t hashes;
+
+	bool operator==(const cubeResults& r) const{
+		return first==r.first && literals==r.literals && contained==r.contained
+				&& intersecting==r.intersecting && hashes==r.hashes;
+	}
+};
+
+/**
+ * random cubes over 'numVars' variables with about 'numLiterals' literals each;
+ * one cube out of four is a copy of a previous one, one out of four is a previous one with a literal less
+ */
+static CubeSet randomCubes(int numVars, int numCubes, int numLiterals, unsigned int seed){
+	mt19937 rng(seed);
+	CubeSet cubes(numVars);
+	for(int i=0; i<numCubes; i++){
+		int c = cubes.addCube();
+		int kind = rng()%4;
+		if(c>0 && kind<2){
+			int from = rng()%c;
+			for(int k=0; k<cubes.getNumWords(); k++)
+				cubes.cube(c)[k] = cubes.cube(from)[k];
+			if(kind==1){
+				int var = rng()%numVars;
+				cubes.cube(c)[var/32] |= 3ULL << (2*(var%32));
+			}
+			continue;
+		}
+		for(int l=0; l<numLiterals; l++)
+			cubes.addLiteral(c, rng()%numVars, rng()%2);
+	}
+	return cubes;
+}
+
+static cubeResults run(const CubeSet& cubes, int pairs, double* ms){
+	cubeResults r;
+	r.literals = r.contained = r.intersecting = 0;
+	r.hashes = 0;
+	chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+	r.first = cubes.firstOccurrences();
+	for(int c=0; c<cubes.size(); c++){
+		r.literals += cubes.literalCount(c);
+		r.hashes ^= cubes.hash(c) + c;
+	}
+	//pairs of near cubes, so that containment isn't decided by the first word
+	for(int p=0; p<pairs; p++){
+		int a = p%cubes.size();
+		int b = (a + 1 + p/cubes.size())%cubes.size();
+		r.contained += cubes.contains(a,b);
+		r.intersecting += cubes.intersects(a,b);
+	}
+	*ms = elapsedMs(t);
+	return r;
+}
+
+/**
+ * Usage: cube_bench [numCubes]
+ * For growing numbers of variables, runs deduplication, literal counting, hashing, containment and
+ * intersection with every kernel set the CPU supports, checking that they give the same results.
+ */
+int main(int argc, char* argv[]){
+	int numCubes = argc>1? atoi(argv[1]) : 20000;
+	const char* names[] = {"scalar", "sse2", "avx2"};
+	int widths[] = {16, 64, 256, 1024, 4096};
+
+	bool ok = true;
+	printf("%8s %8s", "vars", "cubes");
+	for(int k=0; k<3; k++)
+		printf(" %12s", (string(names[k])+"(ms)").c_str());
+	printf(" %6s\n", "equal");
+	for(int w=0; w<5; w++){
+		CubeSet cubes = randomCubes(widths[w], numCubes, widths[w]/4+1, 42+w);
+		cubeResults reference;
+		bool equal = true;
+		printf("%8d %8d", widths[w], numCubes);
+		for(int k=0; k<3; k++){
+			if(!CubeSet::useKernels(names[k])){
+				printf(" %12s", "-");
+				continue;
+			}
+			double best = 0;
+			cubeResults r;
+			for(int rep=0; rep<3; rep++){
+				double ms;
+				r = run(cubes, 4*numCubes, &ms);
+				best = (rep==0 || ms<best)? ms : best;
+			}
+			if(k==0)
+				reference = r;
+			else
+				equal = equal && r==reference;
+			printf(" %12.2f", best);
+		}
+		printf(" %6s\n", equal? "yes" : "NO");
+		ok = ok && equal;
+	}
+	return ok? 0 : 1;
+}
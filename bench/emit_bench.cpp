@@ -0,0 +1,151 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * emit_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "boundary.h"
+#include "thread_pool.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+/**
+ * a crossbar structure as the emitters write it: a row of integers per crossbar row,
+ * then a line per wire (as the aliases of the controller)
+ */
+struct fakeCrossbar{
+	int height, width;
+	vector<int> cells;
+};
+
+static fakeCrossbar randomCrossbar(int height, int width, unsigned int seed){
+	mt19937 rng(seed);
+	fakeCrossbar x;
+	x.height = height;
+	x.width = width;
+	for(int i=0; i<height*width; i++)
+		x.cells.push_back(rng()%8==0? 1+rng()%3 : 0);
+	return x;
+}
+
+template<typename stream>
+static void emit(stream& out, const fakeCrossbar& x){
+	out<<"constant cb_height : integer := "<<x.height<<";\n"
+			"constant cb_width : integer := "<<x.width<<";\n";
+	for(int i=0; i<x.height; i++){
+		out<<"\t\t\t\t\t(";
+		for(int j=0; j<x.width; j++)
+			out<<x.cells[i*x.width+j]<<(j!=x.width-1? "," : "");
+		out<<"),"<<'\n';
+	}
+	for(int i=0; i<x.width; i++)
+		out<<"	alias XbG_V"<<i<<" : voltage is Vpos_temp("<<i<<");\n";
+	for(int i=0; i<x.height; i++)
+		out<<"	alias XbG_H"<<i<<" : voltage is Vneg_temp("<<i<<");\n";
+}
+
+/**
+ * the way the emitters wrote before FileWriter: std::cout redirected to an ofstream
+ */
+static void emitRedirected(string file, const fakeCrossbar& x){
+	std::ofstream out(file.c_str());
+	std::streambuf *coutbuf = std::cout.rdbuf();
+	std::cout.rdbuf(out.rdbuf());
+	emit(cout, x);
+	std::cout.rdbuf(coutbuf);
+}
+
+static void emitBuffered(string file, const fakeCrossbar& x){
+	FileWriter out(file);
+	emit(out, x);
+}
+
+static string readFile(string file){
+	ifstream in(file.c_str());
+	stringstream s;
+	s<<in.rdbuf();
+	return s.str();
+}
+
+/**
+ * Usage: emit_bench [numFiles [jobs]]
+ * For growing crossbars, writes 'numFiles' structure-like files through the redirected std::cout
+ * and through FileWriter (sequentially and on 'jobs' threads), checking that the files are equal.
+ * Files are written (and removed) in the current directory.
+ */
+int main(int argc, char* argv[]){
+	int numFiles = argc>1? atoi(argv[1]) : 8;
+	int jobs = argc>2? atoi(argv[2]) : ThreadPool::hardwareThreads();
+	int sizes[] = {64, 256, 1024, 2048};
+	bool ok = true;
+
+	printf("%8s %8s %10s %12s %12s %12s %10s %6s\n", "rows", "columns", "MB/file", "cout(ms)",
+			"writer(ms)", "parallel(ms)", "speedup", "equal");
+	for(int s=0; s<4; s++){
+		fakeCrossbar x = randomCrossbar(sizes[s], sizes[s]/2, 42+s);
+
+		chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+		for(int f=0; f<numFiles; f++)
+			emitRedirected("emit_bench_cout_"+to_string(f)+".vhd", x);
+		double coutMs = elapsedMs(t);
+
+		t = chrono::high_resolution_clock::now();
+		for(int f=0; f<numFiles; f++)
+			emitBuffered("emit_bench_writer_"+to_string(f)+".vhd", x);
+		double writerMs = elapsedMs(t);
+
+		t = chrono::high_resolution_clock::now();
+		{
+			ThreadPool pool(jobs);
+			for(int f=0; f<numFiles; f++)
+				pool.submit([f,&x]{emitBuffered("emit_bench_parallel_"+to_string(f)+".vhd", x);});
+			pool.wait();
+		}
+		double parallelMs = elapsedMs(t);
+
+		bool equal = true;
+		string reference = readFile("emit_bench_cout_0.vhd");
+		for(int f=0; f<numFiles; f++){
+			string redirected = "emit_bench_cout_"+to_string(f)+".vhd";
+			string writer = "emit_bench_writer_"+to_string(f)+".vhd";
+			string parallel = "emit_bench_parallel_"+to_string(f)+".vhd";
+			equal = equal && readFile(writer)==reference && readFile(parallel)==reference;
+			remove(redirected.c_str());
+			remove(writer.c_str());
+			remove(parallel.c_str());
+		}
+		printf("%8d %8d %10.2f %12.2f %12.2f %12.2f %9.2fx %6s\n", x.height, x.width, reference.size()/1e6,
+				coutMs, writerMs, parallelMs, coutMs/writerMs, equal? "yes" : "NO");
+		ok = ok && equal;
+	}
+	return ok? 0 : 1;
+}
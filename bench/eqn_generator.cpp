@@ -0,0 +1,283 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * eqn_generator.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "eqn_generator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <random>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+/*** WORK DIRECTORY ***/
+
+double elapsedMs(chrono::high_resolution_clock::time_point from){
+	return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - from).count();
+}
+
+void removeTree(string dir){
+	DIR* d = opendir(dir.c_str());
+	if(d==NULL)
+		return;
+	for(struct dirent* e = readdir(d); e!=NULL; e = readdir(d)){
+		string name = e->d_name;
+		if(name=="." || name=="..")
+			continue;
+		struct stat st;
+		string path = dir+"/"+name;
+		if(stat(path.c_str(), &st)==0 && S_ISDIR(st.st_mode))
+			removeTree(path);
+		else
+			remove(path.c_str());
+	}
+	closedir(d);
+	rmdir(dir.c_str());
+}
+
+WorkDirectory::WorkDirectory(string name) : entered(false){
+	char cwd[4096];
+	string pattern = "/tmp/"+name+"_XXXXXX";
+	vector<char> dir(pattern.begin(), pattern.end());
+	dir.push_back('\0');
+	if(getcwd(cwd, sizeof(cwd))==NULL || mkdtemp(dir.data())==NULL)
+		return;
+	this->path = dir.data();
+	this->previous = cwd;
+	this->entered = chdir(this->path.c_str())==0;
+	if(!this->entered)
+		rmdir(this->path.c_str());
+}
+
+WorkDirectory::~WorkDirectory(){
+	if(this->entered && chdir(this->previous.c_str())==0)
+		removeTree(this->path);
+}
+
+/*** GENERATORS ***/
+
+/**
+ * writes the list 'names' after 'label', going to a new line every 16 names
+ */
+static void writeOrder(ofstream& out, const char* label, const vector<string>& names){
+	out<<label<<" =";
+	for(size_t i=0; i<names.size(); i++){
+		if(i>0 && i%16==0)
+			out<<"\n   ";
+		out<<" "<<names[i];
+	}
+	out<<";\n";
+}
+
+void generateRandomNetlist(string file, int numInputs, int numNodes, int numOutputs,
+		int maxMinterms, int maxLiterals, unsigned int seed){
+	mt19937 rng(seed);
+	ofstream out(file.c_str());
+
+	vector<string> signals;
+	vector<string> inputs, outputs;
+	for(int i=0; i<numInputs; i++){
+		inputs.push_back("pi"+to_string(i));
+		signals.push_back(inputs.back());
+	}
+	for(int i=numNodes-numOutputs; i<numNodes; i++)
+		outputs.push_back(i<0? "n0" : "n"+to_string(i));
+
+	out<<"# random netlist: "<<numInputs<<" inputs, "<<numNodes<<" nodes, seed "<<seed<<"\n";
+	writeOrder(out, "INORDER", inputs);
+	writeOrder(out, "OUTORDER", outputs);
+
+	for(int n=0; n<numNodes; n++){
+		string name = "n"+to_string(n);
+		//fanins are mostly taken among the most recent signals, so that the netlist has many levels
+		size_t window = signals.size()<64? signals.size() : 64;
+		int numMinterms = 1 + rng()%maxMinterms;
+		out<<name<<" =";
+		for(int m=0; m<numMinterms; m++){
+			if(m>0)
+				out<<(m%4==0? " +\n  " : " +");
+			int numLiterals = 1 + rng()%maxLiterals;
+			for(int l=0; l<numLiterals; l++){
+				size_t s = (rng()%4==0)? rng()%signals.size() : signals.size()-1-rng()%window;
+				out<<(l>0? "*" : " ")<<(rng()%2? "!" : "")<<signals[s];
+			}
+		}
+		out<<";\n";
+		signals.push_back(name);
+	}
+}
+
+void generateCarryChain(string file, int bits){
+	ofstream out(file.c_str());
+	vector<string> inputs, outputs;
+	for(int i=0; i<bits; i++){
+		inputs.push_back("a"+to_string(i));
+		inputs.push_back("b"+to_string(i));
+		outputs.push_back("s"+to_string(i));
+	}
+	inputs.push_back("c0");
+	outputs.push_back("c"+to_string(bits));
+
+	out<<"# "<<bits<<" bits ripple carry adder\n";
+	writeOrder(out, "INORDER", inputs);
+	writeOrder(out, "OUTORDER", outputs);
+	for(int i=0; i<bits; i++){
+		string a = "a"+to_string(i), b = "b"+to_string(i), c = "c"+to_string(i);
+		string p = "p"+to_string(i), k = "k"+to_string(i);
+		out<<p<<" = "<<a<<"*!"<<b<<" + !"<<a<<"*"<<b<<";\n";
+		out<<k<<" = "<<p<<"*"<<c<<";\n";
+		out<<"s"<<i<<" = "<<p<<"*!"<<c<<" + !"<<p<<"*"<<c<<";\n";
+		out<<"c"<<i+1<<" = "<<a<<"*"<<b<<" + "<<k<<"*"<<c<<";\n";
+	}
+}
+
+/**
+ * writes the sum and the carry of the half/full adder of 'bits' (2 or 3 signals)
+ */
+static void writeAdder(ofstream& out, const vector<string>& bits, const string& sum, const string& carry){
+	if(bits.size()==2){
+		out<<sum<<" = "<<bits[0]<<"*!"<<bits[1]<<" + !"<<bits[0]<<"*"<<bits[1]<<";\n";
+		out<<carry<<" = "<<bits[0]<<"*"<<bits[1]<<";\n";
+		return;
+	}
+	const string& x = bits[0];
+	const string& y = bits[1];
+	const string& z = bits[2];
+	out<<sum<<" = "<<x<<"*!"<<y<<"*!"<<z<<" + !"<<x<<"*"<<y<<"*!"<<z<<" + !"<<x<<"*!"<<y<<"*"<<z<<" + "<<x<<"*"<<y<<"*"<<z<<";\n";
+	out<<carry<<" = "<<x<<"*"<<y<<" + "<<x<<"*"<<z<<" + "<<y<<"*"<<z<<";\n";
+}
+
+void generateArrayMultiplier(string file, int bits){
+	ofstream out(file.c_str());
+	vector<string> inputs, outputs;
+	for(int i=0; i<bits; i++)
+		inputs.push_back("a"+to_string(i));
+	for(int i=0; i<bits; i++)
+		inputs.push_back("b"+to_string(i));
+	for(int i=0; i<2*bits; i++)
+		outputs.push_back("m"+to_string(i));
+
+	out<<"# "<<bits<<"x"<<bits<<" array multiplier\n";
+	writeOrder(out, "INORDER", inputs);
+	writeOrder(out, "OUTORDER", outputs);
+
+	//partial sum of each weight
+	vector<string> acc(2*bits);
+	for(int i=0; i<bits; i++){
+		string carry;
+		for(int j=0; j<bits; j++){
+			string pp = "pp"+to_string(i)+"_"+to_string(j);
+			out<<pp<<" = a"<<j<<"*b"<<i<<";\n";
+			vector<string> addends(1,pp);
+			if(!acc[i+j].empty())
+				addends.push_back(acc[i+j]);
+			if(!carry.empty())
+				addends.push_back(carry);
+			if(addends.size()==1){
+				acc[i+j] = pp;
+				carry.clear();
+				continue;
+			}
+			string id = to_string(i)+"_"+to_string(j);
+			writeAdder(out, addends, "s"+id, "c"+id);
+			acc[i+j] = "s"+id;
+			carry = "c"+id;
+		}
+		if(!carry.empty())
+			acc[i+bits] = carry;
+	}
+	for(int w=0; w<2*bits; w++){
+		if(acc[w].empty())
+			out<<"m"<<w<<" = a0*!a0;\n";
+		else
+			out<<"m"<<w<<" = "<<acc[w]<<";\n";
+	}
+}
+
+void generateWidePLA(string file, int numInputs, int numOutputs, int numCubes, int maxLiterals, unsigned int seed){
+	mt19937 rng(seed);
+	ofstream out(file.c_str());
+	vector<string> inputs, outputs;
+	for(int i=0; i<numInputs; i++)
+		inputs.push_back("x"+to_string(i));
+	for(int i=0; i<numOutputs; i++)
+		outputs.push_back("f"+to_string(i));
+
+	out<<"# random PLA: "<<numInputs<<" inputs, "<<numOutputs<<" outputs, "<<numCubes<<" cubes, seed "<<seed<<"\n";
+	writeOrder(out, "INORDER", inputs);
+	writeOrder(out, "OUTORDER", outputs);
+	for(int o=0; o<numOutputs; o++){
+		int cubes = numCubes/numOutputs + (o < numCubes%numOutputs? 1 : 0);
+		out<<outputs[o]<<" =";
+		for(int c=0; c<cubes; c++){
+			if(c>0)
+				out<<(c%4==0? " +\n  " : " +");
+			int numLiterals = 1 + rng()%maxLiterals;
+			for(int l=0; l<numLiterals; l++)
+				out<<(l>0? "*" : " ")<<(rng()%2? "!" : "")<<inputs[rng()%numInputs];
+		}
+		//an output without cubes is constant
+		if(cubes==0)
+			out<<" "<<inputs[0]<<"*!"<<inputs[0];
+		out<<";\n";
+	}
+}
+
+void generateComparator(string file, int bits){
+	ofstream out(file.c_str());
+	vector<string> inputs, outputs;
+	for(int i=0; i<bits; i++){
+		inputs.push_back("a"+to_string(i));
+		inputs.push_back("b"+to_string(i));
+	}
+	outputs.push_back("gt");
+	outputs.push_back("eq");
+	outputs.push_back("lt");
+
+	out<<"# "<<bits<<" bits magnitude comparator\n";
+	writeOrder(out, "INORDER", inputs);
+	writeOrder(out, "OUTORDER", outputs);
+	//g<i> and e<i>: a>b and a=b considering the bits from the most significant one down to i
+	for(int i=bits-1; i>=0; i--){
+		string a = "a"+to_string(i), b = "b"+to_string(i);
+		string x = "x"+to_string(i), g = "g"+to_string(i), e = "e"+to_string(i);
+		out<<x<<" = "<<a<<"*"<<b<<" + !"<<a<<"*!"<<b<<";\n";
+		if(i==bits-1){
+			out<<g<<" = "<<a<<"*!"<<b<<";\n";
+			out<<e<<" = "<<x<<";\n";
+			continue;
+		}
+		string gPrev = "g"+to_string(i+1), ePrev = "e"+to_string(i+1);
+		out<<g<<" = "<<gPrev<<" + "<<ePrev<<"*"<<a<<"*!"<<b<<";\n";
+		out<<e<<" = "<<ePrev<<"*"<<x<<";\n";
+	}
+	out<<"gt = g0;\n";
+	out<<"eq = e0;\n";
+	out<<"lt = !g0*!e0;\n";
+}
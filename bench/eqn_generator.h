@@ -0,0 +1,98 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * eqn_generator.h
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#ifndef EQN_GENERATOR_H_
+#define EQN_GENERATOR_H_
+
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+/**
+ * ms elapsed since 'from'
+ */
+double elapsedMs(chrono::high_resolution_clock::time_point from);
+
+/**
+ * removes 'dir' and everything inside it
+ */
+void removeTree(string dir);
+
+/**
+ * A new directory in /tmp (named after 'name') which is the working directory of the benchmark while
+ * the object exists: then the previous working directory is restored, and the new one is removed with
+ * the circuits and the files written inside it.
+ */
+class WorkDirectory{
+
+private:
+	string path;
+	string previous;
+	bool entered;
+
+public:
+	WorkDirectory(string name);
+	WorkDirectory(const WorkDirectory&) = delete;
+	WorkDirectory& operator=(const WorkDirectory&) = delete;
+	~WorkDirectory();
+	bool isOpen() const {return entered;}
+};
+
+/**
+ * Writes in 'file' a random multi-level netlist in .eqn format:
+ * 'numInputs' primary inputs, 'numNodes' internal signals (each one a sum of at most 'maxMinterms'
+ * minterms of at most 'maxLiterals' literals taken among inputs and previous signals)
+ * and the last 'numOutputs' signals as outputs. Long expressions are split over more lines.
+ */
+void generateRandomNetlist(string file, int numInputs, int numNodes, int numOutputs,
+		int maxMinterms, int maxLiterals, unsigned int seed);
+
+/**
+ * Writes in 'file' a 'bits'-wide ripple carry adder. Each carry depends on the previous one both
+ * directly and through the propagate term, so the number of paths doubles at each bit.
+ */
+void generateCarryChain(string file, int bits);
+
+/**
+ * Writes in 'file' a 'bits' x 'bits' array multiplier (partial products summed row by row
+ * with half and full adders).
+ */
+void generateArrayMultiplier(string file, int bits);
+
+/**
+ * Writes in 'file' a random two-level PLA: 'numOutputs' outputs, each one a sum of 'numCubes'/'numOutputs'
+ * cubes of at most 'maxLiterals' literals taken among all the 'numInputs' inputs (a single wide level).
+ */
+void generateWidePLA(string file, int numInputs, int numOutputs, int numCubes, int maxLiterals, unsigned int seed);
+
+/**
+ * Writes in 'file' a 'bits'-wide magnitude comparator (a>b, a=b, a<b), rippling from the most
+ * significant bit: each bit depends on the result of the previous one.
+ */
+void generateComparator(string file, int bits);
+
+#endif /* EQN_GENERATOR_H_ */
@@ -0,0 +1,162 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * eqn_parse_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "boundary.h"
+#include "my_utils.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * interns a name of the getline parser (negations are "not_" prefixes)
+ */
+static literal legacyLiteral(string name){
+	bool negated = false;
+	while(name.compare(0,4,"not_")==0){
+		name = name.substr(4);
+		negated = !negated;
+	}
+	return makeLiteral(signalTable().intern(name),negated);
+}
+
+/**
+ * getline based parser, as it was in Analyzer::analyzeFunctionFromEQN() before the EQNReader:
+ * it's the reference both for the results and for the timing
+ */
+static bool legacyParseEQN(string file, Function& func){
+	const string inputLabel = "INORDER";
+	const string outputLabel = "OUTORDER";
+	string line;
+	ifstream myfile(file);
+	if (!myfile.is_open())
+		return false;
+	string expression;
+	while ( getline (myfile,line) )
+	{
+		if(line.length()>0 && line.at(0)=='#')
+			continue;
+
+		expression+=line;
+		if(expression.find(";")!= std::string::npos){
+			expression = expression.substr(0,expression.find_last_of(';'));
+
+			int equal = expression.find_first_of ('=');
+			string leftExpression = trim(expression.substr(0, equal));
+			string rightExpression = trim(expression.substr(equal+1));
+
+			if(leftExpression==inputLabel){
+				vector<string> inputs = tokenize(rightExpression," ");
+				for(vector<string>::const_iterator i = inputs.begin(); i!= inputs.end();i++){
+					func.addInput(legacyLiteral(*i));
+				}
+				for(vector<string>::const_iterator i = inputs.begin(); i!= inputs.end();i++){
+					func.addInput(legacyLiteral("not_"+*i));
+				}
+			}
+			else if(leftExpression==outputLabel){
+				vector<string> outputs = tokenize(rightExpression," ");
+				for(vector<string>::const_iterator i = outputs.begin(); i!= outputs.end();i++){
+					func.addOutput(signalTable().intern(*i));
+				}
+			}
+			else{
+				symbol out = signalTable().intern(leftExpression);
+				vector<string> minterms = tokenize(rightExpression,"+");
+				for(vector<string>::iterator i = minterms.begin(); i!=minterms.end();i++){
+					replace_substring(&*i, string("!"),string("not_"));
+					replace_substring(&*i, string("*"),string(" "));
+					trim(&*i);
+					vector<string> names = tokenize(*i," ");
+					vector<literal> literals;
+					for(vector<string>::const_iterator j = names.begin(); j!= names.end();j++){
+						literals.push_back(legacyLiteral(*j));
+					}
+					func.addMinterm(out,literals);
+				}
+			}
+			expression.clear();
+		}
+		else if(*(expression.end()-1) == '\n' || *(expression.end()-1) == '\r'){
+			expression = expression.substr(0,expression.find_last_of('\n'));
+			expression = expression.substr(0,expression.find_last_of('\r'));
+			continue;
+		}
+	}
+	return true;
+}
+
+/**
+ * Usage: eqn_parse_bench [numNodes ...]
+ * For each size, generates a random netlist, parses it with both readers (best of 3 runs)
+ * and checks that the resulting functions are the same.
+ */
+int main(int argc, char* argv[]){
+	vector<int> sizes;
+	for(int i=1; i<argc; i++)
+		sizes.push_back(atoi(argv[i]));
+	if(sizes.empty()){
+		sizes.push_back(10000);
+		sizes.push_back(100000);
+		sizes.push_back(1000000);
+	}
+
+	bool ok = true;
+	printf("%10s %12s %14s %14s %9s %6s\n", "nodes", "size(MB)", "getline(ms)", "mmap(ms)", "speedup", "equal");
+	for(size_t s=0; s<sizes.size(); s++){
+		string file = "./eqn_parse_bench_"+to_string(sizes[s])+".eqn";
+		generateRandomNetlist(file, 64, sizes[s], 16, 6, 5, 1234+s);
+		struct stat st;
+		stat(file.c_str(), &st);
+
+		double legacyTime = 0, mmapTime = 0;
+		bool equal = true;
+		for(int run=0; run<3; run++){
+			Function legacy, mapped;
+			chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+			legacyParseEQN(file, legacy);
+			double l = elapsedMs(t);
+
+			t = chrono::high_resolution_clock::now();
+			EQNReader reader(file);
+			reader.read(mapped);
+			double m = elapsedMs(t);
+
+			legacyTime = (run==0 || l<legacyTime)? l : legacyTime;
+			mmapTime = (run==0 || m<mmapTime)? m : mmapTime;
+			equal = equal && (legacy == mapped);
+		}
+		ok = ok && equal;
+		printf("%10d %12.1f %14.1f %14.1f %8.2fx %6s\n", sizes[s], st.st_size/1048576.0,
+				legacyTime, mmapTime, legacyTime/mmapTime, equal? "yes" : "NO");
+		remove(file.c_str());
+	}
+	return ok? 0 : 1;
+}
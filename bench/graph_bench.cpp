@@ -0,0 +1,192 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * graph_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+
+using namespace std;
+
+/**
+ * bytes allocated on the heap, big blocks (mapped on their own) included
+ */
+static size_t heapInUse(){
+	struct mallinfo2 m = mallinfo2();
+	return m.uordblks + m.hblkhd;
+}
+
+/**
+ * results of the visits (they must not depend on the graph form)
+ */
+struct visitResults{
+	long long outSum;
+	long long levelSum;
+	int maxLevel;
+
+	bool operator==(const visitResults& r) const{
+		return outSum==r.outSum && levelSum==r.levelSum && maxLevel==r.maxLevel;
+	}
+};
+
+/**
+ * visits of the list graph: a sweep of the arcs leaving each node and a topological
+ * levelization (from the terms without dependencies, walking the arcs backwards)
+ */
+static visitResults visit(const DependencyGraph& g){
+	visitResults r;
+	r.outSum = r.levelSum = 0;
+	r.maxLevel = 0;
+	for(ListDigraph::NodeIt n(g); n != INVALID; ++n)
+		for(ListDigraph::OutArcIt a(g, n); a != INVALID; ++a)
+			r.outSum += g.name(g.target(a));
+
+	ListDigraph::NodeMap<int> pending(g,0), levels(g,0);
+	vector<ListDigraph::Node> ready;
+	for(ListDigraph::NodeIt n(g); n != INVALID; ++n){
+		pending[n] = countOutArcs(g, n);
+		if(pending[n]==0)
+			ready.push_back(n);
+	}
+	while(!ready.empty()){
+		ListDigraph::Node v = ready.back();
+		ready.pop_back();
+		r.levelSum += levels[v];
+		r.maxLevel = max(r.maxLevel, levels[v]);
+		for(ListDigraph::InArcIt a(g, v); a != INVALID; ++a){
+			ListDigraph::Node u = g.source(a);
+			levels[u] = max(levels[u], levels[v]+1);
+			if(--pending[u]==0)
+				ready.push_back(u);
+		}
+	}
+	return r;
+}
+
+/**
+ * the same visits on the frozen graph
+ */
+static visitResults visit(const FrozenGraph& g){
+	visitResults r;
+	r.outSum = r.levelSum = 0;
+	r.maxLevel = 0;
+	for(int v=0; v<g.numNodes(); v++)
+		for(int t : g.outNodes(v))
+			r.outSum += g.name(t);
+
+	vector<int> pending(g.numNodes()), levels(g.numNodes(),0);
+	vector<int> ready;
+	for(int v=0; v<g.numNodes(); v++){
+		pending[v] = g.outNodes(v).size();
+		if(pending[v]==0)
+			ready.push_back(v);
+	}
+	while(!ready.empty()){
+		int v = ready.back();
+		ready.pop_back();
+		r.levelSum += levels[v];
+		r.maxLevel = max(r.maxLevel, levels[v]);
+		for(int u : g.inNodes(v)){
+			levels[u] = max(levels[u], levels[v]+1);
+			if(--pending[u]==0)
+				ready.push_back(u);
+		}
+	}
+	return r;
+}
+
+/**
+ * builds the dependency graph of a random netlist of 'numNodes' signals, copies it back in a list graph,
+ * then measures the heap taken by both forms and times the visits on both of them;
+ * returns false if the visits give different results
+ */
+static bool run(int numNodes, string file){
+	generateRandomNetlist(file, numNodes/10, numNodes, numNodes/100+1, 3, 4, numNodes);
+	Analyzer an(file);
+	an.analyzeFunctionFromEQN();
+	an.createDependenciesGraph();
+	remove(file.c_str());
+
+	size_t before = heapInUse();
+	DependencyGraph list;
+	vector<ListDigraph::Node> nodeOf;
+	const FrozenGraph& source = an.getGraph();
+	for(int v=0; v<source.numNodes(); v++)
+		nodeOf.push_back(list.addNode(source.name(v)));
+	for(int v=0; v<source.numNodes(); v++)
+		for(int t : source.outNodes(v))
+			list.addArc(nodeOf[v], nodeOf[t]);
+	nodeOf.clear();
+	nodeOf.shrink_to_fit();
+	size_t listBytes = heapInUse() - before;
+
+	before = heapInUse();
+	FrozenGraph frozen;
+	chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+	frozen.build(list);
+	double freezeMs = elapsedMs(t);
+	size_t frozenBytes = heapInUse() - before;
+
+	double listMs = 0, frozenMs = 0;
+	visitResults listResults, frozenResults;
+	for(int rep=0; rep<3; rep++){
+		t = chrono::high_resolution_clock::now();
+		listResults = visit(list);
+		double ms = elapsedMs(t);
+		listMs = (rep==0 || ms<listMs)? ms : listMs;
+		t = chrono::high_resolution_clock::now();
+		frozenResults = visit(frozen);
+		ms = elapsedMs(t);
+		frozenMs = (rep==0 || ms<frozenMs)? ms : frozenMs;
+	}
+
+	int arcs = frozen.numArcs();
+	bool equal = listResults==frozenResults;
+	printf("%9d %9d %9d %11.1f %11.1f %10.2f %10.2f %10.2f %6s\n", numNodes, frozen.numNodes(), arcs,
+			(double)listBytes/arcs, (double)frozenBytes/arcs, freezeMs, listMs, frozenMs, equal? "yes" : "NO");
+	return equal;
+}
+
+/**
+ * Usage: graph_bench [maxNodes]
+ * Builds the dependency graph of random netlists of growing size and compares the list graph used while
+ * building it with its frozen compressed sparse row form: heap bytes per arc (nodes included) and time of
+ * an out-arc sweep plus a topological levelization, checking that both forms give the same results.
+ */
+int main(int argc, char* argv[]){
+	int maxNodes = argc>1? atoi(argv[1]) : 409600;
+
+	bool ok = true;
+	printf("%9s %9s %9s %11s %11s %10s %10s %10s %6s\n", "signals", "nodes", "arcs", "list(B/arc)", "csr(B/arc)",
+			"freeze(ms)", "list(ms)", "csr(ms)", "equal");
+	for(int nodes=100; nodes<=maxNodes; nodes*=4){
+		string file = "./graph_bench"+to_string(nodes)+".eqn";
+		ok = run(nodes, file) && ok;
+	}
+	return ok? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * levelize_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+
+using namespace std;
+
+//the recursive walk gives up after this number of calls
+static const long long recursionBudget = 200000000LL;
+
+/**
+ * Dependency graph rebuilt straight from the generated file,
+ * levelized with the recursive walk that Analyzer::build_levels() used to do:
+ * it's the reference both for the results and for the timing
+ */
+struct LegacyLevels{
+	ListDigraph graph;
+	ListDigraph::NodeMap<int> levels;
+	vector<ListDigraph::Node> nodeOf;
+	vector<symbol> inputs;
+	long long calls;
+
+	LegacyLevels() : levels(graph,0), calls(0){};
+
+	ListDigraph::Node node(symbol s){
+		if(s>=nodeOf.size())
+			nodeOf.resize(s+1, INVALID);
+		if(nodeOf[s]==INVALID)
+			nodeOf[s] = graph.addNode();
+		return nodeOf[s];
+	}
+
+	void load(string file){
+		ifstream in(file.c_str());
+		string line, statement;
+		set<pair<int,int> > arcs;
+		while(getline(in,statement,';')){
+			//drop the comment lines
+			line.clear();
+			for(size_t first=0; first<statement.size(); ){
+				size_t eol = statement.find('\n',first);
+				if(eol==string::npos)
+					eol = statement.size();
+				if(statement[first]!='#')
+					line += " "+statement.substr(first,eol-first);
+				first = eol+1;
+			}
+			vector<string> names;
+			string name;
+			for(size_t i=0; i<=line.size(); i++){
+				if(i<line.size() && (isalnum(line[i]) || line[i]=='_'))
+					name += line[i];
+				else if(!name.empty()){
+					names.push_back(name);
+					name.clear();
+				}
+			}
+			if(names.empty() || names[0]=="OUTORDER")
+				continue;
+			if(names[0]=="INORDER"){
+				for(size_t i=1; i<names.size(); i++)
+					inputs.push_back(signalTable().intern(names[i]));
+				continue;
+			}
+			ListDigraph::Node u = node(signalTable().intern(names[0]));
+			for(size_t i=1; i<names.size(); i++){
+				ListDigraph::Node v = node(signalTable().intern(names[i]));
+				if(arcs.insert(make_pair(graph.id(u),graph.id(v))).second)
+					graph.addArc(u,v);
+			}
+		}
+	}
+
+	bool walk(ListDigraph::Node u, int lev){
+		if(++calls>recursionBudget)
+			return false;
+		levels[u] = max(levels[u],lev);
+		for (ListDigraph::InArcIt a(graph, u); a!=INVALID; ++a)
+			if(!walk(graph.source(a),lev+1))
+				return false;
+		return true;
+	}
+
+	bool levelize(){
+		for(size_t i=0; i<inputs.size(); i++)
+			if(inputs[i]<nodeOf.size() && nodeOf[inputs[i]]!=INVALID && !walk(nodeOf[inputs[i]],0))
+				return false;
+		return true;
+	}
+};
+
+/**
+ * levelizes 'file' with both the topological levelization and the recursive walk,
+ * prints the timings and returns false if the levels differ
+ */
+static bool run(const char* circuit, int bits, string file){
+	Analyzer an(file);
+	an.analyzeFunctionFromEQN();
+	chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+	an.createDependenciesGraph();
+	double kahnTime = elapsedMs(t);
+
+	LegacyLevels legacy;
+	legacy.load(file);
+	t = chrono::high_resolution_clock::now();
+	bool finished = legacy.levelize();
+	double legacyTime = elapsedMs(t);
+
+	int nodes = 0;
+	bool equal = true;
+	const map <int, vector<int> >& levels = an.getLevels();
+	for(map <int, vector<int> >::const_iterator i = levels.begin(); i != levels.end(); i++){
+		for(vector<int>::const_iterator j = i->second.begin(); j != i->second.end(); j++){
+			nodes++;
+			if(finished)
+				equal = equal && legacy.levels[legacy.nodeOf[an.getNodeName(*j)]]==i->first;
+		}
+	}
+
+	char legacyColumn[32];
+	if(finished)
+		snprintf(legacyColumn, sizeof(legacyColumn), "%.2f", legacyTime);
+	else
+		snprintf(legacyColumn, sizeof(legacyColumn), "> %.0f", legacyTime);
+	printf("%-11s %6d %9d %7d %12.2f %16s %6s\n", circuit, bits, nodes, levels.empty()? 0 : levels.rbegin()->first,
+			kahnTime, legacyColumn, finished? (equal? "yes" : "NO") : "-");
+	remove(file.c_str());
+	return equal;
+}
+
+/**
+ * Usage: levelize_bench [maxAdderBits [maxMultiplierBits]]
+ * Levelizes ripple carry adders and array multipliers of growing width, timing
+ * Analyzer::createDependenciesGraph() (graph and topological levels) against the former
+ * recursive walk (stopped after a fixed number of calls) and checking that the levels are the same.
+ */
+int main(int argc, char* argv[]){
+	int maxAdderBits = argc>1? atoi(argv[1]) : 4096;
+	int maxMultiplierBits = argc>2? atoi(argv[2]) : 64;
+
+	bool ok = true;
+	printf("%-11s %6s %9s %7s %12s %16s %6s\n", "circuit", "bits", "nodes", "levels", "kahn(ms)", "recursive(ms)", "equal");
+	for(int bits=4; bits<=maxAdderBits; bits*=2){
+		string file = "./levelize_bench_adder"+to_string(bits)+".eqn";
+		generateCarryChain(file, bits);
+		ok = run("carry chain", bits, file) && ok;
+	}
+	for(int bits=2; bits<=maxMultiplierBits; bits*=2){
+		string file = "./levelize_bench_mult"+to_string(bits)+".eqn";
+		generateArrayMultiplier(file, bits);
+		ok = run("multiplier", bits, file) && ok;
+	}
+	return ok? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * lookup_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace std;
+
+/**
+ * the linear scan of the nodes that getVertexByName() used to do: it's the reference
+ * both for the results and for the timing
+ */
+static int legacyLookup(const FrozenGraph& g, symbol s){
+	for(int v=0; v<g.numNodes(); v++){
+		if(g.name(v) == s)
+			return v;
+	}
+	return -1;
+}
+
+static double elapsedNs(chrono::high_resolution_clock::time_point from){
+	return chrono::duration<double, nano>(chrono::high_resolution_clock::now() - from).count();
+}
+
+/**
+ * looks up random signals of a random netlist of 'numNodes' signals (one lookup out of eight is
+ * a name that isn't in the graph) with both the lookups, prints the timings and returns false
+ * if they find different nodes
+ */
+static bool run(int numNodes, int legacyLookups, int indexedLookups, string file){
+	generateRandomNetlist(file, numNodes/10, numNodes, numNodes/100+1, 3, 4, numNodes);
+	Analyzer an(file);
+	an.analyzeFunctionFromEQN();
+	an.createDependenciesGraph();
+	const FrozenGraph& g = an.getGraph();
+
+	mt19937 rng(numNodes);
+	vector<symbol> names;
+	for(int i=0; i<indexedLookups; i++){
+		symbol s = rng()%signalTable().size();
+		names.push_back(rng()%8==0? signalTable().intern("missing_"+to_string(i)) : s);
+	}
+
+	bool equal = true;
+	chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+	vector<int> found;
+	for(int i=0; i<legacyLookups; i++)
+		found.push_back(legacyLookup(g, names[i]));
+	double legacyNs = elapsedNs(t)/legacyLookups;
+
+	t = chrono::high_resolution_clock::now();
+	long long hits = 0;
+	for(int i=0; i<indexedLookups; i++)
+		hits += g.node(names[i]) != -1;
+	double indexedNs = elapsedNs(t)/indexedLookups;
+
+	for(int i=0; i<legacyLookups; i++)
+		equal = equal && g.node(names[i]) == found[i];
+
+	printf("%9d %9d %14.1f %14.1f %10lld %6s\n", numNodes, g.numNodes(), legacyNs, indexedNs, hits, equal? "yes" : "NO");
+	remove(file.c_str());
+	return equal;
+}
+
+/**
+ * Usage: lookup_bench [maxNodes [legacyLookups]]
+ * Builds the dependency graph of random netlists of growing size and looks up random signals
+ * by name, timing the index of the dependency graph against the former linear scan of the nodes
+ * and checking that they find the same nodes.
+ */
+int main(int argc, char* argv[]){
+	int maxNodes = argc>1? atoi(argv[1]) : 409600;
+	int legacyLookups = argc>2? atoi(argv[2]) : 200;
+	int indexedLookups = 1000000;
+	if(legacyLookups>indexedLookups)
+		legacyLookups = indexedLookups;
+
+	bool ok = true;
+	printf("%9s %9s %14s %14s %10s %6s\n", "signals", "nodes", "linear(ns)", "indexed(ns)", "hits", "equal");
+	for(int nodes=100; nodes<=maxNodes; nodes*=4){
+		string file = "./lookup_bench"+to_string(nodes)+".eqn";
+		ok = run(nodes, legacyLookups, indexedLookups, file) && ok;
+	}
+	return ok? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * matrix_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace std;
+
+/**
+ * Usage: matrix_bench [literalsPerRow]
+ * For growing crossbars (laid out as Translator does: IL row, cube rows, output rows) compares
+ * the dense vector<vector<int>> matrix with CrossbarMatrix: memory, memristor count and the scan
+ * of the memristors, checking that both give the same cells.
+ */
+int main(int argc, char* argv[]){
+	int literalsPerRow = argc>1? atoi(argv[1]) : 8;
+	int inputs[] = {16, 64, 256, 1024, 4096};
+	bool ok = true;
+
+	printf("%8s %8s %14s %14s %10s %10s %10s %10s %6s\n", "rows", "columns", "dense(bytes)", "bitset(bytes)",
+			"dense(ms)", "count(ms)", "dscan(ms)", "iter(ms)", "equal");
+	for(int i=0; i<5; i++){
+		int numInput = inputs[i], numOutput = numInput/8, numMinterms = 4*numInput;
+		int height = 1+numMinterms+numOutput, width = numInput+2*numOutput;
+		mt19937 rng(42+i);
+
+		vector< vector<int> > dense(height, vector<int>(width, 0));
+		CrossbarMatrix sparse(height, width);
+		for(int c=0; c<width; c++){
+			dense[0][c] = 1;
+			sparse.set(0, c, 1);
+		}
+		for(int r=1; r<=numMinterms; r++){
+			for(int l=0; l<literalsPerRow; l++){
+				int c = rng()%numInput;
+				dense[r][c] = 1;
+				sparse.set(r, c, 1);
+			}
+			int o = numInput + 2*(rng()%numOutput);
+			dense[r][o] = 1;
+			sparse.set(r, o, 1);
+		}
+		for(int o=0; o<numOutput; o++){
+			int r = 1+numMinterms+o;
+			dense[r][numInput+2*o] = o+2;
+			dense[r][numInput+2*o+1] = 1;
+			sparse.set(r, numInput+2*o, o+2);
+			sparse.set(r, numInput+2*o+1, 1);
+		}
+
+		size_t denseBytes = sizeof(dense) + height*(sizeof(vector<int>) + width*sizeof(int));
+
+		chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+		int denseCount = 0;
+		for(int r=0; r<height; r++)
+			for(int c=0; c<width; c++)
+				denseCount += dense[r][c]!=0;
+		double denseMs = elapsedMs(t);
+
+		t = chrono::high_resolution_clock::now();
+		int sparseCount = sparse.count();
+		double countMs = elapsedMs(t);
+
+		//the scans fold the cells in a checksum, so that they are compared (and not optimized away)
+		t = chrono::high_resolution_clock::now();
+		long long denseSum = 0;
+		for(int r=0; r<height; r++)
+			for(int c=0; c<width; c++)
+				if(dense[r][c]!=0)
+					denseSum += (long long)r*width*31 + c*7 + dense[r][c];
+		double denseScanMs = elapsedMs(t);
+
+		t = chrono::high_resolution_clock::now();
+		long long sparseSum = 0;
+		for(CrossbarMatrix::const_iterator it = sparse.begin(); it != sparse.end(); ++it){
+			CrossbarMatrix::cell cell = *it;
+			sparseSum += (long long)cell.row*width*31 + cell.column*7 + cell.value;
+		}
+		double iterMs = elapsedMs(t);
+
+		bool equal = denseCount==sparseCount && denseSum==sparseSum;
+		printf("%8d %8d %14zu %14zu %10.2f %10.2f %10.2f %10.2f %6s\n", height, width, denseBytes,
+				sparse.memoryUsage(), denseMs, countMs, denseScanMs, iterMs, equal? "yes" : "NO");
+		ok = ok && equal;
+	}
+	return ok? 0 : 1;
+}
@@ -0,0 +1,197 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * pipeline_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "profiler.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * a circuit family: it writes in 'file' a circuit of about 'nodes' signals
+ */
+struct circuitFamily{
+	const char* name;
+	void (*generate)(string file, int nodes);
+};
+
+static void randomDAG(string file, int nodes){
+	generateRandomNetlist(file, 32+nodes/100, nodes, 1+nodes/100, 4, 4, 42);
+}
+
+//16 outputs on 64 inputs: the PLA is a single level, with a row for each cube
+static void widePLA(string file, int nodes){
+	generateWidePLA(file, 64, 16, nodes, 8, 42);
+}
+
+//4 signals for each bit
+static void carryChain(string file, int nodes){
+	generateCarryChain(file, max(1, nodes/4));
+}
+
+//about 3 signals for each partial product
+static void multiplier(string file, int nodes){
+	generateArrayMultiplier(file, max(2, (int)sqrt(nodes/3.0)));
+}
+
+//3 signals for each bit
+static void comparator(string file, int nodes){
+	generateComparator(file, max(1, nodes/3));
+}
+
+static const circuitFamily families[] = {
+	{"random", randomDAG},
+	{"pla", widePLA},
+	{"carry", carryChain},
+	{"multiplier", multiplier},
+	{"comparator", comparator},
+};
+
+/**
+ * total duration of the recorded phases called 'name'
+ */
+static double duration(const vector<phaseRecord>& phases, const char* name){
+	double ms = 0;
+	for(size_t i=0; i<phases.size(); i++)
+		if(phases[i].name==name)
+			ms += phases[i].duration;
+	return ms;
+}
+
+/**
+ * removes the files written by a run (the work directory has no subdirectories)
+ */
+static void clean(string dir){
+	DIR* d = opendir(dir.c_str());
+	if(d==NULL)
+		return;
+	for(struct dirent* e = readdir(d); e!=NULL; e = readdir(d)){
+		string name = e->d_name;
+		if(name!="." && name!="..")
+			remove((dir+"/"+name).c_str());
+	}
+	closedir(d);
+}
+
+/**
+ * Usage: pipeline_bench [maxNodes [file.csv [families]]]
+ * Generates circuits of each family (random multi-level DAGs, wide two-level PLAs, carry chains,
+ * array multipliers, comparators; 'families' is a comma separated subset of them) with 10, 100, ...
+ * up to 'maxNodes' signals (10^6 by default) and runs the whole pipeline on each of them (sequentially),
+ * timing parsing, graph building, levelization, translation, voltage generation and VHDL emission.
+ * Results are printed and written as CSV ("pipeline_bench.csv" by default), one row per circuit.
+ */
+int main(int argc, char* argv[]){
+	long maxNodes = argc>1? atol(argv[1]) : 1000000;
+	string csvFile = argc>2? argv[2] : "pipeline_bench.csv";
+	string selected = argc>3? ","+string(argv[3])+"," : "";
+
+	FILE* csv = fopen(csvFile.c_str(), "w");
+	if(csv==NULL){
+		printf("ERROR: cannot write %s\n", csvFile.c_str());
+		return 1;
+	}
+	WorkDirectory workDir("pipeline_bench");
+	if(!workDir.isOpen()){
+		printf("ERROR: cannot create the work directory\n");
+		fclose(csv);
+		return 1;
+	}
+
+	Profiler& profiler = currentContext().profiler;
+	profiler.enable();
+	fprintf(csv, "family,size,nodes,levels,eqn_bytes,parse_ms,graph_ms,levelize_ms,translate_ms,voltages_ms,emit_ms,"
+			"total_ms,peak_rss_kb,rss_growth_kb,allocations\n");
+	printf("%-11s %8s %8s %7s %10s %10s %11s %12s %11s %10s %10s %11s %9s\n", "family", "nodes", "levels", "MB",
+			"parse(ms)", "graph(ms)", "levels(ms)", "translate(ms)", "voltages(ms)", "emit(ms)", "total(ms)", "+rss(MB)", "allocs/node");
+	for(size_t f=0; f<sizeof(families)/sizeof(families[0]); f++){
+		if(!selected.empty() && selected.find(","+string(families[f].name)+",")==string::npos)
+			continue;
+		for(long size=10; size<=maxNodes; size*=10){
+			string file = string("./")+families[f].name+"_"+to_string(size)+".eqn";
+			families[f].generate(file, size);
+			struct stat st;
+			long bytes = stat(file.c_str(), &st)==0? st.st_size : 0;
+
+			//the memory freed by the previous run goes back to the system, so that the peak is of this run
+			profiler.takePhases();
+			malloc_trim(0);
+			Profiler::resetPeakResidentMemory();
+			long startRss = Profiler::residentMemory();
+			uint64_t allocations = Profiler::processAllocations();
+			double start = profiler.elapsed();
+			int nodes = 0, levels = 0;
+			{
+				Analyzer an(file);
+				an.analyzeFunctionFromEQN();
+				if(!an.createDependenciesGraph()){
+					printf("ERROR: %s has a combinational cycle\n", file.c_str());
+					clean(".");
+					continue;
+				}
+				an.generateCrossbar();
+				an.generateOutputVHDL();
+				for(map <int, vector<int> >::const_iterator i = an.getLevels().begin(); i != an.getLevels().end(); i++){
+					if(i->first!=0)
+						nodes += i->second.size();
+					levels = max(levels, i->first);
+				}
+			}
+			double total = profiler.elapsed() - start;
+			long peakRss = Profiler::peakResidentMemory();
+			allocations = Profiler::processAllocations() - allocations;
+
+			//the crossbars are translated sequentially, so the voltages are part of the translation time
+			vector<phaseRecord> phases = profiler.takePhases();
+			double parse = duration(phases, "Analyzer::analyzeFunctionFromEQN");
+			double graph = duration(phases, "Analyzer::build_dependencies");
+			double levelize = duration(phases, "Analyzer::createDependenciesGraph") - graph;
+			double voltages = duration(phases, "Translator::generateVoltages");
+			double translate = duration(phases, "Analyzer::generateCrossbar") - voltages;
+			double emit = duration(phases, "Analyzer::generateOutputVHDL");
+
+			fprintf(csv, "%s,%ld,%d,%d,%ld,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%ld,%ld,%llu\n", families[f].name, size, nodes, levels,
+					bytes, parse, graph, levelize, translate, voltages, emit, total, peakRss, peakRss-startRss,
+					(unsigned long long)allocations);
+			fflush(csv);
+			printf("%-11s %8d %8d %7.2f %10.2f %10.2f %11.2f %12.2f %11.2f %10.2f %10.2f %11.1f %9.1f\n", families[f].name,
+					nodes, levels, bytes/1e6, parse, graph, levelize, translate, voltages, emit, total, (peakRss-startRss)/1024.0,
+					nodes>0? (double)allocations/nodes : 0.0);
+			fflush(stdout);
+			clean(".");
+		}
+	}
+	fclose(csv);
+	return 0;
+}
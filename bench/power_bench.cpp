@@ -0,0 +1,148 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * power_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "thread_pool.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+
+using namespace std;
+
+typedef vector< pair<symbol, vector<literal> > > mintermList;
+
+/**
+ * random two-level function of 'numVars' inputs (symbols 0..numVars-1) and 4 outputs: 'numCubes' cubes of at most
+ * 'maxLiterals' literals; some of them are copies of previous ones (for another output), a few are empty
+ */
+static mintermList randomFunction(int numVars, int numCubes, int maxLiterals, unsigned int seed){
+	mt19937 rng(seed);
+	mintermList minterms;
+	for(int c=0; c<numCubes; c++){
+		symbol out = numVars + rng()%4;
+		if(c>0 && rng()%8==0){
+			minterms.push_back(make_pair(out, minterms[rng()%c].second));
+			continue;
+		}
+		set<literal> literals;
+		int n = 1 + rng()%maxLiterals;
+		for(int l=0; l<n; l++)
+			literals.insert(makeLiteral(rng()%numVars, rng()%2));
+		if(rng()%32==0)
+			literals.insert(negateLiteral(*literals.begin()));
+		minterms.push_back(make_pair(out, vector<literal>(literals.begin(), literals.end())));
+	}
+	return minterms;
+}
+
+static Function buildFunction(const mintermList& minterms, int numVars){
+	Function f;
+	for(int v=0; v<numVars; v++){
+		f.addInput(makeLiteral(v));
+		f.addInput(makeLiteral(v,true));
+	}
+	for(int o=0; o<4; o++)
+		f.addOutput(numVars+o);
+	for(mintermList::const_iterator m = minterms.begin(); m != minterms.end(); ++m)
+		f.addMinterm(m->first, m->second);
+	f.buildCubes();
+	return f;
+}
+
+/**
+ * switching memristors for the vector 'x' (bit v: input v), straight from the definition: the literals which are 0
+ * in the distinct cubes (NAND) and the cubes whose literals are all 1 (AND)
+ */
+static int switchingOf(const mintermList& minterms, uint64_t x){
+	set< vector<literal> > distinct;
+	int n = 0;
+	for(mintermList::const_iterator m = minterms.begin(); m != minterms.end(); ++m){
+		bool on = true;
+		bool first = distinct.insert(m->second).second;
+		for(vector<literal>::const_iterator l = m->second.begin(); l != m->second.end(); ++l){
+			bool value = ((x>>symbolOf(*l))&1) != isNegated(*l);
+			on = on && value;
+			n += (first && !value)? 1 : 0;
+		}
+		n += on? 1 : 0;
+	}
+	return n;
+}
+
+/**
+ * Usage: power_bench [jobs]
+ * For random functions of growing number of inputs, computes the worst and best case switching activity
+ * on one thread and on 'jobs' threads (one per hardware thread by default), checking that they're the same.
+ * Up to 14 inputs they're also checked against all the input vectors, tried one at a time.
+ */
+int main(int argc, char* argv[]){
+	int jobs = argc>1? atoi(argv[1]) : ThreadPool::hardwareThreads();
+	int sizes[] = {8, 14, 18, 22, 24, 32, 64, 128};
+	bool ok = true;
+
+	printf("%6s %6s %6s %6s %8s %8s %12s %12s %7s\n", "inputs", "cubes", "worst", "best", "error", "exact",
+			"1 job(ms)", "jobs(ms)", "check");
+	for(int s=0; s<8; s++){
+		int n = sizes[s];
+		int numCubes = 4*n;
+		mintermList minterms = randomFunction(n, numCubes, 4, 7+s);
+		Function f = buildFunction(minterms, n);
+
+		chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+		SwitchingActivity one = f.switchingActivity(1);
+		double msOne = elapsedMs(t);
+		t = chrono::high_resolution_clock::now();
+		SwitchingActivity many = f.switchingActivity(jobs);
+		double msMany = elapsedMs(t);
+
+		//same result on any number of threads, and the vectors give the values found
+		bool check = one.worst==many.worst && one.best==many.best && one.worstVector==many.worstVector
+				&& one.bestVector==many.bestVector;
+		uint64_t worstX = 0, bestX = 0;
+		for(int v=0; v<n && v<64; v++){
+			worstX |= (uint64_t)one.worstVector[v]<<v;
+			bestX |= (uint64_t)one.bestVector[v]<<v;
+		}
+		if(n<=64)
+			check = check && switchingOf(minterms, worstX)==one.worst && switchingOf(minterms, bestX)==one.best;
+		if(n<=14){
+			int worst = -1, best = 1<<30;
+			for(uint64_t x=0; x < (1ULL<<n); x++){
+				int value = switchingOf(minterms, x);
+				worst = max(worst, value);
+				best = min(best, value);
+			}
+			check = check && worst==one.worst && best==one.best;
+		}
+		ok = ok && check;
+		printf("%6d %6d %6d %6d %8d %8s %12.1f %12.1f %7s\n", n, numCubes, one.worst, one.best,
+				one.worstError+one.bestError, one.exact? "yes" : "no", msOne, msMany, check? "ok" : "WRONG");
+	}
+	return ok? 0 : 1;
+}
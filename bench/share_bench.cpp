@@ -0,0 +1,100 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * share_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * removes the files of 'dir' (and the directory), counting them and their bytes in 'files' and 'bytes'
+ */
+static void removeOutput(string dir, int* files, long long* bytes){
+	*files = 0;
+	*bytes = 0;
+	DIR* d = opendir(dir.c_str());
+	if(d==NULL)
+		return;
+	for(struct dirent* e = readdir(d); e!=NULL; e = readdir(d)){
+		string name = e->d_name;
+		if(name=="." || name=="..")
+			continue;
+		struct stat st;
+		string path = dir+"/"+name;
+		if(stat(path.c_str(), &st)==0){
+			(*files)++;
+			*bytes += st.st_size;
+		}
+		remove(path.c_str());
+	}
+	closedir(d);
+	rmdir(dir.c_str());
+}
+
+/**
+ * Usage: share_bench [bits]
+ * Compiles, with their VHDL files, a carry chain, a comparator and an array multiplier ('bits' wide,
+ * 32 by default; 'bits'/4 for the multiplier), whose levels are mostly the same function of different signals:
+ * with an entity for each crossbar (--no-share) and with the equivalent crossbars sharing their entity.
+ */
+int main(int argc, char* argv[]){
+	int bits = argc>1? atoi(argv[1]) : 32;
+
+	WorkDirectory workDir("share_bench");
+	if(!workDir.isOpen()){
+		printf("ERROR: cannot create the work directory\n");
+		return 1;
+	}
+	generateCarryChain("adder.eqn", bits);
+	generateComparator("comparator.eqn", bits);
+	generateArrayMultiplier("multiplier.eqn", bits/4);
+	const char* designs[] = {"adder.eqn", "comparator.eqn", "multiplier.eqn"};
+
+	XbarGenContext context;
+	context.options.vhdl = true;
+	printf("%-16s %-8s %10s %8s %12s\n", "design", "share", "time(ms)", "files", "bytes");
+	for(int d=0; d<3; d++){
+		for(int s=0; s<2; s++){
+			context.options.shareEntities = s==1;
+			mkdir("out", 0777);
+			chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+			if(!context.compile(designs[d], "out/"))
+				printf("ERROR: %s not compiled\n", designs[d]);
+			double ms = elapsedMs(t);
+			int files;
+			long long bytes;
+			removeOutput("out", &files, &bytes);
+			printf("%-16s %-8s %10.1f %8d %12lld\n", designs[d], s==1? "yes" : "no", ms, files, bytes);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+ * sim_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * Usage: sim_bench [jobs]
+ * Synthesizes the crossbars of a few generated designs (exhaustively simulated up to 20 inputs, on a random
+ * sample beyond) and simulates them with one job and with 'jobs' (one per hardware thread by default):
+ * the time of the simulation, the crossbars and the input vectors are printed, and the wrong outputs
+ * (there should be none) are counted.
+ */
+int main(int argc, char* argv[]){
+	int jobs = argc>1? atoi(argv[1]) : ThreadPool::hardwareThreads();
+
+	WorkDirectory workDir("sim_bench");
+	if(!workDir.isOpen()){
+		printf("ERROR: cannot create the work directory\n");
+		return 1;
+	}
+	generateCarryChain("adder8.eqn", 8);
+	generateArrayMultiplier("multiplier4.eqn", 4);
+	generateRandomNetlist("random16.eqn", 16, 400, 16, 4, 4, 1);
+	generateCarryChain("adder64.eqn", 64);
+	generateRandomNetlist("random64.eqn", 64, 4000, 64, 6, 5, 2);
+	const char* designs[] = {"adder8.eqn", "multiplier4.eqn", "random16.eqn", "adder64.eqn", "random64.eqn"};
+
+	int failures = 0;
+	printf("%-16s %8s %10s %6s %10s %10s\n", "design", "crossbars", "vectors", "jobs", "time(ms)", "wrong");
+	for(int d=0; d<5; d++){
+		XbarGenContext context;
+		ContextScope scope(context);
+		Analyzer an(designs[d]);
+		if(!an.analyzeFunctionFromEQN() || !an.createDependenciesGraph()){
+			printf("ERROR: %s not synthesized\n", designs[d]);
+			return 1;
+		}
+		an.generateCrossbar();
+		for(int j=0; j<2; j++){
+			context.options.jobs = j==0? 1 : jobs;
+			chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+			bool ok = an.simulateCrossbars();
+			double ms = elapsedMs(t);
+			vector< pair<string,double> > stats = an.getSizeStats();
+			printf("%-16s %8d %10ld %6d %10.1f %10s\n", designs[d], (int)stats[6].second, an.getSimulatedVectors(),
+					context.options.jobs, ms, ok? "0" : "some");
+			failures += ok? 0 : 1;
+		}
+	}
+	return failures>0? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * structure_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * removes the files of 'dir' (and the directory), counting the bytes of all of them in 'bytes'
+ * and the ones of the crossbar structures in 'structureBytes'
+ */
+static void removeOutput(string dir, long long* bytes, long long* structureBytes){
+	*bytes = 0;
+	*structureBytes = 0;
+	DIR* d = opendir(dir.c_str());
+	if(d==NULL)
+		return;
+	for(struct dirent* e = readdir(d); e!=NULL; e = readdir(d)){
+		string name = e->d_name;
+		if(name=="." || name=="..")
+			continue;
+		struct stat st;
+		string path = dir+"/"+name;
+		if(stat(path.c_str(), &st)==0){
+			*bytes += st.st_size;
+			if(name.compare(0, 19, "crossbar_structure_")==0)
+				*structureBytes += st.st_size;
+		}
+		remove(path.c_str());
+	}
+	closedir(d);
+	rmdir(dir.c_str());
+}
+
+/**
+ * Usage: structure_bench [cubes]
+ * Compiles, with their VHDL files, a wide PLA ('cubes' cubes, 4000 by default, over 128 inputs), a random
+ * netlist and an array multiplier, with the dense structure of each crossbar (its whole matrix) and with
+ * the sparse one (the list of its memristors): the time, the bytes of the structures and the bytes of
+ * all the VHDL files are printed.
+ */
+int main(int argc, char* argv[]){
+	int cubes = argc>1? atoi(argv[1]) : 4000;
+
+	WorkDirectory workDir("structure_bench");
+	if(!workDir.isOpen()){
+		printf("ERROR: cannot create the work directory\n");
+		return 1;
+	}
+	generateWidePLA("pla.eqn", 128, 16, cubes, 12, 1);
+	generateRandomNetlist("random.eqn", 64, 4000, 64, 6, 5, 2);
+	generateArrayMultiplier("multiplier.eqn", 16);
+	const char* designs[] = {"pla.eqn", "random.eqn", "multiplier.eqn"};
+
+	XbarGenContext context;
+	context.options.vhdl = true;
+	printf("%-16s %-8s %10s %16s %12s\n", "design", "sparse", "time(ms)", "structure bytes", "VHDL bytes");
+	for(int d=0; d<3; d++){
+		for(int s=0; s<2; s++){
+			context.options.sparseStructure = s==1;
+			mkdir("out", 0777);
+			chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+			if(!context.compile(designs[d], "out/"))
+				printf("ERROR: %s not compiled\n", designs[d]);
+			double ms = elapsedMs(t);
+			long long bytes, structureBytes;
+			removeOutput("out", &bytes, &structureBytes);
+			printf("%-16s %-8s %10.1f %16lld %12lld\n", designs[d], s==1? "yes" : "no", ms, structureBytes, bytes);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * subfunction_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "boundary.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+
+using namespace std;
+
+/**
+ * bytes allocated on the heap, big blocks (mapped on their own) included
+ */
+static size_t heapInUse(){
+	struct mallinfo2 m = mallinfo2();
+	return m.uordblks + m.hblkhd;
+}
+
+/**
+ * splits 'file' in levels (as Analyzer does) and takes the minterms of each level both as a copy,
+ * the way the sub-functions used to get them, and as a view over the parsed function; the sub-functions
+ * of all the levels stay alive together, as the Translators do. Prints heap bytes and times of both,
+ * returns false if a view doesn't walk the same minterms as the copy.
+ */
+static bool run(const char* family, int size, string file){
+	Analyzer an(file);
+	an.analyzeFunctionFromEQN();
+	an.createDependenciesGraph();
+	Function f;
+	EQNReader reader(file);
+	reader.read(f);
+	remove(file.c_str());
+
+	vector<vector<symbol> > levelOutputs;
+	for(map <int, vector<int> >::const_iterator i = an.getLevels().begin(); i != an.getLevels().end(); i++){
+		if(i->first==0)
+			continue;
+		levelOutputs.push_back(vector<symbol>());
+		for(vector<int>::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
+			levelOutputs.back().push_back(an.getNodeName(*j));
+	}
+
+	size_t before = heapInUse();
+	chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+	//the copy inserts the minterms of each output (found through a view of a single output)
+	vector<multimap<symbol,vector<literal> > > copies(levelOutputs.size());
+	for(size_t l=0; l<levelOutputs.size(); l++){
+		for(vector<symbol>::const_iterator o = levelOutputs[l].begin(); o != levelOutputs[l].end(); ++o){
+			MintermView minterms = f.getMinterms(vector<symbol>(1,*o));
+			for(MintermView::const_iterator m = minterms.begin(); m != minterms.end(); ++m)
+				copies[l].insert(*m);
+		}
+	}
+	double copyMs = elapsedMs(t);
+	size_t copyBytes = heapInUse() - before;
+
+	before = heapInUse();
+	t = chrono::high_resolution_clock::now();
+	vector<MintermView> views;
+	for(size_t l=0; l<levelOutputs.size(); l++)
+		views.push_back(f.getMinterms(levelOutputs[l]));
+	double viewMs = elapsedMs(t);
+	size_t viewBytes = heapInUse() - before;
+
+	bool equal = true;
+	for(size_t l=0; l<levelOutputs.size(); l++)
+		equal = equal && MintermView(copies[l]) == views[l];
+
+	printf("%-8s %7d %7d %9d %12.2f %12.3f %10.2f %10.2f %6s\n", family, size, (int)levelOutputs.size(), f.getNumMinterms(),
+			copyBytes/1048576.0, viewBytes/1048576.0, copyMs, viewMs, equal? "yes" : "NO");
+	return equal;
+}
+
+/**
+ * Usage: subfunction_bench [maxSize]
+ * For random multi-level netlists and wide two-level PLAs of growing size, compares the minterms of the
+ * sub-functions (one per level) taken as copies with the views the Translators now get.
+ */
+int main(int argc, char* argv[]){
+	int maxSize = argc>1? atoi(argv[1]) : 204800;
+
+	bool ok = true;
+	printf("%-8s %7s %7s %9s %12s %12s %10s %10s %6s\n", "family", "size", "levels", "minterms",
+			"copy(MB)", "view(MB)", "copy(ms)", "view(ms)", "equal");
+	for(int size=800; size<=maxSize; size*=4){
+		string file = "./subfunction_bench_net"+to_string(size)+".eqn";
+		generateRandomNetlist(file, 32+size/100, size, 1+size/100, 4, 4, 42);
+		ok = run("netlist", size, file) && ok;
+	}
+	for(int size=800; size<=maxSize; size*=4){
+		string file = "./subfunction_bench_pla"+to_string(size)+".eqn";
+		generateWidePLA(file, 64, 16, size, 8, 42);
+		ok = run("pla", size, file) && ok;
+	}
+	return ok? 0 : 1;
+}
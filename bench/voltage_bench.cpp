@@ -0,0 +1,132 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * voltage_bench.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "eqn_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <sstream>
+
+using namespace std;
+
+/**
+ * bytes allocated on the heap, big blocks (mapped on their own) included
+ */
+static size_t heapInUse(){
+	struct mallinfo2 m = mallinfo2();
+	return m.uordblks + m.hblkhd;
+}
+
+typedef map< string, map<string, string> > legacyVoltages;
+
+static void legacyStage(legacyVoltages& voltages, const char* name, int height, int width, int numInputs, int numOutputs,
+		const char* row0, const char* cubeRows, const char* outputRows, const char* inputs, const char* outputs, const char* negatedOutputs){
+	map<string,string> stage;
+	stage.insert(make_pair("XbG_H0",row0));
+	for(int i=1; i<height-numOutputs; i++)
+		stage.insert(make_pair("XbG_H"+to_string(i),cubeRows));
+	for(int i=height-numOutputs; i<height; i++)
+		stage.insert(make_pair("XbG_H"+to_string(i),outputRows));
+	for(int i=0; i<numInputs; i++)
+		stage.insert(make_pair("XbG_V"+to_string(i),inputs));
+	for(int i=numInputs; i<width; i+=2){
+		stage.insert(make_pair("XbG_V"+to_string(i),outputs));
+		stage.insert(make_pair("XbG_V"+to_string(i+1),negatedOutputs));
+	}
+	voltages.insert(make_pair(name,stage));
+}
+
+/**
+ * the voltages as Translator::generateVoltages() used to compute them: a map of names for each stage
+ */
+static void legacyGenerate(legacyVoltages& voltages, int height, int width, int numInputs, int numOutputs){
+	legacyStage(voltages, "A_INA", height, width, numInputs, numOutputs, "Vw", "Vw", "Vw", "zero", "zero", "zero");
+	legacyStage(voltages, "B_RI", height, width, numInputs, numOutputs, "zero", "Vr", "Vr", "Z", "Vr", "Vr");
+	legacyStage(voltages, "C_CFM", height, width, numInputs, numOutputs, "Vw", "zero", "Vr", "Z", "Vr", "Vr");
+	legacyStage(voltages, "D_EVM", height, width, numInputs, numOutputs, "Vr", "Z", "Vr", "Vr", "Vr", "Vw");
+	legacyStage(voltages, "E_EVR", height, width, numInputs, numOutputs, "Vr", "Vw", "zero", "Vr", "Vr", "Z");
+	legacyStage(voltages, "F_INR", height, width, numInputs, numOutputs, "Vr", "Vr", "Z", "Vr", "Vw", "Vr");
+}
+
+static void legacyPrint(const legacyVoltages& voltages, ostream& out){
+	for(legacyVoltages::const_iterator i = voltages.begin(); i != voltages.end(); i++){
+		out<<"Stage "<<i->first<<":"<<endl;
+		for(map<string,string>::const_iterator j = i->second.begin(); j != i->second.end(); j++)
+			out<<j->first<<"="<<j->second<<endl;
+		out<<endl;
+	}
+}
+
+/**
+ * computes the voltages of a crossbar with 'numInputs' input columns, 'numCubes' cube rows and 'numOutputs' outputs
+ * both as maps of names and as a table, prints heap bytes and times of both and returns false if they differ
+ */
+static bool run(int numInputs, int numCubes, int numOutputs){
+	int height = 1+numCubes+numOutputs;
+	int width = numInputs+2*numOutputs;
+
+	size_t before = heapInUse();
+	chrono::high_resolution_clock::time_point t = chrono::high_resolution_clock::now();
+	legacyVoltages* legacy = new legacyVoltages();
+	legacyGenerate(*legacy, height, width, numInputs, numOutputs);
+	double legacyMs = elapsedMs(t);
+	size_t legacyBytes = heapInUse() - before;
+
+	before = heapInUse();
+	t = chrono::high_resolution_clock::now();
+	CrossbarVoltages* table = new CrossbarVoltages(height, width);
+	table->generate(numInputs, numOutputs);
+	double tableMs = elapsedMs(t);
+	size_t tableBytes = heapInUse() - before;
+
+	ostringstream legacyText, tableText;
+	legacyPrint(*legacy, legacyText);
+	table->print(tableText);
+	bool equal = legacyText.str() == tableText.str();
+	delete legacy;
+	delete table;
+
+	printf("%8d %8d %12.1f %12.3f %11.2f %11.3f %6s\n", height, width, legacyBytes/1024.0, tableBytes/1024.0,
+			legacyMs, tableMs, equal? "yes" : "NO");
+	return equal;
+}
+
+/**
+ * Usage: voltage_bench [maxCubes]
+ * For crossbars of growing size, computes the voltages of the six FSM stages both as the maps of names
+ * used before and as the dense table, comparing heap, time and the printed voltages.
+ */
+int main(int argc, char* argv[]){
+	int maxCubes = argc>1? atoi(argv[1]) : 409600;
+
+	bool ok = true;
+	printf("%8s %8s %12s %12s %11s %11s %6s\n", "height", "width", "maps(KB)", "table(KB)", "maps(ms)", "table(ms)", "equal");
+	for(int cubes=100; cubes<=maxCubes; cubes*=4)
+		ok = run(2*(16+cubes/100), cubes, 1+cubes/50) && ok;
+	return ok? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * boundary.h
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#ifndef BOUNDARY_H_
+#define BOUNDARY_H_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include "entities.h"
+
+using namespace std;
+
+/**
+ * Non-owning view over a run of characters (e.g. a token within a mapped file).
+ * It never allocates: it's valid as long as the underlying buffer is.
+ */
+struct stringView{
+	const char* data;
+	size_t length;
+
+	stringView() : data(NULL), length(0){};
+	stringView(const char* data, size_t length) : data(data), length(length){};
+	bool empty() const {return length==0;}
+	string str() const {return string(data,length);}
+	bool operator==(const char* s) const {return strlen(s)==length && memcmp(data,s,length)==0;}
+};
+
+/**
+ * This class is expected to:
+ * - map an .eqn file in memory
+ * - scan it in one pass, splitting it into statements and tokens (as stringView, without copies)
+ * - fill a Function object with inputs, outputs and minterms found in the file (names are interned
+ * 	in the signal table straight from the mapped buffer)
+ */
+class EQNReader{
+
+private:
+	string file;
+	const char* buffer;
+	size_t size;
+	string scratch;
+	vector<literal> literals;
+
+	bool mapFile();
+	void unmapFile();
+	void parseStatement(stringView, Function&);
+	void parseMinterm(symbol, stringView, Function&);
+
+public:
+	EQNReader(string file) : file(file), buffer(NULL), size(0){};
+	bool read(Function&);
+	~EQNReader(){unmapFile();};
+};
+
+/**
+ * This class is expected to:
+ * - collect the text of an output file (VHDL, statistics, DOT) in memory, in a large buffer that is
+ * 	reused by the following files written by the same thread
+ * - format integers straight into the buffer, without going through iostreams
+ * - write the whole file with a single bulk write when it's closed (or destroyed)
+ * Writers share no state, so different files can be written by different threads at the same time.
+ */
+class FileWriter{
+
+private:
+	string file;
+	string* buffer;
+
+	void appendInteger(unsigned long long, bool);
+
+public:
+	FileWriter(string file);
+	FileWriter(const FileWriter&) = delete;
+	FileWriter& operator=(const FileWriter&) = delete;
+	FileWriter& operator<<(const char*);
+	FileWriter& operator<<(const string&);
+	FileWriter& operator<<(char);
+	FileWriter& operator<<(int);
+	FileWriter& operator<<(long);
+	FileWriter& operator<<(long long);
+	FileWriter& operator<<(unsigned int);
+	FileWriter& operator<<(unsigned long);
+	FileWriter& operator<<(unsigned long long);
+	FileWriter& operator<<(double);
+	bool close();
+	~FileWriter(){close();};
+};
+
+#endif /* BOUNDARY_H_ */
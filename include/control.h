@@ -31,25 +31,166 @@
 #include <cstring>
 #include <set>
 #include "entities.h"
+#include "profiler.h"
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include <lemon/list_graph.h>
 #include <lemon/bits/graph_extender.h>
 
 using namespace std;
 using namespace lemon;
 
-static int numOfXbarStates = 7;
-
+/**
+ * Options of a synthesis: they're set before the synthesis starts (e.g. while parsing the command line),
+ * and then they're only read
+ */
 struct executionParameters{
 	bool dot;
 	bool deepDot;
 	bool vhdl;
 	bool stat;
 	bool verbose;
+	bool minimize;
+	bool shareEntities;	//equivalent crossbars share their VHDL entity
+	bool simulate;	//the crossbars are simulated against their sub-functions
+	bool verify;	//the crossbars are checked against the function of the EQN file
+	bool sharedClock;	//the VHDL memristors and controllers take one clock from the top entity
+	bool sparseStructure;	//the VHDL structure of a crossbar lists its memristors instead of its cells
+	int jobs;
+	string traceFile;	//empty if the trace isn't demanded
+	string cacheDir;	//empty if the crossbars aren't cached
+
+	executionParameters() : dot(false), deepDot(false), vhdl(false), stat(false), verbose(false),
+			minimize(false), shareEntities(true), simulate(false), verify(false), sharedClock(false), sparseStructure(false), jobs(0){};
+};
+
+/**
+ * This class is expected to:
+ * - hold the state of a synthesis: its options, its symbol table, the VHDL reserved words
+ * 		and the VHDL names already filtered
+ * - synthesize a circuit from an EQN file, as its options demand
+ * Different contexts share nothing, so they can synthesize different circuits in the same process at the same time.
+ * The code of the synthesis finds the context of the calling thread through currentContext(): it's the one
+ * selected by the innermost ContextScope (e.g. compile() selects its own context), or a process-wide one.
+ */
+class XbarGenContext{
+
+private:
+	SymbolTable symbols;
+	//read-only once loaded, so it can be shared by more contexts
+	shared_ptr< const unordered_set<string> > reservedWords;
+	unordered_map<string,string> filteredNames;
+	mutex filterLock;
+
+public:
+	executionParameters options;
+	Profiler profiler;
+
+	XbarGenContext(){};
+	XbarGenContext(const XbarGenContext&) = delete;
+	XbarGenContext& operator=(const XbarGenContext&) = delete;
+	SymbolTable& getSymbols() {return symbols;}
+	bool loadVHDLReservedWords(string = "./VHDLrsrvdWords.dat");
+	bool hasVHDLReservedWords() const {return reservedWords!=nullptr;}
+	void shareVHDLReservedWords(const XbarGenContext&);
+	string VHDLsintaxFilter(string);
+	bool compile(string, string = "./", vector< pair<string,double> >* = NULL);
+};
+
+XbarGenContext& currentContext();
+
+/**
+ * Selects 'context' as the context of the calling thread for the scope it's declared in
+ */
+class ContextScope{
+
+private:
+	XbarGenContext* previous;
+
+public:
+	ContextScope(XbarGenContext& context);
+	ContextScope(const ContextScope&) = delete;
+	ContextScope& operator=(const ContextScope&) = delete;
+	~ContextScope();
+};
+
+/**
+ * This class is expected to check that two networks of sums of products (e.g. the function of an EQN file and
+ * the functions read back from its crossbars) compute the same outputs from the same primary inputs:
+ * - each network is compiled into a flat program, evaluated on 64 input vectors per word
+ * - up to maxExhaustiveInputs primary inputs all the input vectors are simulated; beyond, a random sample of them,
+ * 		and then the signals computed by both networks are proven equal by SAT miters, in order of depth: the cone of
+ * 		a miter stops at the signals already proven equal, which become inputs shared by both sides. An output still
+ * 		unproven gets the miter of its whole cone, which gives a counterexample if it differs.
+ * - simulations and miters run on a thread pool, with more jobs
+ * The signals which neither network computes, but the primary inputs, are 0.
+ */
+class EquivalenceChecker{
+
+public:
+	enum side {reference, implementation};
+	enum verdict {equivalent, different, undecided};
+
+	//input vectors of a simulation task: 64 per word
+	static const int simulationWords = 64;
+	//up to this number of primary inputs all the input vectors are simulated, otherwise a random sample of them
+	static const int maxExhaustiveInputs = 20;
+	static const long randomVectors = 1L<<16;
+	//conflicts after which a miter is left undecided
+	static const long conflictBudget = 100000;
+
+private:
+	/**
+	 * a network compiled in order of evaluation: products and literals of each gate are consecutive
+	 */
+	struct program{
+		vector<symbol> gates;	//signal of each gate
+		vector<int> gateProducts;	//first product of each gate, then the end of the last one
+		vector<int> productLiterals;	//first literal of each product, then the end of the last one
+		vector<literal> literals;
+		vector<int> gateOf;	//gate of each signal (-1 if the network doesn't compute it)
+	};
+
+	int numSymbols;
+	vector<symbol> inputs;
+	vector<symbol> outputs;
+	vector<bool> isInput;
+	program programs[2];
+
+	verdict result;
+	bool exhaustive;
+	long vectors;
+	long miters;
+	symbol failingOutput;
+	vector<bool> counterexample;	//value of each primary input
+	vector<symbol> undecidedOutputs;
+
+	void evaluate(const program&, uint64_t*, int) const;
+	long simulateBlock(long, int*, vector<bool>*) const;
+	void simulate(int);
+	void prove(int);
+	verdict miter(symbol, const vector<bool>&, vector<bool>*) const;
+
+public:
+	EquivalenceChecker(vector<symbol> inputs, vector<symbol> outputs, int numSymbols);
+	void addGate(side, symbol);
+	void addProduct(side, const vector<literal>&);
+	verdict check(int = 1);
+	verdict getVerdict() const {return result;}
+	bool isExhaustive() const {return exhaustive;}
+	long getVectors() const {return vectors;}
+	long getMiters() const {return miters;}
+	symbol getFailingOutput() const {return failingOutput;}
+	const vector<bool>& getCounterexample() const {return counterexample;}
+	const vector<symbol>& getUndecidedOutputs() const {return undecidedOutputs;}
+	static void inputVectors(long, bool, const vector<symbol>&, int, uint64_t*);
 };
 
-extern executionParameters execParameters;
-extern std::chrono::steady_clock::time_point beginTime;
+class Translator;
 
 /**
  * This class is expected to:
@@ -62,46 +203,87 @@ extern std::chrono::steady_clock::time_point beginTime;
 class Analyzer{
 
 private:
+	static const int numOfXbarStates = 7;
+
 	string file;
-	ListDigraph graph;
-	ListDigraph::NodeMap<string> nodeNames;
-	map <int, vector<ListDigraph::NodeIt> > nodeLevels;
+	chrono::high_resolution_clock::time_point start;
+	FrozenGraph graph;
+	map <int, vector<int> > nodeLevels;
 	vector<Analyzer*> subAnalyzers;
+	//input vectors of the last simulation of the crossbars, and how many of them gave a wrong output
+	long simulatedVectors;
+	long simulationMismatches;
+	bool simulationExhaustive;
+	//result of the last check of the crossbars against the function of the EQN file
+	EquivalenceChecker::verdict verification;
+	bool verificationExhaustive;
+	long verificationVectors;
+	long verificationMiters;
 
-	ListDigraph::NodeIt verify_dependencies(string s);
-	void build_levels( ListDigraph::Node,ListDigraph::NodeMap<int>*,int);
+	void build_dependencies();
+	bool build_levels(vector<int>*);
+	void shareEquivalentCrossbars();
 	void generateStructuralOutputVHDL();
 	int getNumOfStages();
 	int getNumOfComputationSteps();
 	int getNumOfMinterms();
-	int* getPowerConsumption();
+	vector<int> getPowerConsumption(vector<SwitchingActivity>*);
+	Translator* translateLevel(int,const vector<int>&);
+	vector<symbol> primaryInputs();
+	long simulateBlock(long,bool,long,const vector<symbol>&,const vector<CrossbarSimulator>&,long*,int*,int*,vector<bool>*);
 
 protected:
+	//context of the synthesis (the one of the thread which created the Analyzer)
+	XbarGenContext* context;
 	Function func;
 	int level;
+	//directory of the output files (ending with '/')
+	string outputDir;
+	//whether the crossbar and its VHDL files were taken from the cache (only for a sub-function)
+	bool crossbarFromCache;
+	bool filesFromCache;
+	//sub-function whose VHDL entity is instantiated for this one (NULL if it has its own entity)
+	Analyzer* sharedEntity;
+	//verbose output of a sub-function (it can be translated on a worker thread, so it's printed later)
+	ostringstream verboseLog;
 
-	Analyzer(int ,vector<string>,
-			vector<string> ,
-			multimap<string,vector<string> > );
+	Analyzer(int ,vector<literal>,
+			vector<symbol> ,
+			MintermView );
 	virtual int getNumMemristor();
 	virtual int getArea();
-	virtual int* getOperativeMemristorPowerConsumption();
+	virtual SwitchingActivity getSwitchingActivity();
+	virtual vector<int> getMinimizationStats();
+	virtual const Crossbar* getCrossbar();
 
 public:
-	Analyzer(string file) :  file (file), graph(), nodeNames(graph),level(-1){};
+	Analyzer(string file, string outputDir = "./") :  file (file), start(chrono::high_resolution_clock::now()),
+			graph(), simulatedVectors(0), simulationMismatches(0), simulationExhaustive(false),
+			verification(EquivalenceChecker::undecided), verificationExhaustive(false), verificationVectors(0), verificationMiters(0),
+			context(&currentContext()), level(-1), outputDir(outputDir),
+			crossbarFromCache(false), filesFromCache(false), sharedEntity(NULL){};
 	void analyzeFunctionFromXML();
-	void analyzeFunctionFromEQN();
-	void createDependenciesGraph(int = -1);
+	bool analyzeFunctionFromEQN();
+	bool createDependenciesGraph(int = -1);
 	void virtual generateCrossbar();
 	void virtual generateOutputVHDL();
-	void printOutputStats();
+	bool simulateCrossbars();
+	bool verifyEquivalence();
+	long getSimulatedVectors() const {return simulatedVectors;}
+	EquivalenceChecker::verdict getVerification() const {return verification;}
+	vector< pair<string,double> > getSizeStats();
+	void printOutputStats(bool = true);
 	void printFunction(){func.printFunction();}
-	virtual ~Analyzer(){};
+	string getVerboseLog() const {return verboseLog.str();}
+	const map <int, vector<int> >& getLevels() const {return nodeLevels;}
+	symbol getNodeName(int v) const {return graph.name(v);}
+	const FrozenGraph& getGraph() const {return graph;}
+	virtual ~Analyzer();
 };
 
 /**
  * This class is expected to:
- * - translate a 2level boolean function into a FBLC crossbar
+ * - translate a 2level boolean function into a FBLC crossbar (minimizing it first, if demanded)
  * - generate, if demanded, the VHDL implementation of such crossbar
 */
 
@@ -110,22 +292,97 @@ class Translator : public Analyzer{
 private:
 
 	Crossbar* xbar;
+	//crossbar size before the minimization (-1 if the sub-function isn't minimized)
+	int rowsBeforeMinimization;
+	int memristorsBeforeMinimization;
+	//canonical description of the sub-function, as it's looked for in the cache
+	string cacheDescription;
 
 	void create_index();
+	string describe();
+	string describeFiles();
+	vector<string> VHDLfileNames();
 	int getNumMemristor() override;
 	int getArea() override;
-	int* getOperativeMemristorPowerConsumption() override;
+	SwitchingActivity getSwitchingActivity() override;
+	vector<int> getMinimizationStats() override;
+	const Crossbar* getCrossbar() override {return xbar;}
 
 
 public:
 	Translator(int level,
-			vector<string> inputs,
-			vector<string> outputs,
-			multimap<string,vector<string> > minterms) : Analyzer(level,inputs, outputs,minterms), xbar(NULL) {};
+			vector<literal> inputs,
+			vector<symbol> outputs,
+			MintermView minterms) : Analyzer(level,move(inputs),move(outputs),move(minterms)), xbar(NULL),
+			rowsBeforeMinimization(-1), memristorsBeforeMinimization(-1) {func.buildCubes();};
+	void minimize();
 	void generateCrossbar() override;
 	void generateVoltages();
+	bool loadFromCache();
+	void storeInCache();
 	void generateOutputVHDL() override;
-	virtual ~Translator() {};
+	virtual ~Translator() {delete xbar;};
+};
+
+/**
+ * This class is expected to:
+ * - keep on disk the crossbars of the sub-functions already translated: each entry is a file named after the
+ * 		hash of the canonical description of its sub-function (its key), and it holds the description itself,
+ * 		so a hash collision is just a miss
+ * - keep the VHDL files of the crossbars, named after a key which also covers what else they depend on
+ * 		(level, names of the signals in the VHDL files)
+ * Entries and files are written to a temporary file and then renamed, so that concurrent runs
+ * sharing the directory never read a half-written one.
+ */
+class CrossbarCache{
+
+private:
+	string dir;
+
+	bool writeFile(const string&, const string&) const;
+
+public:
+	CrossbarCache(string dir);
+	static string keyOf(const string&);
+	bool read(const string&, string*) const;
+	bool write(const string&, const string&) const;
+	bool restoreFiles(const string&, const string&, const vector<string>&) const;
+	void storeFiles(const string&, const string&, const vector<string>&) const;
+};
+
+/**
+ * This class is expected to:
+ * - compile a batch of EQN files (the ones of a directory, or the ones of a list) in the same process,
+ * 		several designs at a time on a thread pool (the biggest files first)
+ * - give each design its own context (with the options of the batch) and its own output directory
+ * - produce a table with the size and the time of each design, and the totals of the batch
+ */
+class BatchCompiler{
+
+private:
+	struct design{
+		string file;
+		string name;
+		string outputDir;
+		bool done;
+		double time;	//ms
+		vector< pair<string,double> > stats;
+	};
+	XbarGenContext& context;
+	string outputDir;
+	vector<design> designs;
+	double time;	//ms of the whole batch
+	int workers;
+
+	void compile(design&);
+
+public:
+	BatchCompiler(XbarGenContext& context, string outputDir);
+	bool addInputs(string);
+	int size() const {return designs.size();}
+	int run(int);
+	string statsTable() const;
+	bool printStats();
 };
 
 #endif /* CONTROL_H_ */
@@ -32,77 +32,437 @@
 #include <array>
 #include <map>
 #include <string>
-#include <my_utils.h>
+#include <iostream>
+#include <cstdint>
+#include <lemon/list_graph.h>
 
 using namespace std;
+using namespace lemon;
+
+typedef unsigned int symbol;
+typedef unsigned int literal;
+
+class FileWriter;
+
+/**
+ * A literal is a signal (symbol) together with its polarity, stored in the lowest bit
+ */
+inline literal makeLiteral(symbol s, bool negated = false) {return (s<<1) | (negated? 1 : 0);}
+inline symbol symbolOf(literal l) {return l>>1;}
+inline bool isNegated(literal l) {return (l & 1) != 0;}
+inline literal negateLiteral(literal l) {return l ^ 1;}
+
+/**
+ * This class is expected to intern signal names: each name is mapped to a dense integer id (symbol),
+ * so that the rest of the tool can work on integers and get the names back only when writing files
+ */
+class SymbolTable{
+private:
+	struct slot{
+		unsigned int hash;
+		symbol id;	//symbol+1, 0 means empty
+	};
+	vector<string> names;
+	vector<slot> slots;
+
+	static unsigned int hashOf(const char*, size_t);
+	void grow();
+
+public:
+	SymbolTable(){};
+	symbol intern(const char*, size_t);
+	symbol intern(const string& s) {return intern(s.data(), s.size());}
+	bool lookup(const string&, symbol*) const;
+	const string& name(symbol s) const {return names[s];}
+	string literalName(literal l) const {return (isNegated(l)? "not_" : "") + names[symbolOf(l)];}
+	size_t size() const {return names.size();}
+};
+
+/**
+ * returns the symbol table of the synthesis context of the calling thread (see XbarGenContext)
+ */
+SymbolTable& signalTable();
+
+/**
+ * This class is expected to store a set of cubes (products of literals) in positional notation:
+ * each variable takes two bits, packed 32 variables per 64-bit word, and all the cubes lie one after
+ * another in a single array. The even bit of a variable tells whether the cube admits the value 0, the odd
+ * one whether it admits 1: '11' means the variable isn't in the cube, '10' is the positive literal,
+ * '01' the negative one and '00' both of them (the cube is empty).
+ * Containment, intersection, equality, hashing and literal counting are word operations: they run on
+ * AVX2 or SSE2 kernels when the CPU has them (chosen at run time) and on portable scalar code otherwise.
+ * Coverage checks, complement and the supercube of the uncovered minterms (used by the minimization)
+ * follow the unate recursive paradigm.
+ */
+class CubeSet{
+private:
+	int numVars;
+	int numWords;
+	vector<uint64_t> words;
+
+public:
+	CubeSet(int numVars = 0);
+	int size() const {return words.size()/numWords;}
+	int getNumVars() const {return numVars;}
+	int getNumWords() const {return numWords;}
+	int addCube();
+	int addCube(const uint64_t* w);
+	void removeCube(int c);
+	void addLiteral(int c, int var, bool negated);
+	bool hasLiteral(int c, int var, bool negated) const;
+	const uint64_t* cube(int c) const {return &words[(size_t)c*numWords];}
+	uint64_t* cube(int c) {return &words[(size_t)c*numWords];}
+	int literalCount(int c) const;
+	bool contains(int a, int b) const;
+	bool intersects(int a, int b) const;
+	bool equal(int a, int b) const;
+	bool isEmpty(int c) const;
+	bool covers(const uint64_t* w, int except = -1) const;
+	CubeSet complement() const;
+	bool uncoveredSupercube(const uint64_t* w, uint64_t* super) const;
+	uint64_t hash(int c) const;
+	vector<int> firstOccurrences() const;
+	void getLiterals(int c, vector<int>& positions) const;
+
+	static bool contains(const uint64_t* a, const uint64_t* b, int numWords);
+	static bool intersect(const uint64_t* a, const uint64_t* b, uint64_t* out, int numWords);
+	static bool useKernels(const string& name);
+	static const char* kernelName();
+};
+
+/**
+ * Non-owning view over the minterms of some outputs of a Function: a span (pair of iterators into the
+ * minterms of the Function) for each output, without copying them. Spans are sorted by output, so the
+ * view is walked in the same order as a multimap holding the same minterms.
+ * It's valid as long as the minterms of the viewed Function aren't changed.
+ */
+class MintermView{
+public:
+	typedef multimap<symbol,vector<literal> >::const_iterator span_iterator;
+
+private:
+	vector<pair<span_iterator,span_iterator> > spans;
+	int count;
+
+public:
+	class const_iterator{
+	private:
+		const MintermView* view;
+		size_t span;
+		span_iterator i;
+
+		//moves to the next span when the current one is over (the end is past the last span)
+		void skipEmpty(){
+			while(span < view->spans.size() && i == view->spans[span].second){
+				span++;
+				i = span < view->spans.size()? view->spans[span].first : span_iterator();
+			}
+		}
+
+	public:
+		const_iterator() : view(NULL), span(0){};
+		const_iterator(const MintermView* view, size_t span) : view(view), span(span),
+				i(span < view->spans.size()? view->spans[span].first : span_iterator()) {skipEmpty();};
+		const pair<const symbol,vector<literal> >& operator*() const {return *i;}
+		const pair<const symbol,vector<literal> >* operator->() const {return &*i;}
+		const_iterator& operator++() {++i; skipEmpty(); return *this;}
+		bool operator==(const const_iterator& o) const {return span==o.span && (span==view->spans.size() || i==o.i);}
+		bool operator!=(const const_iterator& o) const {return !(*this==o);}
+	};
+
+	MintermView() : count(0){};
+	MintermView(const multimap<symbol,vector<literal> >& m) : count(m.size()) {if(!m.empty()) spans.push_back(make_pair(m.begin(),m.end()));};
+	void addOutput(const multimap<symbol,vector<literal> >&, symbol);
+	const_iterator begin() const {return const_iterator(this,0);}
+	const_iterator end() const {return const_iterator(this,spans.size());}
+	int size() const {return count;}
+	bool empty() const {return count==0;}
+	bool operator==(const MintermView&) const;
+};
+
+/**
+ * Switching activity of the operative memristors of the crossbar of a two-level function, for an input vector:
+ * a memristor of a cube row switches when its literal is 0 (NAND) and the output memristor of a cube switches
+ * when all the literals of the cube are 1 (AND). The worst (best) case is the input vector which makes
+ * the most (fewest) of them switch: it's exact up to Function::maxExactVariables variables, otherwise it's
+ * the best one found by a local search, within the given errors of the exact one.
+ */
+struct SwitchingActivity{
+	int worst, best;
+	int worstError, bestError;	//0 if exact
+	vector<bool> worstVector, bestVector;	//value of each variable of the function
+	bool exact;
+
+	SwitchingActivity() : worst(0), best(0), worstError(0), bestError(0), exact(true){};
+};
 
 /**
  * This class is the entity model of a boolean function; it contains:
- * - function inputs
+ * - function inputs (literals: each input appears both in positive and negative form)
  * - function outputs
- * - function minterms
+ * - function minterms (for each output, the products of literals): a sub-function doesn't own them,
+ * 		it's a view over the minterms of the function it's taken from (until they're changed by minimize() or setCubes())
+ * - for a two-level (sub-)function, the minterms as a set of cubes over the input variables:
+ * 		it's the store used to deduplicate, count, minimize and map the minterms onto the crossbar
  */
 class Function{
 	friend class Analyzer;
 	friend class Translator;
-	vector<string> inputs;
-	vector<string> outputs;
-	multimap<string,vector<string> > minterms;
-	map<string, int> literalCount;
+	vector<literal> inputs;
+	vector<symbol> outputs;
+	multimap<symbol,vector<literal> > minterms;	//own minterms (empty for a view)
+	MintermView subMinterms;
+	bool isView;
+	map<literal, int> literalCount;
+	vector<symbol> variables;
+	CubeSet cubes;
+	vector<symbol> cubeOutputs;
+
+	void mintermsFromCubes();
 
 public:
-	Function(){};
-	Function(vector<string> inputs,
-				vector<string> outputs,
-				multimap<string,vector<string> > minterms) : inputs(inputs), outputs(outputs), minterms(minterms){};
-	void addInput(string s) {inputs.push_back(s);}
-	void addOutput(string s) {outputs.push_back(s);}
-	void addInputs(vector<string> s);
-	void addOutputs(vector<string> s);
-	void printInput();
-	void printOutput();
-	void printFunction();
-	void addMinterm(string,string);
-	map<string, int> countLiterals();
+	Function() : isView(false){};
+	Function(vector<literal> inputs,
+				vector<symbol> outputs,
+				MintermView minterms) : inputs(move(inputs)), outputs(move(outputs)), subMinterms(move(minterms)), isView(true){};
+	MintermView getMinterms() const {return isView? subMinterms : MintermView(minterms);}
+	MintermView getMinterms(vector<symbol>) const;
+	void addInput(literal l) {inputs.push_back(l);}
+	void addOutput(symbol s) {outputs.push_back(s);}
+	void addInputs(vector<literal> l);
+	void addOutputs(vector<symbol> s);
+	void printInput(ostream& = cout);
+	void printOutput(ostream& = cout);
+	void printFunction(ostream& = cout);
+	void addMinterm(symbol,const vector<literal>&);
+	void buildCubes();
+	void getCubeLiterals(int, vector<literal>&) const;
+	void minimize();
+	void setCubes(CubeSet, vector<symbol>);
+	map<literal, int> countLiterals();
 	int getNumInput();
 	int getNumOutput();
 	int getNumMinterms();
 	int getNumMinterms_NoDuplicate();
-	map<string, int> getLiteralCount();
+	int getNumMemristors();
+	map<literal, int> getLiteralCount();
+	SwitchingActivity switchingActivity(int = 1) const;
+	void evaluate(const uint64_t*, int, uint64_t*) const;
+	symbol getVariable(int v) const {return variables[v];}
+
+	static const int maxExactVariables = 24;
+	bool operator==(const Function&) const;
+	string canonicalForm() const;
 };
 
-typedef vector< vector<int> > crossbarMatrix;
-typedef map< string, map<string, string> > crossbarVoltages;
+/**
+ * This class is expected to store the memristor matrix of a crossbar in compact form:
+ * - one bit per cell (a memristor is there or not), packed in 64-bit words, each row starting on a new word
+ * - a side table for the few cells whose value is greater than 1 (the output memristors, tagged with 2+output)
+ * The memristors are counted through popcount, and the iterator only visits the cells with a memristor
+ * (row by row, in order of column).
+ */
+class CrossbarMatrix{
+private:
+	int height;
+	int width;
+	int rowWords;
+	vector<uint64_t> bits;
+	map<pair<int,int>, int> tags;
+
+public:
+	/**
+	 * a cell with a memristor
+	 */
+	struct cell{
+		int row;
+		int column;
+		int value;
+	};
+
+	class const_iterator{
+		friend class CrossbarMatrix;
+		const CrossbarMatrix* m;
+		size_t word;
+		uint64_t pending;	//bits of the current word still to visit
+		void skipEmpty();
+		const_iterator(const CrossbarMatrix* m, size_t word);
+	public:
+		cell operator*() const;
+		const_iterator& operator++();
+		bool operator==(const const_iterator& i) const {return word==i.word && pending==i.pending;}
+		bool operator!=(const const_iterator& i) const {return !(*this==i);}
+	};
+
+	CrossbarMatrix(int height = 0, int width = 0);
+	int getHeight() const {return height;}
+	int getWidth() const {return width;}
+	void set(int row, int column, int value);
+	int get(int row, int column) const;
+	int count() const;
+	size_t memoryUsage() const;
+	void serialize(string*) const;
+	bool deserialize(const string&, size_t*);
+	const_iterator begin() const {return const_iterator(this, 0);}
+	const_iterator end() const {return const_iterator(this, bits.size());}
+};
+/**
+ * This class is expected to store the voltage of each nanowire of a crossbar, for each stage of the FBLC FSM:
+ * - a dense [stage][wire] table, one byte per entry: the horizontal wires (XbG_H) come first, then the vertical ones (XbG_V)
+ * - stages are in order of execution, which is also the order of their names
+ * - names of stages, wires and voltages are only produced when they're printed
+ */
+class CrossbarVoltages{
+public:
+	enum stage {INA, RI, CFM, EVM, EVR, INR, numStages};
+	enum voltage : uint8_t {zero, Vr, Vw, Z};
+
+private:
+	int height;
+	int width;
+	vector<voltage> table;
+
+public:
+	CrossbarVoltages(int height, int width) : height(height), width(width), table(numStages*(height+width), zero){};
+	void generate(int numInputs, int numOutputs);
+	voltage* horizontal(stage s) {return &table[s*(height+width)];}
+	voltage* vertical(stage s) {return &table[s*(height+width)+height];}
+	voltage getHorizontal(stage s, int row) const {return table[s*(height+width)+row];}
+	voltage getVertical(stage s, int column) const {return table[s*(height+width)+height+column];}
+	void print(ostream& = cout) const;
+	void serialize(string*) const;
+	bool deserialize(const string&, size_t*);
+	static const char* stageName(stage);
+	static const char* voltageName(voltage);
+};
 
 /**
  * This class is the entity model of a FBLC crossbar, which implements a boolean function; it contains:
- * - the memristor crossbar configuration (where are located the memristors)
- * - row index (link between boolean function element (e.g. minterm) and row number in the crossbar)
- * - column index (link between boolean function element (e.g. input) and column number in the crossbar)
+ * - the memristor crossbar configuration (where are located the memristors, stored as a CrossbarMatrix)
+ * - row indexes (link between boolean function element (e.g. minterm, output) and row number in the crossbar;
+ * 		row 0 is always the input latch 'IL', equal minterms share the same row)
+ * - column index (link between boolean function element (e.g. input literal) and column number in the crossbar)
+ * 		and its reverse (the literal of each column), built once with the index
  * - voltages: for each state of the FSM, each nanowire voltage is computed
  */
 class Crossbar{
 	friend class Translator;
+	friend class CrossbarSimulator;
 private:
-	crossbarMatrix matrix;
-	map<string, int> rowIndex;
-	map<string, int> columnIndex;
-	crossbarVoltages voltages;
-	int numMemristors;
-
-	void generateVHDLfiles(int,vector<string>,vector<string>);
-	void generateCrossbarStructureFile(int);
-	void generateCrossbarControllerFile(int,vector<string>,vector<string>);
-	void generateCrossbarFile(int ,int);
-	string voltageFilter(string,string);
+	CrossbarMatrix matrix;
+	vector<int> rowIndex;	//row of each cube of the sub-function
+	map<symbol, int> outputRowIndex;
+	map<literal, int> columnIndex;
+	vector<literal> columnLiterals;	//literal of each column
+	CrossbarVoltages voltages;
+
+	static const int inputLatchRow = 0;
+
+	void generateVHDLfiles(const string&,int,vector<literal>,vector<symbol>,bool,bool);
+	void generateCrossbarStructureFile(const string&,int,bool);
+	void generateCrossbarControllerFile(const string&,int,vector<literal>,vector<symbol>,bool);
+	void generateCrossbarFile(const string&,int ,int,bool,bool);
+	void voltageFilter(FileWriter&,CrossbarVoltages::stage,bool,int);
 
 public:
 	Crossbar(int numInput, int numOutput, int numMinterms);
 	~Crossbar();
-	void printMatrix();
-	void printVoltages();
-	unsigned int getHeight() {return matrix.size();}
-	unsigned int getWidth() {return matrix[0].size();}
+	void printMatrix(ostream& = cout);
+	void printVoltages(ostream& = cout);
+	unsigned int getHeight() {return matrix.getHeight();}
+	unsigned int getWidth() {return matrix.getWidth();}
+	Function readFunction() const;
+};
+
+/**
+ * This class is expected to simulate a crossbar through the stages of the FBLC FSM, as the VHDL model of the
+ * memristor (memristorModel/) would do, 64 input vectors per word:
+ * - each wire holds, for each vector, one of the voltages of memristor_lib/types.vhd (one bit-mask per voltage),
+ * 		a floating wire (Z) keeps the last voltage it had, and it's driven by the memristors in state 'zero'
+ * 		which see a voltage other than 0 across them
+ * - a memristor switches to 'zero' above Vth and back to 'one' below -Vth
+ * - in the RI stage, the input columns are driven by the controller (Vw_neg if their literal is 1, Vw otherwise)
+ * The outputs are the states of the output memristors after the last stage, so nothing is assumed about
+ * what the voltages compute.
+ */
+class CrossbarSimulator{
+private:
+	struct memristor{
+		int row;
+		int column;	//wire of the column (after the rows)
+	};
+	int height;
+	int width;
+	vector<memristor> memristors;
+	vector<int> outputMemristors;	//memristor of each output (in order of output)
+	vector<literal> columnLiterals;
+	CrossbarVoltages voltages;
+
+public:
+	CrossbarSimulator(const Crossbar&);
+	int getNumOutputs() const {return outputMemristors.size();}
+	void run(const uint64_t*, int, uint64_t*) const;
+};
+
+/**
+ * This class is expected to:
+ * - hold the dependency graph of a boolean function: a node for each signal, an arc from each term
+ * 	to each signal it depends on
+ * - keep, in sync with addNode() and erase(), the name of each node and the node of each name
+ * 	(a vector indexed by symbol), so that a node is found by its name in constant time
+ */
+class DependencyGraph : public ListDigraph{
+private:
+	ListDigraph::NodeMap<symbol> names;
+	vector<ListDigraph::Node> nodes;	//node of each symbol, INVALID if the signal isn't in the graph
+
+public:
+	DependencyGraph() : names(*this){};
+	ListDigraph::Node addNode(symbol);
+	void erase(ListDigraph::Node);
+	void erase(ListDigraph::Arc a) {ListDigraph::erase(a);}
+	void clear();
+	ListDigraph::Node node(symbol s) const {return s<nodes.size()? nodes[s] : ListDigraph::Node(INVALID);}
+	symbol name(ListDigraph::Node n) const {return names[n];}
+	const ListDigraph::NodeMap<symbol>& getNames() const {return names;}
+};
+
+/**
+ * This class is expected to:
+ * - hold an immutable copy of a DependencyGraph, once it's built, in compressed sparse row form:
+ * 	nodes are the integers 0..numNodes()-1 and the arcs leaving (entering) a node are a contiguous
+ * 	slice of a single array, so visits walk memory linearly and an arc takes two integers
+ * - keep the order of the nodes and of the arcs leaving each node of the list graph,
+ * 	so the visits on the copy meet them in the same order as before
+ */
+class FrozenGraph{
+private:
+	vector<symbol> names;	//name of each node
+	vector<int> nodes;	//node of each symbol, -1 if the signal isn't in the graph
+	vector<int> outBegin, targets;	//targets[outBegin[v]..outBegin[v+1]) are the nodes 'v' depends on
+	vector<int> inBegin, sources;	//sources[inBegin[v]..inBegin[v+1]) are the nodes depending on 'v'
+
+public:
+	/**
+	 * contiguous slice of adjacent nodes, to be walked with a range for
+	 */
+	struct adjacency{
+		const int* first;
+		const int* last;
+		adjacency(const int* first, const int* last) : first(first), last(last){};
+		const int* begin() const {return first;}
+		const int* end() const {return last;}
+		int size() const {return last-first;}
+	};
+
+	void build(const DependencyGraph&);
+	void clear();
+	int numNodes() const {return names.size();}
+	int numArcs() const {return targets.size();}
+	int node(symbol s) const {return s<nodes.size()? nodes[s] : -1;}
+	symbol name(int v) const {return names[v];}
+	adjacency outNodes(int v) const {return adjacency(targets.data()+outBegin[v], targets.data()+outBegin[v+1]);}
+	adjacency inNodes(int v) const {return adjacency(sources.data()+inBegin[v], sources.data()+inBegin[v+1]);}
 };
 
 #endif /* ENTITIES_H_ */
@@ -36,6 +36,7 @@
 #include <unistd.h>
 #include <lemon/list_graph.h>
 #include <lemon/bits/graph_extender.h>
+#include "entities.h"
 using namespace std;
 using namespace lemon;
 
@@ -49,13 +50,18 @@ vector<string> tokenize(string,const char*);
 
 void replace_substring(string*, const string, const string);
 
-ListDigraph::NodeIt getVertexByName(ListDigraph*,ListDigraph::NodeMap<string>*, string);
+ListDigraph::Node getVertexByName(const DependencyGraph*, symbol);
 
-void generateDOTfromGraph(int,ListDigraph*,ListDigraph::NodeMap<string>*);
+void generateDOTfromGraph(const string&,int,const FrozenGraph*);
+
+vector<int> decimalOrder(int);
+
+void appendBytes(string*, const void*, size_t);
+
+bool readBytes(const string&, size_t*, void*, size_t);
 
 string VHDLsintaxFilter(string);
 
-bool loadVHDLReservedWords();
 
 
 #endif /* UTILS_H_ */
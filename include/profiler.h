@@ -0,0 +1,115 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * profiler.h
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * a timed phase of the execution, either of the whole circuit or of one of its levels
+ */
+struct phaseRecord{
+	string name;
+	int level;						//-1 for the phases of the whole circuit
+	int thread;						//0 is the thread which enabled the profiler
+	double start;					//ms since the profiler was enabled
+	double duration;				//ms
+	uint64_t allocations;			//made by the thread of the phase
+	uint64_t processAllocations;	//made by all the threads while the phase was running
+	long rss;						//resident memory at the end of the phase (kB)
+	long peakRss;					//peak resident memory at the end of the phase (kB)
+};
+
+/**
+ * This class is expected to:
+ * - collect the phases timed by PhaseTimer objects, from any thread
+ * - count the memory allocations (of each thread and of the whole process) once it's enabled
+ * - sample the resident memory of the process (current and peak)
+ * - write the phases as a JSON report and as Chrome trace events (chrome://tracing, Perfetto)
+ * While it's not enabled, timers do nothing and allocations aren't counted.
+ * Each XbarGenContext has its own profiler, so concurrent compilations don't mix their phases.
+ * Allocations are counted only by the programs which link allocation_counter.cpp
+ * (XbarGen and the benchmarks): the library doesn't replace operator new.
+ */
+class Profiler{
+
+private:
+	bool enabled;
+	chrono::steady_clock::time_point start;
+	mutex lock;
+	vector<phaseRecord> phases;
+	map<thread::id, int> threads;
+
+public:
+	Profiler() : enabled(false){};
+	void enable();
+	bool isEnabled() const {return enabled;}
+	double elapsed() const;
+	void record(phaseRecord&);
+	vector<phaseRecord> takePhases();
+	bool writeReport(string, string, const vector< pair<string, double> >&);
+	bool writeTrace(string);
+	static void countAllocation();
+	static uint64_t threadAllocations();
+	static uint64_t processAllocations();
+	static long residentMemory();
+	static long peakResidentMemory();
+	static bool resetPeakResidentMemory();
+};
+
+/**
+ * Times the scope it's declared in as the phase 'name' (of the level 'level', if it's given)
+ * and records it, with the allocations made and the memory used, in the profiler of the current context
+ */
+class PhaseTimer{
+
+private:
+	Profiler& profiler;
+	const char* name;
+	int level;
+	bool active;
+	double start;
+	uint64_t allocations;
+	uint64_t processAllocations;
+
+public:
+	PhaseTimer(const char* name, int level = -1);
+	PhaseTimer(const PhaseTimer&) = delete;
+	PhaseTimer& operator=(const PhaseTimer&) = delete;
+	~PhaseTimer();
+};
+
+#endif /* PROFILER_H_ */
@@ -0,0 +1,111 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * sat_solver.h
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#ifndef SAT_SOLVER_H_
+#define SAT_SOLVER_H_
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * This class is expected to decide whether a formula in conjunctive normal form can be satisfied (CDCL):
+ * - variables are 0..numVars()-1, a literal is var<<1 with the lowest bit set if it's negated
+ * 	(as the literals of the signals, see entities.h)
+ * - clauses are watched by two of their literals; a conflict is analyzed up to its first unique
+ * 	implication point, and the clause learned from it is minimized and added to the formula
+ * - decisions follow the activity of the variables (VSIDS) with the last value they had (phase saving),
+ * 	with restarts after a Luby sequence of conflicts, when the least active learned clauses are dropped
+ * - a budget of conflicts can be set: the formula is left undecided when it's exceeded
+ * An object is used by one thread at a time; different objects share nothing.
+ */
+class SatSolver{
+
+public:
+	enum result {satisfiable, unsatisfiable, undecided};
+	typedef uint32_t lit;
+
+	static lit makeLit(int var, bool negated = false) {return ((lit)var<<1) | (negated? 1 : 0);}
+
+private:
+	struct clause{
+		int start;	//first literal in 'literals': the first two are the watched ones
+		int size;
+		bool learned;
+		float activity;
+	};
+	struct watcher{
+		int clause;
+		lit blocker;	//a literal of the clause: if it's true the clause isn't visited
+	};
+
+	vector<lit> literals;
+	vector<clause> clauses;
+	int numLearned;
+	vector< vector<watcher> > watches;	//clauses watching each literal
+	vector<int8_t> assigns;	//value of each variable: 0, 1, or -1 if it's unassigned
+	vector<int8_t> phase;	//last value of each variable
+	vector<int> levels;
+	vector<int> reasons;	//clause which implied each variable (-1 for a decision)
+	vector<lit> trail;
+	vector<int> trailLimits;	//start of each decision level in the trail
+	size_t propagated;
+	vector<double> activity;
+	double activityStep;
+	float clauseStep;
+	vector<int> heap;	//unassigned variables (at least), by activity
+	vector<int> heapIndex;	//position of each variable in the heap (-1 if it isn't there)
+	vector<char> seen;
+	vector<lit> analyzed;	//literals of the last clause learned, before it was minimized
+	vector<bool> model;
+	bool consistent;	//false once the formula is found unsatisfiable
+
+	int valueOf(lit l) const {int a = assigns[l>>1]; return a<0? -1 : a^(int)(l&1);}
+	int decisionLevel() const {return trailLimits.size();}
+	void assign(lit, int);
+	void watch(int);
+	int propagate();
+	void analyze(int, vector<lit>&, int*);
+	void backtrack(int);
+	void bumpVariable(int);
+	void bumpClause(clause&);
+	void heapUp(int);
+	void heapDown(int);
+	void heapInsert(int);
+	int heapPop();
+	void reduceLearned();
+
+public:
+	SatSolver();
+	int newVar();
+	int numVars() const {return assigns.size();}
+	bool addClause(vector<lit>);
+	result solve(long = -1);
+	bool value(int var) const {return model[var];}
+};
+
+#endif /* SAT_SOLVER_H_ */
@@ -0,0 +1,78 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * thread_pool.h
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * This class is expected to:
+ * - run independent tasks on a fixed number of worker threads
+ * - balance the load through work stealing: each worker has its own queue (submitted tasks are
+ * 	dealt round robin); a worker takes tasks from the front of its queue and, when the queue is empty,
+ * 	steals them from the back of the other workers' queues
+ * - let the caller wait until all the submitted tasks are done
+ */
+class ThreadPool{
+
+private:
+	struct workQueue{
+		mutex lock;
+		deque< function<void()> > tasks;
+	};
+
+	vector<thread> threads;
+	vector<workQueue*> queues;
+	size_t nextQueue;
+
+	mutex stateLock;
+	condition_variable wakeUp;
+	condition_variable allDone;
+	atomic<int> queued;
+	int unfinished;
+	bool stopping;
+
+	bool take(size_t, function<void()>&);
+	void work(size_t);
+
+public:
+	ThreadPool(int numThreads);
+	void submit(function<void()>);
+	void wait();
+	static int hardwareThreads();
+	~ThreadPool();
+};
+
+#endif /* THREAD_POOL_H_ */
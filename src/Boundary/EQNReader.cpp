@@ -0,0 +1,207 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * EQNReader.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "boundary.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char* const inputLabel = "INORDER";
+static const char* const outputLabel = "OUTORDER";
+
+/**
+ * returns the view of [first,last) without leading and trailing blanks
+ */
+static stringView trimView(const char* first, const char* last){
+	while(first<last && *first==' ')
+		first++;
+	while(last>first && *(last-1)==' ')
+		last--;
+	return stringView(first, last-first);
+}
+
+/**
+ * returns the next token of 'v' starting at 'pos', where tokens are separated by any of the characters in 'delim'.
+ * 'pos' is moved after the token; an empty view is returned when there are no more tokens
+ */
+static stringView nextToken(stringView v, size_t* pos, const char* delim){
+	while(*pos<v.length && strchr(delim,v.data[*pos])!=NULL)
+		(*pos)++;
+	size_t first = *pos;
+	while(*pos<v.length && strchr(delim,v.data[*pos])==NULL)
+		(*pos)++;
+	return stringView(v.data+first, *pos-first);
+}
+
+/**
+ * maps the whole file in memory (read only)
+ */
+bool EQNReader::mapFile(){
+	int fd = open(this->file.c_str(), O_RDONLY);
+	if(fd<0)
+		return false;
+	struct stat st;
+	if(fstat(fd,&st)!=0 || !S_ISREG(st.st_mode)){
+		close(fd);
+		return false;
+	}
+	this->size = st.st_size;
+	if(this->size>0){
+		void* p = mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(p==MAP_FAILED){
+			close(fd);
+			this->size = 0;
+			return false;
+		}
+		//the file is scanned once, from the beginning to the end
+		madvise(p, this->size, MADV_SEQUENTIAL);
+		this->buffer = (const char*)p;
+	}
+	//the mapping stays valid after closing the descriptor
+	close(fd);
+	return true;
+}
+
+void EQNReader::unmapFile(){
+	if(this->buffer!=NULL)
+		munmap((void*)this->buffer, this->size);
+	this->buffer = NULL;
+	this->size = 0;
+}
+
+/**
+ * Scans the file line by line, extracting the statements (terminated by ';').
+ * A statement on a single line is parsed directly within the mapped buffer;
+ * only statements split over more lines are joined in a (reused) scratch buffer.
+ */
+bool EQNReader::read(Function& func){
+	if(!mapFile())
+		return false;
+
+	const char* p = this->buffer;
+	const char* end = this->buffer + this->size;
+	bool pending = false;
+	while(p<end){
+		const char* eol = (const char*)memchr(p, '\n', end-p);
+		if(eol==NULL)
+			eol = end;
+		stringView line(p, eol-p);
+		p = eol+1;
+
+		//skip the line if it's a comment
+		if(line.length>0 && line.data[0]=='#')
+			continue;
+
+		const char* semicolon = NULL;
+		for(const char* c = eol; c>line.data; c--){
+			if(*(c-1)==';'){
+				semicolon = c-1;
+				break;
+			}
+		}
+
+		if(semicolon!=NULL){
+			//the line completes a statement (everything after the last ';' is dropped)
+			if(pending){
+				this->scratch.append(line.data, semicolon-line.data);
+				parseStatement(stringView(this->scratch.data(), this->scratch.size()), func);
+				this->scratch.clear();
+				pending = false;
+			}
+			else
+				parseStatement(stringView(line.data, semicolon-line.data), func);
+		}
+		else if(line.length>0){
+			//the statement continues on the next line: delete carriage return
+			size_t length = line.length;
+			if(line.data[length-1]=='\r')
+				length--;
+			this->scratch.append(line.data, length);
+			pending = true;
+		}
+	}
+	unmapFile();
+	return true;
+}
+
+/**
+ * Parses a statement (without ';'): it can be the list of inputs, the list of outputs
+ * or the sum of minterms of a signal
+ */
+void EQNReader::parseStatement(stringView statement, Function& func){
+	//divide left and right expressions
+	const char* equal = (const char*)memchr(statement.data, '=', statement.length);
+	const char* last = statement.data + statement.length;
+	stringView left = trimView(statement.data, equal!=NULL? equal : last);
+	stringView right = trimView(equal!=NULL? equal+1 : statement.data, last);
+
+	size_t pos = 0;
+	stringView tok;
+	if(left==inputLabel){
+		//parsing inputs (positive form first, then negative form)
+		while(!(tok = nextToken(right, &pos, " ")).empty())
+			func.addInput(makeLiteral(signalTable().intern(tok.data, tok.length)));
+		pos = 0;
+		while(!(tok = nextToken(right, &pos, " ")).empty())
+			func.addInput(makeLiteral(signalTable().intern(tok.data, tok.length), true));
+	}
+	else if(left==outputLabel){
+		//parsing outputs
+		while(!(tok = nextToken(right, &pos, " ")).empty())
+			func.addOutput(signalTable().intern(tok.data, tok.length));
+	}
+	else{
+		//parsing minterms
+		symbol out = signalTable().intern(left.data, left.length);
+		while(!(tok = nextToken(right, &pos, "+")).empty())
+			parseMinterm(out, tok, func);
+	}
+}
+
+/**
+ * Parses a single minterm (e.g. "a*!b * c") of the signal 'out'.
+ * Each leading '!' of a literal flips its polarity.
+ */
+void EQNReader::parseMinterm(symbol out, stringView minterm, Function& func){
+	this->literals.clear();
+	size_t pos = 0;
+	stringView tok;
+	while(!(tok = nextToken(minterm, &pos, " *")).empty()){
+		bool negated = false;
+		while(tok.length>0 && tok.data[0]=='!'){
+			negated = !negated;
+			tok.data++;
+			tok.length--;
+		}
+		if(tok.length>0)
+			this->literals.push_back(makeLiteral(signalTable().intern(tok.data, tok.length), negated));
+	}
+	if(!this->literals.empty())
+		func.addMinterm(out, this->literals);
+}
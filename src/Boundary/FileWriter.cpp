@@ -0,0 +1,179 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * FileWriter.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "boundary.h"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+
+static const size_t initialBufferSize = 1<<20;
+static const size_t maxPooledBuffers = 4;
+
+/**
+ * buffers of the writers of a thread: a buffer keeps its capacity when it goes back to the pool,
+ * so the following files don't grow it again
+ */
+struct bufferPool{
+	vector<string*> buffers;
+
+	string* take(){
+		if(buffers.empty()){
+			string* b = new string();
+			b->reserve(initialBufferSize);
+			return b;
+		}
+		string* b = buffers.back();
+		buffers.pop_back();
+		return b;
+	}
+
+	void give(string* b){
+		b->clear();
+		if(buffers.size()<maxPooledBuffers)
+			buffers.push_back(b);
+		else
+			delete b;
+	}
+
+	~bufferPool(){
+		for(size_t i=0; i<buffers.size(); i++)
+			delete buffers[i];
+	}
+};
+
+static thread_local bufferPool pool;
+
+/**
+ * Constructor: nothing is written (and the file isn't even opened) until close()
+ */
+FileWriter::FileWriter(string file) : file(file){
+	this->buffer = pool.take();
+}
+
+FileWriter& FileWriter::operator<<(const char* s){
+	this->buffer->append(s);
+	return *this;
+}
+
+FileWriter& FileWriter::operator<<(const string& s){
+	this->buffer->append(s);
+	return *this;
+}
+
+FileWriter& FileWriter::operator<<(char c){
+	this->buffer->push_back(c);
+	return *this;
+}
+
+/**
+ * appends the decimal digits of 'value' (preceded by '-' if 'negative')
+ */
+void FileWriter::appendInteger(unsigned long long value, bool negative){
+	char digits[24];
+	char* p = digits+sizeof(digits);
+	do{
+		*--p = '0' + value%10;
+		value /= 10;
+	}while(value!=0);
+	if(negative)
+		*--p = '-';
+	this->buffer->append(p, digits+sizeof(digits)-p);
+}
+
+FileWriter& FileWriter::operator<<(int n){
+	return *this<<(long long)n;
+}
+
+FileWriter& FileWriter::operator<<(long n){
+	return *this<<(long long)n;
+}
+
+FileWriter& FileWriter::operator<<(long long n){
+	//the magnitude is computed unsigned, so that the smallest value doesn't overflow
+	appendInteger(n<0? 0ULL-(unsigned long long)n : (unsigned long long)n, n<0);
+	return *this;
+}
+
+FileWriter& FileWriter::operator<<(unsigned int n){
+	appendInteger(n, false);
+	return *this;
+}
+
+FileWriter& FileWriter::operator<<(unsigned long n){
+	appendInteger(n, false);
+	return *this;
+}
+
+FileWriter& FileWriter::operator<<(unsigned long long n){
+	appendInteger(n, false);
+	return *this;
+}
+
+/**
+ * doubles are written as iostreams do by default (6 significant digits)
+ */
+FileWriter& FileWriter::operator<<(double d){
+	char digits[32];
+	int n = snprintf(digits, sizeof(digits), "%g", d);
+	this->buffer->append(digits, n);
+	return *this;
+}
+
+/**
+ * Writes the collected text to the file, which is created (or truncated), and gives the buffer back.
+ * It's called by the destructor too: the following calls do nothing.
+ */
+bool FileWriter::close(){
+	if(this->buffer==NULL)
+		return true;
+	bool ok = false;
+	int fd = open(this->file.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0666);
+	if(fd>=0){
+		const char* data = this->buffer->data();
+		size_t left = this->buffer->size();
+		//a single write, unless the system splits it
+		while(left>0){
+			ssize_t n = write(fd, data, left);
+			if(n<0 && errno==EINTR)
+				continue;
+			if(n<=0)
+				break;
+			data += n;
+			left -= n;
+		}
+		ok = (left==0);
+		ok = (::close(fd)==0) && ok;
+	}
+	if(!ok)
+		cout<<"ERROR: cannot write file "+this->file+"\n";
+	pool.give(this->buffer);
+	this->buffer = NULL;
+	return ok;
+}
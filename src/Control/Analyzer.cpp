@@ -27,29 +27,36 @@
 
 #include <fstream>
 #include "control.h"
+#include "boundary.h"
 #include "my_utils.h"
+#include "thread_pool.h"
+#include "profiler.h"
 #include <iostream>
 #include <chrono>
 #include <sys/stat.h>
+#include <algorithm>
 
 using namespace std;
-extern chrono::high_resolution_clock::time_point startTime;
 
 /**
 *constructor with parameters
 */
-Analyzer::Analyzer(int level, vector<string> inputs,vector<string> outputs,multimap<string,vector<string> > minterms) :  graph(), nodeNames(graph),func(inputs,outputs,minterms), level(level){
-	if(execParameters.verbose){
-		cout<<"***FUNCTION PARAMETERS***"<<endl<<endl;
-		cout<<"input: ";
-		func.printInput();
-		cout<<endl;
-		cout<<"output: ";
-		func.printOutput();
-		cout<<endl;
-		func.printFunction();
-		cout<<endl;
-		cout<<endl<<"***END FUNCTION PARAMETERS***"<<endl<<endl;
+Analyzer::Analyzer(int level, vector<literal> inputs,vector<symbol> outputs,MintermView minterms) :  graph(),
+		simulatedVectors(0), simulationMismatches(0), simulationExhaustive(false),
+		verification(EquivalenceChecker::undecided), verificationExhaustive(false), verificationVectors(0), verificationMiters(0),
+		context(&currentContext()), func(move(inputs),move(outputs),move(minterms)), level(level),
+		crossbarFromCache(false), filesFromCache(false), sharedEntity(NULL){
+	if(this->context->options.verbose){
+		verboseLog<<"***FUNCTION PARAMETERS***"<<endl<<endl;
+		verboseLog<<"input: ";
+		func.printInput(verboseLog);
+		verboseLog<<endl;
+		verboseLog<<"output: ";
+		func.printOutput(verboseLog);
+		verboseLog<<endl;
+		func.printFunction(verboseLog);
+		verboseLog<<endl;
+		verboseLog<<endl<<"***END FUNCTION PARAMETERS***"<<endl<<endl;
 	}
 }
 
@@ -92,74 +99,19 @@ Analyzer::Analyzer(int level, vector<string> inputs,vector<string> outputs,multi
 //}
 
 /**
-*Starting from file in .eqn format, extract the boolean function
+*Starting from file in .eqn format, extract the boolean function.
+*Returns false if the file can't be read.
 */
-void Analyzer::analyzeFunctionFromEQN(){
-	const string inputLabel = "INORDER";
-	const string outputLabel = "OUTORDER";
-	string line;
-	ifstream myfile(this->file);
-	if (myfile.is_open())
-	{
-		string expression;
-		while ( getline (myfile,line) )
-		{
-			//skip the line if it's a comment
-			if(line.length()>0 && line.at(0)=='#')
-				continue;
-
-			expression+=line;
-			if(expression.find(";")!= std::string::npos){
-				//'expression' contains a whole line
-
-				//delete ';'
-				expression = expression.substr(0,expression.find_last_of(';'));
-
-				//divide left and right expressions
-				int equal = expression.find_first_of ('=');
-				string leftExpression = trim(expression.substr(0, equal));
-				string rightExpression = trim(expression.substr(equal+1));
-
-				if(leftExpression==inputLabel){
-					//parsing inputs
-					vector<string> inputs = tokenize(rightExpression," ");
-					func.addInputs(inputs);
-					for(vector<string>::const_iterator i = inputs.begin(); i!= inputs.end();i++){
-						func.addInput("not_"+*i);
-					}
-				}
-				else if(leftExpression==outputLabel){
-					//parsing outputs
-					func.addOutputs(tokenize(rightExpression," "));
-				}
-				else{
-					//parsing minterms
-					vector<string> minterms = tokenize(rightExpression,"+");
-					for(vector<string>::iterator i = minterms.begin(); i!=minterms.end();i++){
-						replace_substring(&*i, string("!"),string("not_"));
-						replace_substring(&*i, string("*"),string(" "));
-						trim(&*i);
-						func.addMinterm(leftExpression,*i);
-					}
-
-				}
-				//cout<<leftValue<<" = "<<rightExpression<<';'<<endl;
-				expression.clear();
-			}
-			else if(*(expression.end()-1) == '\n' || *(expression.end()-1) == '\r'){
-				//'expression' doesn't contain whole line
-				//delete carriage return
-				expression = expression.substr(0,expression.find_last_of('\n'));
-				expression = expression.substr(0,expression.find_last_of('\r'));
-				continue;
-			}
-		}
-		myfile.close();
+bool Analyzer::analyzeFunctionFromEQN(){
+	PhaseTimer timer("Analyzer::analyzeFunctionFromEQN");
+	//the reader maps the file in memory and scans it in one pass
+	EQNReader reader(this->file);
+	if(!reader.read(this->func)){
+		cout << "Unable to open file "<<this->file<<endl;
+		return false;
 	}
 
-	else cout << "Unable to open file";
-
-	if(execParameters.verbose){
+	if(this->context->options.verbose){
 		cout<<"***FUNCTION PARAMETERS***"<<endl<<endl;
 		cout<<"input: ";
 		this->func.printInput();
@@ -171,38 +123,34 @@ void Analyzer::analyzeFunctionFromEQN(){
 		cout<<endl;
 		cout<<endl<<"***END FUNCTION PARAMETERS***"<<endl<<endl;
 	}
+	return true;
 }
 
 /**
 * Generate the Graph of dependencies for the given input function.
+* Returns false if the function has a combinational cycle.
 */
-void Analyzer::createDependenciesGraph(int level){
-	//initialize levels of nodes at 0
-	ListDigraph::NodeMap<int> levels(graph,0);
-
+bool Analyzer::createDependenciesGraph(int level){
+	PhaseTimer timer("Analyzer::createDependenciesGraph", this->level);
 	//starting from outputs build the dependency tree
-	for(vector<string>::const_iterator i = func.outputs.begin(); i != func.outputs.end(); i++){
-		verify_dependencies(*i);
-	}
+	build_dependencies();
+
+	//initialize levels of nodes at 0
+	vector<int> levels(graph.numNodes(),0);
 
 	//starting from inputs (which have level 0) build subsets of the boolean function
-	for(vector<string>::const_iterator i = func.inputs.begin(); i != func.inputs.end(); i++){
-		if((*i).find("not_") == std::string::npos){
-			ListDigraph::NodeIt n = getVertexByName(&graph,&nodeNames,*i);
-			if(n!=INVALID)
-				build_levels(n,&levels,0);
-		}
-	}
+	if(!build_levels(&levels))
+		return false;
 
 	//build a map that, for each subset, has the corresponding terms of the function
-	for (ListDigraph::NodeIt v(graph); v != INVALID; ++v){
+	for (int v = 0; v < graph.numNodes(); v++){
 		nodeLevels[levels[v]].push_back(v);
 	}
 
 	//generate dot file, if demanded
-	if(execParameters.dot){
-		generateDOTfromGraph(this->level,&graph,&nodeNames);
-		if(execParameters.verbose){
+	if(this->context->options.dot){
+		generateDOTfromGraph(this->outputDir,this->level,&graph);
+		if(this->context->options.verbose){
 
 			cout<<"***DOT GENERATION***"<<endl<<endl;
 			cout<<"DOT file Generated";
@@ -211,58 +159,154 @@ void Analyzer::createDependenciesGraph(int level){
 		}
 	}
 
-	if(execParameters.verbose){
+	if(this->context->options.verbose){
 		cout<<"***LEVELS***"<<endl<<endl;
-		for(map <int, vector<ListDigraph::NodeIt> >::const_iterator i = nodeLevels.begin(); i != nodeLevels.end(); i++ ){
+		for(map <int, vector<int> >::const_iterator i = nodeLevels.begin(); i != nodeLevels.end(); i++ ){
 			cout<<"level "<<i->first<<"->";
-			for(vector<ListDigraph::NodeIt>::const_iterator j = i->second.begin(); j != i->second.end(); j++ )
-				cout<<nodeNames[*j]<<" ";
+			for(vector<int>::const_iterator j = i->second.begin(); j != i->second.end(); j++ )
+				cout<<signalTable().name(graph.name(*j))<<" ";
 			cout<<endl;
 		}
 		cout<<endl<<"***END LEVELS***"<<endl<<endl;
 	}
+	return true;
 }
 
 /**
-* Recursive function for verifying dependencies between function terms
+* Builds the graph of dependencies between function terms, starting from the outputs.
+* It's an iterative depth-first visit (so deep netlists can't overflow the stack): nodes are
+* retrieved through a symbol-indexed table, the minterms of each node are scanned once
+* and duplicate arcs are filtered against the targets already linked to the node.
+* Nodes and arcs are added in the same order as a recursive visit would do.
+* Then the graph doesn't change anymore: it's frozen in a compact form for the later visits.
 */
-ListDigraph::NodeIt Analyzer::verify_dependencies(string s){
-	ListDigraph::NodeIt nodeIt = getVertexByName(&graph,&nodeNames,s);
-	if(nodeIt == INVALID){
-		nodeNames[graph.addNode()] = s;
-		nodeIt = getVertexByName(&graph,&nodeNames,s);
-	}
-	for(multimap<string,vector<string> >::const_iterator i = func.minterms.begin(); i != func.minterms.end(); ++i){
-		//if vertex has dependencies
-		if(i->first==s){
-			for(vector<string>::const_iterator j = i->second.begin() ; j != i->second.end(); ++j){
-				string name = *j;
-				replace_substring(&name,"not_","");
-				ListDigraph::NodeIt targetNode = verify_dependencies(name);
-				bool already_there = false;
-				for (ListDigraph::OutArcIt a(graph, nodeIt); a!=INVALID; ++a){
-					if(graph.target(a) == targetNode){
-						already_there = true;
-						break;
-					}
-				}
-				if(!already_there)
-					graph.addArc(nodeIt,targetNode);
+void Analyzer::build_dependencies(){
+	PhaseTimer timer("Analyzer::build_dependencies", this->level);
+	typedef MintermView::const_iterator mmit;
+	struct frame{
+		ListDigraph::Node node;
+		mmit minterm, last;
+		size_t lit;
+		vector<symbol> targets;
+	};
+
+	//minterms are sorted by signal: one pass gives the range of every signal
+	MintermView minterms = func.getMinterms();
+	vector<pair<mmit,mmit> > mintermsOf(signalTable().size(), make_pair(minterms.end(),minterms.end()));
+	for(mmit m = minterms.begin(); m != minterms.end(); ){
+		mmit first = m;
+		while(m != minterms.end() && m->first == first->first)
+			++m;
+		mintermsOf[first->first] = make_pair(first,m);
+	}
+
+	DependencyGraph dependencies;
+	vector<frame> stack;
+
+	for(vector<symbol>::const_iterator i = func.outputs.begin(); i != func.outputs.end(); i++){
+		if(dependencies.node(*i) != INVALID)
+			continue;
+		stack.push_back(frame());
+		stack.back().node = dependencies.addNode(*i);
+		stack.back().minterm = mintermsOf[*i].first;
+		stack.back().last = mintermsOf[*i].second;
+		stack.back().lit = 0;
+
+		while(!stack.empty()){
+			frame& f = stack.back();
+			//all the minterms of the node are done
+			if(f.minterm == f.last){
+				stack.pop_back();
+				continue;
+			}
+			if(f.lit == f.minterm->second.size()){
+				++f.minterm;
+				f.lit = 0;
+				continue;
+			}
+			symbol target = symbolOf(f.minterm->second[f.lit]);
+			//first time the literal is met: visit its own dependencies before adding the arc
+			ListDigraph::Node targetNode = dependencies.node(target);
+			if(targetNode == INVALID){
+				stack.push_back(frame());
+				stack.back().node = dependencies.addNode(target);
+				stack.back().minterm = mintermsOf[target].first;
+				stack.back().last = mintermsOf[target].second;
+				stack.back().lit = 0;
+				continue;
+			}
+			//a node depends on few signals: a linear search is cheaper than a hash set
+			if(find(f.targets.begin(), f.targets.end(), target) == f.targets.end()){
+				f.targets.push_back(target);
+				dependencies.addArc(f.node,targetNode);
 			}
+			f.lit++;
 		}
 	}
-	return nodeIt;
+	this->graph.build(dependencies);
 }
 
 /**
- *	Recursive function for register the right subset for each term of the function
+ *	Registers the right subset for each term of the function: the level of a term is the length of
+ *	the longest path from it to a primary input (terms not depending on any input stay at level 0).
+ *	Terms are visited in topological order (Kahn), from the ones without dependencies up to the outputs,
+ *	so each arc is walked exactly once. Returns false if the terms are in a combinational cycle.
  * */
-void Analyzer::build_levels(ListDigraph::Node u,ListDigraph::NodeMap<int>* levels,int lev){
-	(*levels)[u] = max((*levels)[u],lev);
-	int parentLev = lev+1;
-	for (ListDigraph::InArcIt a(graph, u); a!=INVALID; ++a){
-		build_levels(graph.source(a),levels,parentLev);
+bool Analyzer::build_levels(vector<int>* levels){
+	PhaseTimer timer("Analyzer::build_levels", this->level);
+	vector<bool> primary(signalTable().size(), false);
+	for(vector<literal>::const_iterator i = func.inputs.begin(); i != func.inputs.end(); i++)
+		primary[symbolOf(*i)] = true;
+
+	//a term is ready when all of its dependencies have their final level
+	vector<int> pending(graph.numNodes());
+	vector<bool> reachesInput(graph.numNodes(),false);
+	vector<int> ready;
+	for (int v = 0; v < graph.numNodes(); v++){
+		pending[v] = graph.outNodes(v).size();
+		if(pending[v]==0)
+			ready.push_back(v);
 	}
+
+	int visited = 0;
+	while(!ready.empty()){
+		int v = ready.back();
+		ready.pop_back();
+		visited++;
+		if(primary[graph.name(v)])
+			reachesInput[v] = true;
+		for (int u : graph.inNodes(v)){
+			if(reachesInput[v]){
+				(*levels)[u] = max((*levels)[u],(*levels)[v]+1);
+				reachesInput[u] = true;
+			}
+			if(--pending[u]==0)
+				ready.push_back(u);
+		}
+	}
+	if(visited==graph.numNodes())
+		return true;
+
+	//the terms left are in a cycle or depend on it: each of them has a dependency left,
+	//so following such dependencies a term repeats
+	vector<int> step(graph.numNodes(),-1);
+	vector<int> path;
+	int u = 0;
+	while(pending[u]==0)
+		u++;
+	while(step[u]<0){
+		step[u] = path.size();
+		path.push_back(u);
+		const int* a = graph.outNodes(u).begin();
+		while(pending[*a]==0)
+			++a;
+		u = *a;
+	}
+	cout<<"ERROR: combinational cycle detected: ";
+	for(size_t i = step[u]; i < path.size(); i++)
+		cout<<signalTable().name(graph.name(path[i]))<<" -> ";
+	cout<<signalTable().name(graph.name(u))<<endl;
+	return false;
 }
 
 /**
@@ -273,89 +317,372 @@ void Analyzer::build_levels(ListDigraph::Node u,ListDigraph::NodeMap<int>* level
  * each subset function is assigned to a Translator object
  * */
 void Analyzer::generateCrossbar(){
-	for(map <int, vector<ListDigraph::NodeIt> >::const_iterator i = nodeLevels.begin(); i != nodeLevels.end(); i++){
+	PhaseTimer timer("Analyzer::generateCrossbar");
+	//levels are translated independently: with more jobs, the Translators are built on a thread pool
+	vector< pair<int, const vector<int>* > > levels;
+	for(map <int, vector<int> >::const_iterator i = nodeLevels.begin(); i != nodeLevels.end(); i++)
+		if(i->first!=0)
+			levels.push_back(make_pair(i->first,&i->second));
+	vector<Translator*> translators(levels.size(),NULL);
+
+	if(this->context->options.jobs>1 && levels.size()>1){
+		//the biggest levels are submitted first, so they don't start last
+		vector<size_t> order;
+		for(size_t k=0; k<levels.size(); k++)
+			order.push_back(k);
+		stable_sort(order.begin(), order.end(), [&levels](size_t x, size_t y){return levels[x].second->size() > levels[y].second->size();});
+
+		//the workers synthesize in the context of the design
+		ThreadPool pool(min<size_t>(this->context->options.jobs,levels.size()));
+		for(size_t k : order)
+			pool.submit([this,&levels,&translators,k]{
+				ContextScope scope(*this->context);
+				translators[k] = translateLevel(levels[k].first,*levels[k].second);
+			});
+		pool.wait();
+	}
+	else{
+		for(size_t k=0; k<levels.size(); k++)
+			translators[k] = translateLevel(levels[k].first,*levels[k].second);
+	}
 
-		if(i->first!=0){
+	//results are collected in level order
+	for(size_t k=0; k<levels.size(); k++){
+		Translator* tr = translators[k];
+		if(this->context->options.verbose){
+			cout<<"level: "<<levels[k].first<<endl<<endl;
+			cout<<tr->getVerboseLog();
+		}
+		subAnalyzers.push_back(tr);
 
-			if(execParameters.verbose){
-				cout<<"level: "<<i->first<<endl<<endl;
+		if(this->context->options.dot && this->context->options.deepDot)
+			tr->createDependenciesGraph(levels[k].first);
+	}
+}
+
+/**
+ * Creates the Translator of the level 'lev' (made of the terms 'nodes') and generates its crossbar.
+ * It only reads the Analyzer, so different levels can be translated concurrently.
+ */
+Translator* Analyzer::translateLevel(int lev, const vector<int>& nodes){
+	PhaseTimer timer("Analyzer::translateLevel", lev);
+	vector<literal> inputs;
+	vector<symbol> outputs;
+	for(vector<int>::const_iterator j = nodes.begin(); j != nodes.end(); ++j){
+		//build outputs
+		outputs.push_back(graph.name(*j));
+
+		//build inputs
+		for(int t : graph.outNodes(*j)){
+			literal in = makeLiteral(graph.name(t));
+			if (std::find(inputs.begin(), inputs.end(), in) == inputs.end()){
+				inputs.push_back(in);
+				inputs.push_back(negateLiteral(in));
 			}
+		}
+	}
 
-			vector<string> inputs, outputs;
-			multimap<string,vector<string> > minterms;
-			for(vector<ListDigraph::NodeIt>::const_iterator j = i->second.begin(); j != i->second.end(); ++j){
-				//build outputs
-				outputs.push_back(nodeNames[*j]);
-
-				//build inputs
-				for(ListDigraph::OutArcIt a(graph, *j); a!=INVALID; ++a){
-					if (std::find(inputs.begin(), inputs.end(), nodeNames[graph.target(a)]) == inputs.end()){
-						inputs.push_back(nodeNames[graph.target(a)]);
-						inputs.push_back("not_"+nodeNames[graph.target(a)]);
-					}
-				}
+	//build minterms: the sub-function is a view over the minterms of its outputs
+	MintermView minterms = func.getMinterms(outputs);
+	Translator* tr;
+	tr = new Translator(lev,move(inputs),move(outputs),move(minterms));
+	tr->outputDir = this->outputDir;
+	bool cached = tr->loadFromCache();
+	if(!cached && this->context->options.minimize)
+		tr->minimize();
+	tr->func.countLiterals();
+	if(!cached){
+		tr->generateCrossbar();
+		tr->generateVoltages();
+		tr->storeInCache();
+	}
+	return tr;
+}
+
+//input vectors simulated by a task, and how many are simulated (see EquivalenceChecker)
+static const int simulationWords = EquivalenceChecker::simulationWords;
+static const int maxExhaustiveInputs = EquivalenceChecker::maxExhaustiveInputs;
+static const long randomVectors = EquivalenceChecker::randomVectors;
+
+/**
+ * Returns the signals of level 0: the primary inputs in the order of the file, then the other ones (which nothing drives)
+ * */
+vector<symbol> Analyzer::primaryInputs(){
+	vector<symbol> inputs;
+	vector<bool> primary(graph.numNodes(), false);
+	map <int, vector<int> >::const_iterator level0 = nodeLevels.find(0);
+	if(level0 != nodeLevels.end())
+		for(vector<int>::const_iterator v = level0->second.begin(); v != level0->second.end(); ++v)
+			primary[*v] = true;
+	for(vector<literal>::const_iterator i = func.inputs.begin(); i != func.inputs.end(); ++i){
+		int v = graph.node(symbolOf(*i));
+		if(!isNegated(*i) && v>=0 && primary[v]){
+			inputs.push_back(symbolOf(*i));
+			primary[v] = false;
+		}
+	}
+	if(level0 != nodeLevels.end())
+		for(vector<int>::const_iterator v = level0->second.begin(); v != level0->second.end(); ++v)
+			if(primary[*v])
+				inputs.push_back(graph.name(*v));
+	return inputs;
+}
+
+/**
+ * Simulates the crossbars of the levels (see CrossbarSimulator), in level order, on the input vectors of the primary
+ * inputs (level 0): all of them, or a random sample if there are more than 2^maxExhaustiveInputs. The inputs of each
+ * crossbar are the simulated outputs of the crossbars before it, and its outputs are compared with its sub-function
+ * evaluated on the same inputs, so a wrong output is found in the crossbar which computes it.
+ * Blocks of vectors are simulated on a thread pool with more jobs.
+ * Returns false if an output differs, and prints the first input vector for which it does.
+ * */
+bool Analyzer::simulateCrossbars(){
+	PhaseTimer timer("Analyzer::simulateCrossbars");
+	vector<CrossbarSimulator> simulators;
+	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i)
+		simulators.push_back(CrossbarSimulator(*(*i)->getCrossbar()));
+	vector<symbol> inputs = primaryInputs();
+
+	this->simulationExhaustive = inputs.size()<=maxExhaustiveInputs;
+	this->simulatedVectors = this->simulationExhaustive? 1L<<inputs.size() : randomVectors;
+	long blocks = (this->simulatedVectors+64*simulationWords-1)/(64*simulationWords);
+	vector<long> wrong(blocks), first(blocks);
+	vector<int> sub(blocks), output(blocks);
+	vector< vector<bool> > vectors(blocks);
+	auto simulate = [&](long b){
+		wrong[b] = simulateBlock(b, this->simulationExhaustive, this->simulatedVectors, inputs, simulators,
+				&first[b], &sub[b], &output[b], &vectors[b]);
+	};
+	if(this->context->options.jobs>1 && blocks>1){
+		ThreadPool pool(min<long>(this->context->options.jobs,blocks));
+		for(long b=0; b<blocks; b++)
+			pool.submit([&simulate,b]{simulate(b);});
+		pool.wait();
+	}
+	else{
+		for(long b=0; b<blocks; b++)
+			simulate(b);
+	}
+
+	this->simulationMismatches = 0;
+	long failed = -1;
+	for(long b=0; b<blocks; b++){
+		this->simulationMismatches += wrong[b];
+		if(failed<0 && first[b]>=0)
+			failed = b;
+	}
+	const char* kind = this->simulationExhaustive? " (exhaustive)" : " (random)";
+	if(failed<0){
+		cout<<"Simulation of "<<this->file<<": the crossbars match their sub-functions on "
+				<<this->simulatedVectors<<" input vectors"<<kind<<endl;
+		return true;
+	}
+	cout<<"ERROR: simulation of "<<this->file<<": "<<this->simulationMismatches<<" of "
+			<<this->simulatedVectors<<" input vectors"<<kind<<" give a wrong output"<<endl;
+	Analyzer* a = this->subAnalyzers[sub[failed]];
+	cout<<"ERROR: output "<<signalTable().name(a->func.outputs[output[failed]])<<" of the crossbar of level "<<a->level
+			<<" differs from its sub-function for the input vector ";
+	for(size_t k=0; k<inputs.size(); k++)
+		cout<<(k>0? "*" : "")<<signalTable().literalName(makeLiteral(inputs[k],!vectors[failed][k]));
+	cout<<endl;
+	return false;
+}
+
+/**
+ * Simulates the crossbars on the block 'block' of 64*simulationWords input vectors (see simulateCrossbars()), out of 'total'
+ * (the vectors are the ones of EquivalenceChecker::inputVectors()).
+ * Returns how many vectors give a wrong output; the first one (-1 if none) is returned in 'first' (its index)
+ * and in 'failing' (the value of each input), the crossbar (index of the sub-function) and its output in 'sub' and 'output'.
+ * */
+long Analyzer::simulateBlock(long block, bool exhaustive, long total, const vector<symbol>& inputs,
+		const vector<CrossbarSimulator>& simulators, long* first, int* sub, int* output, vector<bool>* failing){
+	const int words = simulationWords;
+	vector<uint64_t> values(this->context->getSymbols().size()*words, 0);
+	EquivalenceChecker::inputVectors(block, exhaustive, inputs, words, values.data());
+	//vectors past the last one (exhaustively, with fewer than 64 of them)
+	vector<uint64_t> valid(words), wrong(words, 0);
+	for(int w=0; w<words; w++){
+		long base = (block*words+w)*64;
+		valid[w] = base>=total? 0 : total-base>=64? ~0ULL : (1ULL<<(total-base))-1;
+	}
 
-				//build minterms
-				typedef multimap<string,vector<string> >::iterator mmit;
-				std::pair <mmit, mmit> ret;
-				ret = func.minterms.equal_range(nodeNames[*j]);
-				minterms.insert(ret.first,ret.second);
+	*first = -1;
+	vector<uint64_t> simulated, expected;
+	for(size_t s=0; s<simulators.size(); s++){
+		const Function& f = this->subAnalyzers[s]->func;
+		int n = simulators[s].getNumOutputs();
+		simulated.assign((size_t)n*words, 0);
+		expected.assign((size_t)n*words, 0);
+		simulators[s].run(values.data(), words, simulated.data());
+		f.evaluate(values.data(), words, expected.data());
+		for(int k=0; k<n; k++){
+			for(int w=0; w<words; w++){
+				uint64_t diff = (simulated[k*words+w] ^ expected[k*words+w]) & valid[w];
+				if(diff==0)
+					continue;
+				wrong[w] |= diff;
+				long index = (block*words+w)*64 + __builtin_ctzll(diff);
+				if(*first<0 || index<*first){
+					*first = index;
+					*sub = s;
+					*output = k;
+				}
 			}
-			Translator* tr;
-			tr = new Translator(i->first,inputs,outputs,minterms);
-			tr->func.countLiterals();
-			tr->generateCrossbar();
-			tr->generateVoltages();
-			subAnalyzers.push_back(tr);
-
-			if(execParameters.dot && execParameters.deepDot)
-				tr->createDependenciesGraph(i->first);
-
-			//#ifndef _DEBUG_
-			//				//kill the child (otherwise it would re-execute the parent's code)
-			//				exit(0);
-			//			}
-			//#endif _DEBUG_
+			//the crossbars after this one read what it computed
+			copy(&simulated[k*words], &simulated[(k+1)*words], &values[(size_t)f.outputs[k]*words]);
+		}
+	}
+
+	long count = 0;
+	for(int w=0; w<words; w++)
+		count += __builtin_popcountll(wrong[w]);
+	if(*first>=0){
+		int w = (*first/64)%words, bit = *first%64;
+		failing->clear();
+		for(size_t k=0; k<inputs.size(); k++)
+			failing->push_back(((values[(size_t)inputs[k]*words+w]>>bit)&1)!=0);
+	}
+	return count;
+}
+
+/**
+ * Checks that the crossbars compute the function of the EQN file (see EquivalenceChecker): the reference is the
+ * function of each signal as the file defines it, the implementation is the function each crossbar computes,
+ * as it's read back from its memristors (see Crossbar::readFunction()). They're compared on the primary outputs,
+ * from the signals of level 0.
+ * Returns false if an output differs, and prints an input vector for which it does;
+ * the outputs not proven within the budget of their miters are only warned about.
+ * */
+bool Analyzer::verifyEquivalence(){
+	PhaseTimer timer("Analyzer::verifyEquivalence");
+	vector<symbol> inputs = primaryInputs();
+	vector<symbol> outputs;
+	for(vector<symbol>::const_iterator o = func.outputs.begin(); o != func.outputs.end(); ++o)
+		if(graph.node(*o)>=0)
+			outputs.push_back(*o);
+	EquivalenceChecker checker(inputs, outputs, this->context->getSymbols().size());
+	for(map <int, vector<int> >::const_iterator l = nodeLevels.begin(); l != nodeLevels.end(); ++l){
+		if(l->first==0)
+			continue;
+		for(vector<int>::const_iterator v = l->second.begin(); v != l->second.end(); ++v){
+			symbol s = graph.name(*v);
+			checker.addGate(EquivalenceChecker::reference, s);
+			pair<multimap<symbol,vector<literal> >::const_iterator, multimap<symbol,vector<literal> >::const_iterator> range =
+					func.minterms.equal_range(s);
+			for(multimap<symbol,vector<literal> >::const_iterator m = range.first; m != range.second; ++m)
+				checker.addProduct(EquivalenceChecker::reference, m->second);
+		}
+	}
+	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i){
+		Function f = (*i)->getCrossbar()->readFunction();
+		for(vector<symbol>::const_iterator o = f.outputs.begin(); o != f.outputs.end(); ++o){
+			checker.addGate(EquivalenceChecker::implementation, *o);
+			pair<multimap<symbol,vector<literal> >::const_iterator, multimap<symbol,vector<literal> >::const_iterator> range =
+					f.minterms.equal_range(*o);
+			for(multimap<symbol,vector<literal> >::const_iterator m = range.first; m != range.second; ++m)
+				checker.addProduct(EquivalenceChecker::implementation, m->second);
 		}
 	}
+
+	this->verification = checker.check(this->context->options.jobs);
+	this->verificationExhaustive = checker.isExhaustive();
+	this->verificationVectors = checker.getVectors();
+	this->verificationMiters = checker.getMiters();
+	ostringstream method;
+	method<<checker.getVectors()<<(checker.isExhaustive()? " input vectors, exhaustive" : " random input vectors");
+	if(checker.getMiters()>0)
+		method<<" and "<<checker.getMiters()<<" SAT miters";
+	switch(this->verification){
+	case EquivalenceChecker::equivalent:
+		cout<<"Verification of "<<this->file<<": the crossbars are equivalent to the EQN function ("<<method.str()<<")"<<endl;
+		return true;
+	case EquivalenceChecker::undecided:
+		cout<<"WARNING: verification of "<<this->file<<": no difference found ("<<method.str()<<"), but the equivalence of";
+		for(vector<symbol>::const_iterator o = checker.getUndecidedOutputs().begin(); o != checker.getUndecidedOutputs().end(); ++o)
+			cout<<" "<<signalTable().name(*o);
+		cout<<" isn't proven (SAT conflict budget exceeded)"<<endl;
+		return true;
+	default:
+		break;
+	}
+	cout<<"ERROR: verification of "<<this->file<<": output "<<signalTable().name(checker.getFailingOutput())
+			<<" of the crossbars differs from the EQN function for the input vector ";
+	for(size_t k=0; k<inputs.size(); k++)
+		cout<<(k>0? "*" : "")<<signalTable().literalName(makeLiteral(inputs[k],!checker.getCounterexample()[k]));
+	cout<<endl;
+	return false;
 }
 
 /**
  * this procedure generates VHDL version of the whole circuit
  * */
 void Analyzer::generateOutputVHDL(){
-	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i){
-		(*i)->generateOutputVHDL();
+	PhaseTimer timer("Analyzer::generateOutputVHDL");
+	shareEquivalentCrossbars();
+	//each level with its own entity writes its own files: with more jobs, they're written on a thread pool
+	vector<Analyzer*> entities;
+	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i)
+		if((*i)->sharedEntity==NULL)
+			entities.push_back(*i);
+	if(this->context->options.jobs>1 && entities.size()>1){
+		ThreadPool pool(min<size_t>(this->context->options.jobs,entities.size()));
+		for(vector<Analyzer*>::const_iterator i = entities.begin() ; i != entities.end(); ++i){
+			Analyzer* sub = *i;
+			pool.submit([sub]{
+				ContextScope scope(*sub->context);
+				sub->generateOutputVHDL();
+			});
+		}
+		pool.wait();
+	}
+	else{
+		for(vector<Analyzer*>::const_iterator i = entities.begin() ; i != entities.end(); ++i){
+			(*i)->generateOutputVHDL();
+		}
 	}
 	generateStructuralOutputVHDL();
 }
 
+/**
+ * Finds the levels whose sub-functions are the same function up to a renaming of the signals (same canonical
+ * form): only the first one of them gets its VHDL entity, the others instantiate it (see sharedEntity).
+ * */
+void Analyzer::shareEquivalentCrossbars(){
+	if(!this->context->options.shareEntities)
+		return;
+	PhaseTimer timer("Analyzer::shareEquivalentCrossbars");
+	unordered_map<string,Analyzer*> entityOf;
+	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i){
+		pair<unordered_map<string,Analyzer*>::iterator,bool> entity = entityOf.insert(make_pair((*i)->func.canonicalForm(),*i));
+		(*i)->sharedEntity = entity.second? NULL : entity.first->second;
+	}
+}
+
 /**
  * this procedure generates VHDL structural file (all the crossbar connected togheter)
  * */
 void Analyzer::generateStructuralOutputVHDL(){
+	PhaseTimer timer("Analyzer::generateStructuralOutputVHDL");
 
 	string entity = (*tokenize(*(tokenize(this->file,"/").end()-1),".").begin());
 
-	std::ofstream out(string("./"+entity+".vhd").c_str());
-	std::streambuf *coutbuf = std::cout.rdbuf(); //save old buf
-	std::cout.rdbuf(out.rdbuf()); //redirect std::cout
+	FileWriter out(this->outputDir+entity+".vhd");
 
 
-	cout<<"----------------------------------------------------------------------------------\n"
+	out<<"----------------------------------------------------------------------------------\n"
 			"-- Engineer: 		Marcello Traiola\n"
 			"--\n"
 			"-- Create Date: ";
 	time_t t = time(0);   // get time now
 	struct tm * now = localtime( & t );
-	cout << (now->tm_hour) << ':'
+	out << (now->tm_hour) << ':'
 			<< (now->tm_min) << ':'
 			<< (now->tm_sec) << ' '
 			<<(now->tm_mday) << '/'
 			<< (now->tm_mon + 1) << '/'
 			<< (now->tm_year + 1900)
-			<< endl;
-	cout<<
+			<< '\n';
+	out<<
 			"-- Design Name: \n"
 			"-- Module Name: \n"
 			"-- Project Name: \n"
@@ -370,17 +697,17 @@ void Analyzer::generateStructuralOutputVHDL(){
 			"\n"
 			"entity "<<VHDLsintaxFilter(entity.c_str())<<" is\n"
 			"Port ( \n";
-	for(vector<string>::const_iterator i = func.inputs.begin(); i!= func.inputs.end();i++){
-		if((*i).find("not_") == std::string::npos)
-			cout<<VHDLsintaxFilter(*i)<<" : in  STD_LOGIC;\n";
+	for(vector<literal>::const_iterator i = func.inputs.begin(); i!= func.inputs.end();i++){
+		if(!isNegated(*i))
+			out<<VHDLsintaxFilter(signalTable().name(symbolOf(*i)))<<" : in  STD_LOGIC;\n";
 	}
-	for(vector<string>::const_iterator i = func.outputs.begin(); i!= func.outputs.end();i++){
+	for(vector<symbol>::const_iterator i = func.outputs.begin(); i!= func.outputs.end();i++){
 		if(i!=func.outputs.end()-1)
-			cout<<VHDLsintaxFilter(*i)<<" : out  STD_LOGIC;\n";
+			out<<VHDLsintaxFilter(signalTable().name(*i))<<" : out  STD_LOGIC;\n";
 		else
-			cout<<VHDLsintaxFilter(*i)<<" : out  STD_LOGIC\n";
+			out<<VHDLsintaxFilter(signalTable().name(*i))<<" : out  STD_LOGIC\n";
 	}
-	cout<<	");\n"
+	out<<	");\n"
 			"end "<<VHDLsintaxFilter(entity.c_str())<<";\n"
 			"\n"
 			"architecture Behavioral of "<<VHDLsintaxFilter(entity.c_str())<<" is\n"
@@ -388,73 +715,104 @@ void Analyzer::generateStructuralOutputVHDL(){
 
 	vector<string> tempWires;
 	string instances;
+	//one clock for all the controllers and their memristors, instead of one each
+	bool sharedClock = this->context->options.sharedClock;
 
 	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i){
-		//declare each crossbar
-		cout<<"COMPONENT crossbar_controller_"<<(*i)->level<<"\n"
-				"PORT(\n";
-		instances+="Inst_Crossbar_"+to_string((*i)->level)+" : crossbar_controller_"+to_string((*i)->level)+" PORT MAP(\n";
-
-		for(vector<string>::const_iterator j = (*i)->func.inputs.begin(); j!= (*i)->func.inputs.end();j++){
-			if((*j).find("not_") == std::string::npos){
-				cout<<VHDLsintaxFilter(*j)<<" : in  STD_LOGIC;\n";
-				instances+=VHDLsintaxFilter(*j)+" => "+VHDLsintaxFilter(*j)+"_temp,\n";
+		//declare each crossbar entity (a level sharing the entity of another one is mapped on its ports, in order)
+		Analyzer* entity = (*i)->sharedEntity!=NULL? (*i)->sharedEntity : *i;
+		bool declare = entity == *i;
+		if(declare)
+			out<<"COMPONENT crossbar_controller_"<<(*i)->level<<"\n"
+					"PORT(\n";
+		instances+="Inst_Crossbar_"+to_string((*i)->level)+" : crossbar_controller_"+to_string(entity->level)+" PORT MAP(\n";
+
+		for(vector<literal>::const_iterator j = (*i)->func.inputs.begin(), k = entity->func.inputs.begin(); j!= (*i)->func.inputs.end();j++,k++){
+			if(!isNegated(*j)){
+				string name = VHDLsintaxFilter(signalTable().name(symbolOf(*j)));
+				string port = VHDLsintaxFilter(signalTable().name(symbolOf(*k)));
+				if(declare)
+					out<<port<<" : in  STD_LOGIC;\n";
+				instances+=port+" => "+name+"_temp,\n";
 			}
 		}
-		cout<<"en : in STD_LOGIC;\n";
+		if(declare)
+			out<<"en : in STD_LOGIC;\n";
 		instances+="en => done_temp_"+to_string(((*i)->level)-1)+",\n";
-		for(vector<string>::const_iterator j = (*i)->func.outputs.begin(); j != (*i)->func.outputs.end();j++){
-			cout<<VHDLsintaxFilter(*j)<<" : out  STD_LOGIC;\n";
+		if(sharedClock){
+			if(declare)
+				out<<"XbG_clk : in STD_LOGIC;\n";
+			instances+="XbG_clk => XbG_clk,\n";
+		}
+		for(vector<symbol>::const_iterator j = (*i)->func.outputs.begin(), k = entity->func.outputs.begin(); j != (*i)->func.outputs.end();j++,k++){
+			string name = VHDLsintaxFilter(signalTable().name(*j));
+			string port = VHDLsintaxFilter(signalTable().name(*k));
+			if(declare)
+				out<<port<<" : out  STD_LOGIC;\n";
 
-			instances+=VHDLsintaxFilter(*j)+" => "+VHDLsintaxFilter(*j)+"_temp,\n";
+			instances+=port+" => "+name+"_temp,\n";
 
-			tempWires.push_back(VHDLsintaxFilter(*j)+"_temp");
+			tempWires.push_back(name+"_temp");
 		}
 		instances+="done => done_temp_"+to_string((*i)->level)+"\n"+");\n\n";
 
-		cout<<"done : out STD_LOGIC\n"
-				");\n"
+		if(declare)
+			out<<"done : out STD_LOGIC\n"
+					");\n"
 
-				"END COMPONENT;\n\n";
+					"END COMPONENT;\n\n";
 	}
-	for(vector<string>::const_iterator j = func.inputs.begin(); j!= func.inputs.end();j++)
-		if((*j).find("not_") == std::string::npos)
-			cout<<"signal "<<VHDLsintaxFilter(*j)<<"_temp : STD_LOGIC;\n";
+	for(vector<literal>::const_iterator j = func.inputs.begin(); j!= func.inputs.end();j++)
+		if(!isNegated(*j))
+			out<<"signal "<<VHDLsintaxFilter(signalTable().name(symbolOf(*j)))<<"_temp : STD_LOGIC;\n";
 
 	for(vector<string>::const_iterator j = tempWires.begin(); j!= tempWires.end();j++)
-		cout<<"signal "<<VHDLsintaxFilter(*j)<<" : STD_LOGIC;\n";
+		out<<"signal "<<VHDLsintaxFilter(*j)<<" : STD_LOGIC;\n";
 
 	for(int i = 0; i <= subAnalyzers.size();++i)
-		cout<<"signal done_temp_"<<i<<" : STD_LOGIC;\n";
-
-	cout<<
+		out<<"signal done_temp_"<<i<<" : STD_LOGIC;\n";
+	if(sharedClock)
+		out<<"\n"
+				"signal XbG_clk : std_logic := '0';\n"
+				"\n"
+				"constant XbG_clk_period : time := 1 ns;\n";
+
+	out<<
 			"\n"
 			"begin\n"
 			"\n"<<instances;
+	if(sharedClock)
+		out<<"-- Clock process definitions\n"
+				"XbG_clk_process : process (XbG_clk)\n"
+				"begin\n"
+				"XbG_clk <= not(XbG_clk) after XbG_clk_period/2; --only behavioral simulation\n"
+				"end process;\n"
+				"\n";
 
 	vector<string> sensitivityList;
-	for(vector<string>::const_iterator i = func.inputs.begin(); i != func.inputs.end(); i++){
-		if((*i).find("not_") == std::string::npos)
-			sensitivityList.push_back((VHDLsintaxFilter(*i)));
+	for(vector<literal>::const_iterator i = func.inputs.begin(); i != func.inputs.end(); i++){
+		if(!isNegated(*i))
+			sensitivityList.push_back((VHDLsintaxFilter(signalTable().name(symbolOf(*i)))));
 	}
 	for(vector<string>::const_iterator i=sensitivityList.begin(); i != sensitivityList.end(); ++i){
-		cout<<*i+"_temp"<<" <= "+*i+";\n";
+		out<<*i+"_temp"<<" <= "+*i+";\n";
 	}
-	for(vector<string>::const_iterator i = func.outputs.begin(); i != func.outputs.end(); i++){
-		if (std::find(tempWires.begin(), tempWires.end(), VHDLsintaxFilter(*i)+"_temp") != tempWires.end())
-			cout<<VHDLsintaxFilter(*i)<<" <= "+VHDLsintaxFilter(*i)+"_temp;\n";
+	for(vector<symbol>::const_iterator i = func.outputs.begin(); i != func.outputs.end(); i++){
+		string name = VHDLsintaxFilter(signalTable().name(*i));
+		if (std::find(tempWires.begin(), tempWires.end(), name+"_temp") != tempWires.end())
+			out<<name<<" <= "+name+"_temp;\n";
 		else
-			cout<<VHDLsintaxFilter(*i)<<" <= '"<<func.minterms.find(*i)->second.front()<<"';\n";
+			out<<name<<" <= '"<<signalTable().literalName(func.minterms.find(*i)->second.front())<<"';\n";
 
 	}
-	cout<<"\nprocess(";
+	out<<"\nprocess(";
 	for(vector<string>::const_iterator i=sensitivityList.begin(); i != sensitivityList.end(); ++i){
 		if(i!=sensitivityList.end()-1)
-			cout<<*i<<",";
+			out<<*i<<",";
 		else
-			cout<<*i;
+			out<<*i;
 	}
-	cout<<")\n"
+	out<<")\n"
 			"begin\n"
 			"done_temp_0<='1';\n"
 			"done_temp_0<='0' after 4 ns;\n"
@@ -462,40 +820,149 @@ void Analyzer::generateStructuralOutputVHDL(){
 			"\n"
 			"end Behavioral;\n";
 
-	std::cout.rdbuf(coutbuf); //reset to standard output again
 }
 
 /**
- * generates a file with all statistics
+ * retrieves the size of the circuit: inputs, outputs, minterms, memristors, area,
+ * computation steps and crossbars (in this order)
  * */
-void Analyzer::printOutputStats(){
+vector< pair<string,double> > Analyzer::getSizeStats(){
+	vector< pair<string,double> > stats;
+	stats.push_back(make_pair("inputs", func.getNumInput()/2));
+	stats.push_back(make_pair("outputs", func.getNumOutput()));
+	stats.push_back(make_pair("minterms", getNumOfMinterms()));
+	stats.push_back(make_pair("memristors", getNumMemristor()));
+	stats.push_back(make_pair("area", getArea()));
+	stats.push_back(make_pair("computation_steps", getNumOfComputationSteps()));
+	stats.push_back(make_pair("crossbars", getNumOfStages()));
+	return stats;
+}
+
+/**
+ * generates a file with all statistics and, when the phases are profiled and 'report' is set,
+ * its JSON version (with the time and the memory taken by each phase)
+ * */
+void Analyzer::printOutputStats(bool report){
 	string entity = (*tokenize(*(tokenize(this->file,"/").end()-1),".").begin());
+	vector< pair<string,double> > stats = getSizeStats();
+
+	FileWriter out(this->outputDir+entity+"_stat.txt");
+
+	out<<"Inputs: "<<(int)stats[0].second<<'\n';
+	out<<"Outputs: "<<(int)stats[1].second<<'\n';
+	out<<"Minterms: "<<(int)stats[2].second<<'\n';
+	out<<"Number of memristors of the circuit: "<<(int)stats[3].second<<'\n';
+	out<<"Total area of the circuit: k^2 * "<<(int)stats[4].second<<" (where k^2 = area of a crossbar's cell)"<<'\n';
+	out<<"Number of steps (memristor switching) to complete computation: "<<(int)stats[5].second<<'\n';
+	out<<"Number of crossbars: "<<(int)stats[6].second<<'\n';
+
+	//the entities written in the VHDL files (equivalent crossbars share one)
+	int entities = 0;
+	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i)
+		entities += (*i)->sharedEntity==NULL? 1 : 0;
+	if(this->context->options.vhdl){
+		out<<"Number of crossbar entities in the VHDL files: "<<entities<<'\n';
+		stats.push_back(make_pair("vhdl_entities", entities));
+	}
 
-	std::ofstream out(string("./"+entity+"_stat.txt").c_str());
-	std::streambuf *coutbuf = std::cout.rdbuf(); //save old buf
-	std::cout.rdbuf(out.rdbuf()); //redirect std::cout
-
-	cout<<"Inputs: "<<func.getNumInput()/2<<endl;
-	cout<<"Outputs: "<<func.getNumOutput()<<endl;
-	cout<<"Minterms: "<<getNumOfMinterms()<<endl;
-	cout<<"Number of memristors of the circuit: "<<getNumMemristor()<<endl;
-	cout<<"Total area of the circuit: k^2 * "<<getArea()<<" (where k^2 = area of a crossbar's cell)"<<endl;
-	cout<<"Number of steps (memristor switching) to complete computation: "<<getNumOfComputationSteps()<<endl;
-	cout<<"Number of crossbars: "<<getNumOfStages()<<endl;
-
-	int* powCons = getPowerConsumption();
-	cout<<"Estimated power consumption (worst case): "<<powCons[0] <<" * (Cup+Cdown)"<<endl;
-	cout<<"Estimated error (worst case): "<<powCons[2]<<" * (Cup+Cdown)"<<endl;
-	cout<<"Estimated power consumption (best case): "<<powCons[1]<<" * (Cup+Cdown)"<<endl;
-	cout<<"Estimated error (best case): "<<powCons[3]<<" * (Cup+Cdown)"<<endl;
-
-	auto time= chrono::high_resolution_clock::now() - startTime;
-	cout<<"XbarGen exec time: "<<std::chrono::duration<double, std::milli>(time).count()<<" ms";
-	std::cout.rdbuf(coutbuf); //reset to standard output again
-	if(execParameters.verbose)
+	if(this->context->options.minimize){
+		//size of each crossbar before and after the minimization
+		int areaBefore = 0, memristorsBefore = 0;
+		out<<"Crossbars before -> after minimization (rows x columns, memristors):"<<'\n';
+		for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i){
+			vector<int> sizes = (*i)->getMinimizationStats();
+			if(sizes.empty())
+				continue;
+			out<<"\tlevel "<<(*i)->level<<": "<<sizes[0]<<"x"<<sizes[2]<<", "<<sizes[3]<<" -> "
+					<<sizes[1]<<"x"<<sizes[2]<<", "<<sizes[4]<<'\n';
+			areaBefore += sizes[0]*sizes[2];
+			memristorsBefore += sizes[3];
+		}
+		out<<"Number of memristors of the circuit before minimization: "<<memristorsBefore<<'\n';
+		out<<"Total area of the circuit before minimization: k^2 * "<<areaBefore<<'\n';
+		stats.push_back(make_pair("memristors_before_minimization", memristorsBefore));
+		stats.push_back(make_pair("area_before_minimization", areaBefore));
+	}
+
+	vector<SwitchingActivity> activities;
+	vector<int> powCons = getPowerConsumption(&activities);
+	out<<"Estimated power consumption (worst case): "<<powCons[0] <<" * (Cup+Cdown)"<<'\n';
+	out<<"Estimated error (worst case): "<<powCons[2]<<" * (Cup+Cdown)"<<'\n';
+	out<<"Estimated power consumption (best case): "<<powCons[1]<<" * (Cup+Cdown)"<<'\n';
+	out<<"Estimated error (best case): "<<powCons[3]<<" * (Cup+Cdown)"<<'\n';
+	stats.push_back(make_pair("power_worst_case", powCons[0]));
+	stats.push_back(make_pair("error_worst_case", powCons[2]));
+	stats.push_back(make_pair("power_best_case", powCons[1]));
+	stats.push_back(make_pair("error_best_case", powCons[3]));
+
+	//input vectors of the worst and best case of each crossbar (exact ones, or the ones found by the local search)
+	int exact = 0;
+	out<<"Input vectors of the worst -> best case of each crossbar:"<<'\n';
+	for(size_t k=0; k<activities.size(); k++){
+		const Function& f = this->subAnalyzers[k]->func;
+		exact += activities[k].exact? 1 : 0;
+		out<<"\tlevel "<<this->subAnalyzers[k]->level<<(activities[k].exact? ": " : " (local search): ");
+		for(int pass=0; pass<2; pass++){
+			const vector<bool>& x = pass==0? activities[k].worstVector : activities[k].bestVector;
+			for(size_t v=0; v<x.size(); v++)
+				out<<(v>0? "*" : "")<<signalTable().literalName(makeLiteral(f.getVariable(v),!x[v]));
+			out<<(pass==0? " -> " : "\n");
+		}
+	}
+	out<<"Crossbars with exact worst and best case: "<<exact<<" of "<<(int)activities.size()<<'\n';
+	stats.push_back(make_pair("exact_power_crossbars", exact));
+
+	if(this->context->options.simulate){
+		out<<"Input vectors simulated on the crossbars: "<<this->simulatedVectors<<(this->simulationExhaustive? " (exhaustive)" : " (random)")<<'\n';
+		out<<"Input vectors with a wrong output in the simulation: "<<this->simulationMismatches<<'\n';
+		stats.push_back(make_pair("simulated_vectors", this->simulatedVectors));
+		stats.push_back(make_pair("simulation_mismatches", this->simulationMismatches));
+	}
+
+	if(this->context->options.verify){
+		const char* verdicts[] = {"equivalent", "different", "undecided"};
+		out<<"Equivalence of the crossbars with the EQN function: "<<verdicts[this->verification]<<" ("
+				<<this->verificationVectors<<(this->verificationExhaustive? " input vectors, exhaustive" : " random input vectors")
+				<<", "<<this->verificationMiters<<" SAT miters)"<<'\n';
+		stats.push_back(make_pair("equivalent", this->verification==EquivalenceChecker::equivalent? 1 : 0));
+		stats.push_back(make_pair("verification_miters", this->verificationMiters));
+	}
+
+	if(!this->context->options.cacheDir.empty()){
+		//how many crossbars (and VHDL files) were taken from the cache
+		int crossbarHits = 0, filesHits = 0, crossbars = this->subAnalyzers.size();
+		for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i){
+			crossbarHits += (*i)->crossbarFromCache? 1 : 0;
+			filesHits += (*i)->filesFromCache? 1 : 0;
+		}
+		out<<"Crossbars taken from the cache: "<<crossbarHits<<" of "<<crossbars<<'\n';
+		stats.push_back(make_pair("cache_crossbar_hits", crossbarHits));
+		stats.push_back(make_pair("cache_crossbar_misses", crossbars-crossbarHits));
+		if(this->context->options.vhdl){
+			out<<"VHDL files of crossbar entities taken from the cache: "<<filesHits<<" of "<<entities<<'\n';
+			stats.push_back(make_pair("cache_vhdl_hits", filesHits));
+			stats.push_back(make_pair("cache_vhdl_misses", entities-filesHits));
+		}
+	}
+
+	auto time= chrono::high_resolution_clock::now() - this->start;
+	out<<"XbarGen exec time: "<<std::chrono::duration<double, std::milli>(time).count()<<" ms";
+	out.close();
+	stats.push_back(make_pair("exec_time_ms", std::chrono::duration<double, std::milli>(time).count()));
+	if(report && this->context->profiler.isEnabled())
+		this->context->profiler.writeReport(this->outputDir+entity+"_stat.json", entity, stats);
+	if(this->context->options.verbose)
 		cout<<"XbarGen exec time: "<<std::chrono::duration<double, std::milli>(time).count()<<" ms"<<endl;
 }
 
+/**
+ * Destructor: the Translators of the levels belong to the Analyzer
+ * */
+Analyzer::~Analyzer(){
+	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin() ; i != this->subAnalyzers.end(); ++i)
+		delete *i;
+}
+
 /**
  * retrieves number of memeristor of the whole circuit
  * */
@@ -544,43 +1011,56 @@ int Analyzer::getNumOfMinterms(){
 }
 
 /**
- * retrieves the power consumption bounds and estimated errors for the circuit
+ * retrieves the switching activity of each crossbar (in 'activities') and the power consumption of the circuit:
+ * worst case, best case, error of the worst case, error of the best case (0 if they're exact)
  * */
-int* Analyzer::getPowerConsumption(){
+vector<int> Analyzer::getPowerConsumption(vector<SwitchingActivity>* activities){
+	PhaseTimer timer("Analyzer::getPowerConsumption");
 	/*** ESTIMATING POWER CONSUMPTION ***/
 	//for each crossbar
-	int* powCons = new int[4];
-	memset(powCons,0,4*sizeof(int));
+	vector<int> powCons(4,0);
+	activities->clear();
 
 	for(vector<Analyzer*>::const_iterator i = this->subAnalyzers.begin(); i != this->subAnalyzers.end();i++){
 
-		//			cout<<"level: "<<(*i)->level<<endl;
-		//			cout<<"input: "<<(*i)->func.getNumInput()/2<<endl;
-		//			cout<<"output: "<<(*i)->func.getNumOutput()<<endl;
-
 		//calculate the pow cons for operative memristors
-		int* opMem = (*i)->getOperativeMemristorPowerConsumption();
+		activities->push_back((*i)->getSwitchingActivity());
+		const SwitchingActivity& opMem = activities->back();
 
 		//calculate the pow cons for worst and best case
-		powCons[0] += (*i)->func.getNumInput()/2 + (*i)->func.getNumOutput() + opMem[0];
-		powCons[1] += (*i)->func.getNumInput()/2 + (*i)->func.getNumOutput() + opMem[1];
+		powCons[0] += (*i)->func.getNumInput()/2 + (*i)->func.getNumOutput() + opMem.worst;
+		powCons[1] += (*i)->func.getNumInput()/2 + (*i)->func.getNumOutput() + opMem.best;
 
 		//get the error for the worst case
-		powCons[2] += opMem[2];
+		powCons[2] += opMem.worstError;
 		//get the error for the best case
-		powCons[3] += opMem[3];
-
-
+		powCons[3] += opMem.bestError;
 	}
 	return powCons;
 
 }
 
 /**
- * retrieves the power consumption estimation for memristors which are dependent on workload
+ * retrieves the switching activity of the operative memristors, which depends on the workload
+ * (this function is implemented only in Translator class)
+ * */
+SwitchingActivity Analyzer::getSwitchingActivity(){
+	return SwitchingActivity();
+}
+
+/**
+ * retrieves the crossbar size before and after the minimization
+ * (this function is implemented only in Translator class)
+ * */
+vector<int> Analyzer::getMinimizationStats(){
+	return vector<int>();
+}
+
+/**
+ * retrieves the crossbar of the sub-function
  * (this function is implemented only in Translator class)
  * */
-int* Analyzer::getOperativeMemristorPowerConsumption(){
+const Crossbar* Analyzer::getCrossbar(){
 	return NULL;
 }
 
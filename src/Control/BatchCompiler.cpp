@@ -0,0 +1,244 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures. 
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * BatchCompiler.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "boundary.h"
+#include "my_utils.h"
+#include "thread_pool.h"
+#include "profiler.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cerrno>
+#include <dirent.h>
+
+using namespace std;
+
+/**
+ * Constructor: the designs are compiled with the options of 'context',
+ * and the output directory of each design is created inside 'outputDir'
+ */
+BatchCompiler::BatchCompiler(XbarGenContext& context, string outputDir) : context(context), outputDir(outputDir), time(0), workers(0){
+	if(this->outputDir.empty())
+		this->outputDir = "./";
+	else if(this->outputDir[this->outputDir.size()-1]!='/')
+		this->outputDir += '/';
+}
+
+/**
+ * Adds the designs of 'path': if it's a directory, its .eqn files (in alphabetical order),
+ * otherwise it's a list with a path per line (empty lines and lines starting with '#' are skipped).
+ * Designs with the same name get a numeric suffix, so each of them has its own directory.
+ * Returns false if 'path' can't be read.
+ */
+bool BatchCompiler::addInputs(string path){
+	vector<string> files;
+	struct stat info;
+	if(stat(path.c_str(),&info)==0 && S_ISDIR(info.st_mode)){
+		DIR* dir = opendir(path.c_str());
+		if(dir==NULL){
+			cout<<"ERROR: unable to read the directory "<<path<<endl;
+			return false;
+		}
+		for(struct dirent* e = readdir(dir); e != NULL; e = readdir(dir)){
+			string name(e->d_name);
+			if(name.size()>4 && name.compare(name.size()-4,4,".eqn")==0)
+				files.push_back(path+(path[path.size()-1]=='/'? "" : "/")+name);
+		}
+		closedir(dir);
+		sort(files.begin(), files.end());
+		if(files.empty())
+			cout<<"WARNING: no .eqn file in "<<path<<endl;
+	}
+	else{
+		ifstream list(path.c_str());
+		if(!list.is_open()){
+			cout<<"ERROR: unable to read the list "<<path<<endl;
+			return false;
+		}
+		string line;
+		while(getline(list,line)){
+			trim(&line);
+			if(!line.empty() && line[0]!='#')
+				files.push_back(line);
+		}
+	}
+
+	for(vector<string>::const_iterator f = files.begin(); f != files.end(); ++f){
+		design d;
+		d.file = *f;
+		d.name = (*tokenize(*(tokenize(*f,"/").end()-1),".").begin());
+		//names must be unique, since they name the output directories
+		string name = d.name;
+		for(int n=2; find_if(this->designs.begin(), this->designs.end(), [&d](const design& x){return x.name==d.name;}) != this->designs.end(); n++)
+			d.name = name+"_"+to_string(n);
+		d.outputDir = this->outputDir+d.name+"/";
+		d.done = false;
+		d.time = 0;
+		this->designs.push_back(d);
+	}
+	return true;
+}
+
+/**
+ * Compiles the designs with 'jobs' workers (at least one), the biggest files first,
+ * so that the longest designs don't start last. Returns the number of designs which failed.
+ */
+int BatchCompiler::run(int jobs){
+	ContextScope scope(this->context);
+	PhaseTimer timer("BatchCompiler::run");
+	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+	if(mkdir(this->outputDir.c_str(),0777)!=0 && errno!=EEXIST)
+		cout<<"WARNING: unable to create the directory "<<this->outputDir<<endl;
+	//the reserved words are read once, for all the designs
+	if(this->context.options.vhdl && !this->context.hasVHDLReservedWords() && !this->context.loadVHDLReservedWords())
+		cout<<"WARNING: VHDL reserved words are not loaded\n";
+
+	vector< pair<long long,size_t> > order;
+	for(size_t k=0; k<this->designs.size(); k++){
+		struct stat info;
+		order.push_back(make_pair(stat(this->designs[k].file.c_str(),&info)==0? -(long long)info.st_size : 0, k));
+	}
+	stable_sort(order.begin(), order.end());
+
+	this->workers = max(1,min<int>(jobs,this->designs.size()));
+	{
+		ThreadPool pool(this->workers);
+		for(size_t k=0; k<order.size(); k++){
+			design* d = &this->designs[order[k].second];
+			pool.submit([this,d]{compile(*d);});
+		}
+		pool.wait();
+	}
+	this->time = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+	int failed = 0;
+	for(vector<design>::const_iterator d = this->designs.begin(); d != this->designs.end(); ++d)
+		if(!d->done)
+			failed++;
+	return failed;
+}
+
+/**
+ * Compiles a design, in a context of its own, into its own directory.
+ * The designs are the unit of work of the batch: the levels of a design are translated one at a time.
+ */
+void BatchCompiler::compile(design& d){
+	ContextScope batchScope(this->context);
+	PhaseTimer timer("BatchCompiler::compile");
+	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+	XbarGenContext designContext;
+	designContext.options = this->context.options;
+	designContext.options.jobs = 1;
+	designContext.shareVHDLReservedWords(this->context);
+	//the phases of the design are profiled on their own, then they're added to the ones of the batch
+	double offset = this->context.profiler.isEnabled()? this->context.profiler.elapsed() : 0;
+	if(this->context.profiler.isEnabled())
+		designContext.profiler.enable();
+	//the same flow of a single design: the design fails if its crossbars don't pass the checks demanded
+	d.done = designContext.compile(d.file, d.outputDir, &d.stats);
+	if(!d.done)
+		cout<<"ERROR: "<<d.file<<" not compiled"<<endl;
+	vector<phaseRecord> phases = designContext.profiler.takePhases();
+	for(vector<phaseRecord>::iterator p = phases.begin(); p != phases.end(); ++p){
+		p->start += offset;
+		this->context.profiler.record(*p);
+	}
+	d.time = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+/**
+ * returns the table with the size and the time of each design (in the order they were added),
+ * followed by the totals of the batch
+ */
+string BatchCompiler::statsTable() const{
+	//columns taken from the size statistics of the designs (see Analyzer::getSizeStats)
+	const int columns[] = {0, 1, 2, 6, 3, 4};
+	const char* headers[] = {"inputs", "outputs", "minterms", "crossbars", "memristors", "area"};
+	size_t width = 6;
+	for(vector<design>::const_iterator d = this->designs.begin(); d != this->designs.end(); ++d)
+		width = max(width, d->name.size());
+
+	ostringstream table;
+	table<<left<<setw(width)<<"design"<<right<<setw(8)<<"status";
+	for(int c=0; c<6; c++)
+		table<<setw(12)<<headers[c];
+	table<<setw(12)<<"time(ms)"<<'\n';
+
+	double totals[6] = {0,0,0,0,0,0};
+	double busy = 0;
+	int done = 0;
+	for(vector<design>::const_iterator d = this->designs.begin(); d != this->designs.end(); ++d){
+		table<<left<<setw(width)<<d->name<<right<<setw(8)<<(d->done? "ok" : "failed");
+		for(int c=0; c<6; c++){
+			if(d->done){
+				table<<setw(12)<<(long long)d->stats[columns[c]].second;
+				totals[c] += d->stats[columns[c]].second;
+			}
+			else
+				table<<setw(12)<<"-";
+		}
+		table<<setw(12)<<fixed<<setprecision(1)<<d->time<<'\n';
+		busy += d->time;
+		if(d->done)
+			done++;
+	}
+	table<<left<<setw(width)<<"total"<<right<<setw(8)<<done;
+	for(int c=0; c<6; c++)
+		table<<setw(12)<<(long long)totals[c];
+	table<<setw(12)<<fixed<<setprecision(1)<<busy<<'\n';
+
+	table<<this->designs.size()<<" designs ("<<this->designs.size()-done<<" failed) in "<<this->time<<" ms with "
+			<<this->workers<<" workers: "<<setprecision(2)<<(this->time>0? this->designs.size()*1000.0/this->time : 0)
+			<<" designs/s\n";
+	return table.str();
+}
+
+/**
+ * Prints the statistics table and writes it to 'batch_stat.txt' in the output directory
+ * (and, when the phases are profiled, the JSON report of the batch to 'batch_stat.json').
+ * Returns false if a file can't be written.
+ */
+bool BatchCompiler::printStats(){
+	string table = statsTable();
+	cout<<table;
+	FileWriter out(this->outputDir+"batch_stat.txt");
+	out<<table;
+	bool written = out.close();
+	if(this->context.profiler.isEnabled()){
+		vector< pair<string,double> > stats;
+		int done = 0;
+		for(vector<design>::const_iterator d = this->designs.begin(); d != this->designs.end(); ++d)
+			if(d->done)
+				done++;
+		stats.push_back(make_pair("designs", this->designs.size()));
+		stats.push_back(make_pair("failed", this->designs.size()-done));
+		stats.push_back(make_pair("workers", this->workers));
+		stats.push_back(make_pair("exec_time_ms", this->time));
+		written = this->context.profiler.writeReport(this->outputDir+"batch_stat.json", "batch", stats) && written;
+	}
+	return written;
+}
@@ -0,0 +1,172 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures. 
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * CrossbarCache.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "boundary.h"
+#include "my_utils.h"
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * Constructor: the cache is kept in the directory 'dir' (created if it doesn't exist)
+ */
+CrossbarCache::CrossbarCache(string dir) : dir(dir){
+	if(this->dir.empty() || this->dir[this->dir.size()-1]!='/')
+		this->dir += '/';
+	if(mkdir(this->dir.c_str(),0777)!=0 && errno!=EEXIST)
+		cout<<"WARNING: unable to create the cache directory "<<this->dir<<endl;
+}
+
+/**
+ * returns the key of 'description': its 64-bit FNV-1a hash, in hexadecimal
+ */
+string CrossbarCache::keyOf(const string& description){
+	uint64_t h = 14695981039346656037ULL;
+	for(size_t i=0; i<description.size(); i++){
+		h ^= (unsigned char)description[i];
+		h *= 1099511628211ULL;
+	}
+	char key[17];
+	snprintf(key, sizeof(key), "%016llx", (unsigned long long)h);
+	return key;
+}
+
+/**
+ * reads the whole file 'file' into 'data'
+ */
+static bool readFile(const string& file, string* data){
+	int fd = open(file.c_str(), O_RDONLY);
+	if(fd<0)
+		return false;
+	struct stat info;
+	bool ok = fstat(fd,&info)==0;
+	if(ok){
+		data->resize(info.st_size);
+		size_t done = 0;
+		while(ok && done<data->size()){
+			ssize_t n = ::read(fd, &(*data)[done], data->size()-done);
+			ok = n>0;
+			if(ok)
+				done += n;
+		}
+	}
+	::close(fd);
+	return ok;
+}
+
+/**
+ * writes 'data' to 'file' through a temporary file of the calling thread, renamed at the end
+ */
+bool CrossbarCache::writeFile(const string& file, const string& data) const{
+	ostringstream temp;
+	temp<<file<<".tmp"<<getpid()<<"_"<<this_thread::get_id();
+	int fd = open(temp.str().c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0666);
+	if(fd<0)
+		return false;
+	size_t done = 0;
+	bool ok = true;
+	while(ok && done<data.size()){
+		ssize_t n = ::write(fd, data.data()+done, data.size()-done);
+		ok = n>0;
+		if(ok)
+			done += n;
+	}
+	ok = (::close(fd)==0) && ok;
+	if(ok)
+		ok = rename(temp.str().c_str(), file.c_str())==0;
+	if(!ok)
+		remove(temp.str().c_str());
+	return ok;
+}
+
+/**
+ * Looks for the entry of 'description': if it's there, its data goes to 'payload'.
+ * The entry holds the length of the description, the description and the data.
+ */
+bool CrossbarCache::read(const string& description, string* payload) const{
+	string entry;
+	if(!readFile(this->dir+keyOf(description)+".xbc", &entry))
+		return false;
+	uint64_t length;
+	size_t pos = 0;
+	if(!readBytes(entry, &pos, &length, sizeof(length)) || length!=description.size()
+			|| entry.compare(pos, length, description)!=0)
+		return false;
+	payload->assign(entry, pos+length, string::npos);
+	return true;
+}
+
+/**
+ * stores 'payload' as the entry of 'description'
+ */
+bool CrossbarCache::write(const string& description, const string& payload) const{
+	string entry;
+	uint64_t length = description.size();
+	entry.reserve(sizeof(length)+description.size()+payload.size());
+	appendBytes(&entry, &length, sizeof(length));
+	entry += description;
+	entry += payload;
+	return writeFile(this->dir+keyOf(description)+".xbc", entry);
+}
+
+/**
+ * Copies the cached files of 'key' named 'names' into the directory 'dir' (ending with '/').
+ * Returns false, before copying anything, if one of them isn't in the cache.
+ */
+bool CrossbarCache::restoreFiles(const string& key, const string& dir, const vector<string>& names) const{
+	struct stat info;
+	for(vector<string>::const_iterator n = names.begin(); n != names.end(); ++n)
+		if(stat((this->dir+key+"_"+*n).c_str(),&info)!=0)
+			return false;
+	string data;
+	for(vector<string>::const_iterator n = names.begin(); n != names.end(); ++n){
+		if(!readFile(this->dir+key+"_"+*n, &data))
+			return false;
+		FileWriter out(dir+*n);
+		out<<data;
+		if(!out.close())
+			return false;
+	}
+	return true;
+}
+
+/**
+ * copies the files named 'names' of the directory 'dir' (ending with '/') into the cache, as the files of 'key'
+ */
+void CrossbarCache::storeFiles(const string& key, const string& dir, const vector<string>& names) const{
+	string data;
+	for(vector<string>::const_iterator n = names.begin(); n != names.end(); ++n)
+		if(!readFile(dir+*n, &data) || !writeFile(this->dir+key+"_"+*n, data))
+			return;
+}
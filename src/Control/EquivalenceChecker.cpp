@@ -0,0 +1,375 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures. 
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * EquivalenceChecker.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "sat_solver.h"
+#include "thread_pool.h"
+#include "profiler.h"
+#include <algorithm>
+#include <random>
+
+using namespace std;
+
+const int EquivalenceChecker::simulationWords;
+const int EquivalenceChecker::maxExhaustiveInputs;
+const long EquivalenceChecker::randomVectors;
+const long EquivalenceChecker::conflictBudget;
+
+/**
+ * Constructor: the networks compute signals (symbols lower than 'numSymbols') from 'inputs',
+ * and they're compared on 'outputs'
+ */
+EquivalenceChecker::EquivalenceChecker(vector<symbol> inputs, vector<symbol> outputs, int numSymbols) :
+		numSymbols(numSymbols), inputs(move(inputs)), outputs(move(outputs)), isInput(numSymbols, false),
+		result(equivalent), exhaustive(false), vectors(0), miters(0), failingOutput(0){
+	for(vector<symbol>::const_iterator i = this->inputs.begin(); i != this->inputs.end(); ++i)
+		isInput[*i] = true;
+	for(int s=0; s<2; s++){
+		programs[s].gateOf.assign(numSymbols, -1);
+		programs[s].gateProducts.push_back(0);
+		programs[s].productLiterals.push_back(0);
+	}
+}
+
+/**
+ * Adds to the network 'side' a gate computing the signal 'out': its products are added by addProduct().
+ * Gates are added in order of evaluation (a gate after the gates of its inputs).
+ */
+void EquivalenceChecker::addGate(side s, symbol out){
+	program& p = this->programs[s];
+	p.gateOf[out] = p.gates.size();
+	p.gates.push_back(out);
+	p.gateProducts.push_back(p.gateProducts.back());
+}
+
+/**
+ * Adds a product of 'literals' to the last gate of the network 'side'
+ */
+void EquivalenceChecker::addProduct(side s, const vector<literal>& literals){
+	program& p = this->programs[s];
+	p.literals.insert(p.literals.end(), literals.begin(), literals.end());
+	p.productLiterals.push_back(p.literals.size());
+	p.gateProducts.back()++;
+}
+
+/**
+ * Fills the values of 'inputs' (symbol*words + word) with the block 'block' of 64*words input vectors:
+ * exhaustively, each input is a bit of the index of the vector; otherwise the values are drawn from a generator
+ * seeded with the block, so they don't depend on the jobs
+ */
+void EquivalenceChecker::inputVectors(long block, bool exhaustive, const vector<symbol>& inputs, int words, uint64_t* values){
+	static const uint64_t lanes[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+			0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+	mt19937_64 rng(block);
+	for(size_t k=0; k<inputs.size(); k++){
+		uint64_t* v = &values[(size_t)inputs[k]*words];
+		for(int w=0; w<words; w++){
+			long word = block*words+w;
+			if(!exhaustive)
+				v[w] = rng();
+			else
+				v[w] = k<6? lanes[k] : ((word>>(k-6))&1)!=0? ~0ULL : 0;
+		}
+	}
+}
+
+/**
+ * Checks the networks: simulation first, then (if it isn't exhaustive and it finds no difference) the SAT miters.
+ * Returns 'different' if an output differs (see getFailingOutput() and getCounterexample()), 'undecided'
+ * if some outputs weren't proven within the budget of their miters (see getUndecidedOutputs()).
+ */
+EquivalenceChecker::verdict EquivalenceChecker::check(int jobs){
+	this->miters = 0;
+	this->undecidedOutputs.clear();
+	simulate(jobs);
+	if(this->result==equivalent && !this->exhaustive)
+		prove(jobs);
+	return this->result;
+}
+
+/**
+ * Evaluates the gates of the program 'p' on 'words' words of input vectors: 'values' holds,
+ * for each signal, its words (symbol*words + word)
+ */
+void EquivalenceChecker::evaluate(const program& p, uint64_t* values, int words) const{
+	vector<uint64_t> sum(words), product(words);
+	for(size_t g=0; g<p.gates.size(); g++){
+		fill(sum.begin(), sum.end(), 0);
+		for(int q=p.gateProducts[g]; q<p.gateProducts[g+1]; q++){
+			fill(product.begin(), product.end(), ~0ULL);
+			for(int l=p.productLiterals[q]; l<p.productLiterals[q+1]; l++){
+				const uint64_t* v = &values[(size_t)symbolOf(p.literals[l])*words];
+				uint64_t flip = isNegated(p.literals[l])? ~0ULL : 0;
+				for(int w=0; w<words; w++)
+					product[w] &= v[w]^flip;
+			}
+			for(int w=0; w<words; w++)
+				sum[w] |= product[w];
+		}
+		copy(sum.begin(), sum.end(), &values[(size_t)p.gates[g]*words]);
+	}
+}
+
+/**
+ * Simulates both networks on the block 'block' of 64*simulationWords input vectors.
+ * Returns the index of the first vector for which an output differs (-1 if none): the output
+ * (its index) is returned in 'output' and the vector (the value of each input) in 'failing'.
+ */
+long EquivalenceChecker::simulateBlock(long block, int* output, vector<bool>* failing) const{
+	const int words = simulationWords;
+	vector<uint64_t> values[2];
+	values[reference].assign((size_t)this->numSymbols*words, 0);
+	inputVectors(block, this->exhaustive, this->inputs, words, values[reference].data());
+	values[implementation] = values[reference];
+	evaluate(this->programs[reference], values[reference].data(), words);
+	evaluate(this->programs[implementation], values[implementation].data(), words);
+
+	long first = -1;
+	for(int w=0; w<words && first<0; w++){
+		long base = (block*words+w)*64;
+		uint64_t valid = base>=this->vectors? 0 : this->vectors-base>=64? ~0ULL : (1ULL<<(this->vectors-base))-1;
+		for(size_t k=0; k<this->outputs.size(); k++){
+			size_t o = (size_t)this->outputs[k]*words+w;
+			uint64_t diff = (values[reference][o] ^ values[implementation][o]) & valid;
+			if(diff!=0 && (first<0 || base+__builtin_ctzll(diff)<first)){
+				first = base+__builtin_ctzll(diff);
+				*output = k;
+			}
+		}
+	}
+	if(first>=0){
+		int w = (first/64)%words, bit = first%64;
+		failing->clear();
+		for(size_t k=0; k<this->inputs.size(); k++)
+			failing->push_back(((values[reference][(size_t)this->inputs[k]*words+w]>>bit)&1)!=0);
+	}
+	return first;
+}
+
+/**
+ * Simulates the networks on all the input vectors (up to maxExhaustiveInputs inputs) or on randomVectors of them,
+ * in blocks (on a thread pool with more jobs): the first vector for which an output differs is the counterexample
+ */
+void EquivalenceChecker::simulate(int jobs){
+	PhaseTimer timer("EquivalenceChecker::simulate");
+	this->exhaustive = this->inputs.size()<=maxExhaustiveInputs;
+	this->vectors = this->exhaustive? 1L<<this->inputs.size() : randomVectors;
+	long blocks = (this->vectors+64*simulationWords-1)/(64*simulationWords);
+	vector<long> first(blocks);
+	vector<int> output(blocks);
+	vector< vector<bool> > failing(blocks);
+	auto run = [&](long b){
+		first[b] = simulateBlock(b, &output[b], &failing[b]);
+	};
+	if(jobs>1 && blocks>1){
+		ThreadPool pool(min<long>(jobs,blocks));
+		for(long b=0; b<blocks; b++)
+			pool.submit([&run,b]{run(b);});
+		pool.wait();
+	}
+	else{
+		for(long b=0; b<blocks; b++)
+			run(b);
+	}
+
+	this->result = equivalent;
+	for(long b=0; b<blocks; b++){
+		if(first[b]<0)
+			continue;
+		this->result = different;
+		this->failingOutput = this->outputs[output[b]];
+		this->counterexample = failing[b];
+		return;
+	}
+}
+
+/**
+ * Proves the outputs by SAT miters. First the signals computed by both networks, in order of depth
+ * (in the reference network): the miters of a depth run in parallel, and their cones stop at the signals of the
+ * depths before which were proven equal. Then the outputs not proven this way, each with its whole cone:
+ * their miters give a counterexample, or they're left undecided if their budget is exceeded.
+ */
+void EquivalenceChecker::prove(int jobs){
+	PhaseTimer timer("EquivalenceChecker::prove");
+	const program& r = this->programs[reference];
+	const program& m = this->programs[implementation];
+	vector<int> depth(this->numSymbols, 0);
+	map<int, vector<symbol> > depths;
+	for(size_t g=0; g<r.gates.size(); g++){
+		int d = 0;
+		for(int l=r.productLiterals[r.gateProducts[g]]; l<r.productLiterals[r.gateProducts[g+1]]; l++)
+			d = max(d, depth[symbolOf(r.literals[l])]);
+		depth[r.gates[g]] = d+1;
+		if(m.gateOf[r.gates[g]]>=0)
+			depths[d+1].push_back(r.gates[g]);
+	}
+
+	unique_ptr<ThreadPool> pool(jobs>1? new ThreadPool(jobs) : NULL);
+	auto runAll = [&](size_t n, function<void(size_t)> task){
+		if(pool==NULL){
+			for(size_t i=0; i<n; i++)
+				task(i);
+			return;
+		}
+		for(size_t i=0; i<n; i++)
+			pool->submit([&task,i]{task(i);});
+		pool->wait();
+	};
+
+	vector<bool> proven(this->numSymbols, false);
+	vector<verdict> verdicts;
+	for(map<int, vector<symbol> >::const_iterator d = depths.begin(); d != depths.end(); ++d){
+		const vector<symbol>& signals = d->second;
+		verdicts.assign(signals.size(), undecided);
+		runAll(signals.size(), [&](size_t i){
+			verdicts[i] = miter(signals[i], proven, NULL);
+		});
+		for(size_t i=0; i<signals.size(); i++)
+			proven[signals[i]] = verdicts[i]==equivalent;
+		this->miters += signals.size();
+	}
+
+	vector<size_t> pending;
+	for(size_t k=0; k<this->outputs.size(); k++)
+		if(!proven[this->outputs[k]] && (r.gateOf[this->outputs[k]]>=0 || m.gateOf[this->outputs[k]]>=0))
+			pending.push_back(k);
+	vector<bool> none(this->numSymbols, false);
+	vector< vector<bool> > failing(pending.size());
+	verdicts.assign(pending.size(), undecided);
+	runAll(pending.size(), [&](size_t i){
+		verdicts[i] = miter(this->outputs[pending[i]], none, &failing[i]);
+	});
+	this->miters += pending.size();
+
+	this->result = equivalent;
+	for(size_t i=0; i<pending.size(); i++){
+		if(verdicts[i]==undecided)
+			this->undecidedOutputs.push_back(this->outputs[pending[i]]);
+		if(verdicts[i]==different && this->result!=different){
+			this->result = different;
+			this->failingOutput = this->outputs[pending[i]];
+			this->counterexample = failing[i];
+		}
+	}
+	if(this->result==equivalent && !this->undecidedOutputs.empty())
+		this->result = undecided;
+}
+
+/**
+ * Builds and solves the miter of the signal 's': it's satisfiable if the two networks can give it different values.
+ * The cone of each side is encoded by Tseitin (a variable for each gate and for each product), and it stops at the
+ * primary inputs and at the signals in 'cut', whose variables are shared by both sides.
+ * Returns 'different' if the miter is satisfiable: if 'failing' isn't NULL, it gets the value of each primary input
+ * (which is a counterexample only if 'cut' is empty).
+ */
+EquivalenceChecker::verdict EquivalenceChecker::miter(symbol s, const vector<bool>& cut, vector<bool>* failing) const{
+	SatSolver solver;
+	unordered_map<symbol, int> shared;
+	int zero = -1;	//variable of the signals that neither network computes
+	SatSolver::lit roots[2];
+	vector<SatSolver::lit> clause;
+	for(int side=0; side<2; side++){
+		const program& p = this->programs[side];
+		unordered_map<symbol, int> own;
+		auto variable = [&](symbol t) -> int{
+			unordered_map<symbol, int>::const_iterator i = own.find(t);
+			if(i != own.end())
+				return i->second;
+			if(this->isInput[t] || cut[t]){
+				i = shared.find(t);
+				return i != shared.end()? i->second : shared[t] = solver.newVar();
+			}
+			if(zero<0){
+				zero = solver.newVar();
+				solver.addClause(vector<SatSolver::lit>(1, SatSolver::makeLit(zero, true)));
+			}
+			return zero;
+		};
+
+		//gates of the cone, in order of evaluation
+		vector<int> cone;
+		unordered_set<int> inCone;
+		vector<symbol> stack(1, s);
+		while(!stack.empty()){
+			symbol t = stack.back();
+			stack.pop_back();
+			int g = p.gateOf[t];
+			if(g<0 || (t!=s && cut[t]) || !inCone.insert(g).second)
+				continue;
+			cone.push_back(g);
+			for(int l=p.productLiterals[p.gateProducts[g]]; l<p.productLiterals[p.gateProducts[g+1]]; l++)
+				stack.push_back(symbolOf(p.literals[l]));
+		}
+		sort(cone.begin(), cone.end());
+
+		for(vector<int>::const_iterator g = cone.begin(); g != cone.end(); ++g){
+			int out = solver.newVar();
+			clause.assign(1, SatSolver::makeLit(out, true));
+			for(int q=p.gateProducts[*g]; q<p.gateProducts[*g+1]; q++){
+				SatSolver::lit term;
+				int first = p.productLiterals[q], end = p.productLiterals[q+1];
+				if(end-first==1)
+					term = SatSolver::makeLit(variable(symbolOf(p.literals[first])), isNegated(p.literals[first]));
+				else{
+					//term = AND of the literals
+					term = SatSolver::makeLit(solver.newVar());
+					vector<SatSolver::lit> all(1, term);
+					for(int l=first; l<end; l++){
+						SatSolver::lit x = SatSolver::makeLit(variable(symbolOf(p.literals[l])), isNegated(p.literals[l]));
+						solver.addClause({term^1, x});
+						all.push_back(x^1);
+					}
+					solver.addClause(all);
+				}
+				//out = OR of the terms
+				solver.addClause({SatSolver::makeLit(out), term^1});
+				clause.push_back(term);
+			}
+			solver.addClause(clause);
+			own[p.gates[*g]] = out;
+		}
+		roots[side] = SatSolver::makeLit(variable(s));
+	}
+	solver.addClause({roots[reference], roots[implementation]});
+	solver.addClause({roots[reference]^1, roots[implementation]^1});
+
+	switch(solver.solve(conflictBudget)){
+	case SatSolver::unsatisfiable:
+		return equivalent;
+	case SatSolver::undecided:
+		return undecided;
+	default:
+		break;
+	}
+	if(failing!=NULL){
+		failing->clear();
+		for(size_t k=0; k<this->inputs.size(); k++){
+			unordered_map<symbol, int>::const_iterator i = shared.find(this->inputs[k]);
+			failing->push_back(i != shared.end() && solver.value(i->second));
+		}
+	}
+	return different;
+}
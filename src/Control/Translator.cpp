@@ -26,6 +26,30 @@
  */
 
 #include "control.h"
+#include "my_utils.h"
+#include "profiler.h"
+#include <unordered_map>
+#include <algorithm>
+
+/**
+ * Minimizes the sub-function before its crossbar is generated:
+ * the size of the crossbar it would have had is kept for the statistics
+ * */
+void Translator::minimize(){
+	PhaseTimer timer("Translator::minimize", this->level);
+	int minterms = func.getNumMinterms_NoDuplicate();
+	rowsBeforeMinimization = Crossbar::inputLatchRow+1 + minterms + func.getNumOutput();
+	memristorsBeforeMinimization = func.getNumMemristors();
+	func.minimize();
+
+	if(this->context->options.verbose){
+		verboseLog<<"***MINIMIZATION***"<<endl<<endl;
+		verboseLog<<"minterms: "<<minterms<<" -> "<<func.getNumMinterms_NoDuplicate()<<endl;
+		verboseLog<<"memristors: "<<memristorsBeforeMinimization<<" -> "<<func.getNumMemristors()<<endl;
+		func.printFunction(verboseLog);
+		verboseLog<<endl<<endl<<"***END MINIMIZATION***"<<endl<<endl;
+	}
+}
 
 /**
  * This function creates both column and row indexes (in the Crossbar class) that are links
@@ -33,56 +57,75 @@
  * and row/column nanowires within the crossbar
  * */
 void Translator::create_index(){
-	//create indexes for rows
+	//create indexes for columns (and the literal of each column)
 	int j=0;
-	for(vector<string>::const_iterator i = func.inputs.begin(); i != func.inputs.end(); i++){
+	for(vector<literal>::const_iterator i = func.inputs.begin(); i != func.inputs.end(); i++){
 		this->xbar->columnIndex.insert(make_pair(*i,j));
+		this->xbar->columnLiterals.push_back(*i);
 		j++;
 	}
-	for(vector<string>::const_iterator i = func.outputs.begin(); i != func.outputs.end(); i++){
-		this->xbar->columnIndex.insert(make_pair(*i,j));
+	for(vector<symbol>::const_iterator i = func.outputs.begin(); i != func.outputs.end(); i++){
+		this->xbar->columnIndex.insert(make_pair(makeLiteral(*i),j));
+		this->xbar->columnLiterals.push_back(makeLiteral(*i));
 		j++;
-		this->xbar->columnIndex.insert(make_pair(("not_"+*i),j));
+		this->xbar->columnIndex.insert(make_pair(makeLiteral(*i,true),j));
+		this->xbar->columnLiterals.push_back(makeLiteral(*i,true));
 		j++;
 	}
-	//create indexes for columns
-	j=0;
-	this->xbar->rowIndex.insert(make_pair("IL",j));
-	j++;
-	for(multimap<string,vector<string> >::const_iterator i = func.minterms.begin(); i != func.minterms.end(); ++i) {
-		string v;
-		for(vector<string>::const_iterator k = i->second.begin(); k != i->second.end(); k++) {
-			if(k==i->second.end()-1)
-				v +=*k;
-			else
-				v +=*k+"*";
-		}
-		if(this->xbar->rowIndex.count(v)==0){
-			this->xbar->rowIndex.insert(make_pair(v,j));
+	//create indexes for rows (row 0 is IL): the cubes come by name of their output, then in the order of the file,
+	//and equal cubes share the row of the first one
+	j=Crossbar::inputLatchRow+1;
+	vector<int> first = func.cubes.firstOccurrences();
+	vector<int> order(first.size());
+	for(int c=0; c<(int)order.size(); c++)
+		order[c] = c;
+	if(func.outputs.size()>1){
+		const SymbolTable& symbols = signalTable();
+		stable_sort(order.begin(), order.end(), [this,&symbols](int a, int b){
+			return symbols.name(func.cubeOutputs[a]) < symbols.name(func.cubeOutputs[b]);
+		});
+	}
+	this->xbar->rowIndex.assign(first.size(),0);
+	vector<int> rowCubes;
+	for(vector<int>::const_iterator c = order.begin(); c != order.end(); ++c){
+		if(this->xbar->rowIndex[first[*c]]==0){
+			this->xbar->rowIndex[first[*c]] = j;
+			rowCubes.push_back(first[*c]);
 			j++;
 		}
+		this->xbar->rowIndex[*c] = this->xbar->rowIndex[first[*c]];
 	}
-	for(vector<string>::const_iterator i = func.outputs.begin(); i != func.outputs.end(); i++){
-		this->xbar->rowIndex.insert(make_pair(("not_"+*i),j));
+	for(vector<symbol>::const_iterator i = func.outputs.begin(); i != func.outputs.end(); i++){
+		this->xbar->outputRowIndex.insert(make_pair(*i,j));
 		j++;
 	}
 
-	if(execParameters.verbose){
+	if(this->context->options.verbose){
 		//print indexes
-		cout<<"***CROSSBAR INDEXES***"<<endl<<endl;
+		verboseLog<<"***CROSSBAR INDEXES***"<<endl<<endl;
 
-		cout<<"***ROWS***"<<endl<<endl;
-		for(map<string, int>::const_iterator i = this->xbar->rowIndex.begin(); i != this->xbar->rowIndex.end(); i++)
+		verboseLog<<"***ROWS***"<<endl<<endl;
+		verboseLog<<"IL->"<<Crossbar::inputLatchRow<<endl;
+		vector<literal> literals;
+		for(vector<int>::const_iterator c = rowCubes.begin(); c != rowCubes.end(); c++)
 		{
-			cout<<i->first<<"->"<<i->second<<endl;
+			func.getCubeLiterals(*c,literals);
+			sort(literals.begin(), literals.end());
+			for(vector<literal>::const_iterator k = literals.begin(); k != literals.end(); k++)
+				verboseLog<<(k==literals.begin()? "" : "*")<<signalTable().literalName(*k);
+			verboseLog<<"->"<<this->xbar->rowIndex[*c]<<endl;
 		}
-		cout<<endl<<"***COLUMNS***"<<endl<<endl;
-		for(map<string, int>::const_iterator i = this->xbar->columnIndex.begin(); i != this->xbar->columnIndex.end(); i++)
+		for(map<symbol, int>::const_iterator i = this->xbar->outputRowIndex.begin(); i != this->xbar->outputRowIndex.end(); i++)
 		{
-			cout<<i->first<<"->"<<i->second<<endl;
+			verboseLog<<signalTable().literalName(makeLiteral(i->first,true))<<"->"<<i->second<<endl;
+		}
+		verboseLog<<endl<<"***COLUMNS***"<<endl<<endl;
+		for(map<literal, int>::const_iterator i = this->xbar->columnIndex.begin(); i != this->xbar->columnIndex.end(); i++)
+		{
+			verboseLog<<signalTable().literalName(i->first)<<"->"<<i->second<<endl;
 		}
 
-		cout<<endl<<"***END CROSSBAR INDEXES***"<<endl<<endl;
+		verboseLog<<endl<<"***END CROSSBAR INDEXES***"<<endl<<endl;
 	}
 }
 
@@ -91,51 +134,46 @@ void Translator::create_index(){
  * represent a model of the actual memristor crossbar implementing the sub-function
  * */
 void Translator::generateCrossbar(){
+	PhaseTimer timer("Translator::generateCrossbar", this->level);
 	this->xbar = new Crossbar(this->func.getNumInput(),this->func.getNumOutput(), this->func.getNumMinterms_NoDuplicate());
 	create_index();
 	//generate IL (row 0)
 	for(int i=0; i<this->func.getNumInput();i++){
-		(this->xbar->matrix)[this->xbar->rowIndex.find("IL")->second][i] = 1;
+		this->xbar->matrix.set(Crossbar::inputLatchRow,i,1);
 	}
 
 	//generate minterm rows
-	for(multimap<string,vector<string> >::const_iterator i = this->func.minterms.begin(); i != this->func.minterms.end(); ++i) {
-		//output column name
-		string out = "not_"+i->first;
-
-		//row name
-		string row;
-		for(vector<string>::const_iterator k = i->second.begin(); k != i->second.end(); k++) {
-			if(k==i->second.end()-1)
-				row +=*k;
-			else
-				row +=*k+"*";
-		}
+	vector<literal> literals;
+	for(int c=0; c<this->func.cubes.size(); c++) {
+		//output column (negated output)
+		literal out = makeLiteral(this->func.cubeOutputs[c],true);
+
 		//row num
-		int rowNum = this->xbar->rowIndex.find(row)->second;
+		int rowNum = this->xbar->rowIndex[c];
 
 		//put memristor in (row,out)
-		(this->xbar->matrix)[rowNum][this->xbar->columnIndex.find(out)->second] = 1;
+		this->xbar->matrix.set(rowNum,this->xbar->columnIndex.find(out)->second,1);
 
 
 		//put memristor in (row,inputs)
-		for(vector<string>::const_iterator k = i->second.begin(); k != i->second.end(); k++) {
-			(this->xbar->matrix)[rowNum][this->xbar->columnIndex.find(*k)->second] = 1;
+		this->func.getCubeLiterals(c,literals);
+		for(vector<literal>::const_iterator k = literals.begin(); k != literals.end(); k++) {
+			this->xbar->matrix.set(rowNum,this->xbar->columnIndex.find(*k)->second,1);
 		}
 	}
 
 	//generate outputs rows
 	int i=2;
-	for(string o : this->func.outputs){
-		string o_mod = "not_"+o;
-		(this->xbar->matrix)[this->xbar->rowIndex.find(o_mod)->second][this->xbar->columnIndex.find(o_mod)->second] = 1;
-		(this->xbar->matrix)[this->xbar->rowIndex.find(o_mod)->second][this->xbar->columnIndex.find(o)->second] = i++;
+	for(symbol o : this->func.outputs){
+		int rowNum = this->xbar->outputRowIndex.find(o)->second;
+		this->xbar->matrix.set(rowNum,this->xbar->columnIndex.find(makeLiteral(o,true))->second,1);
+		this->xbar->matrix.set(rowNum,this->xbar->columnIndex.find(makeLiteral(o))->second,i++);
 	}
 
-	if(execParameters.verbose){
-		cout<<"***CROSSBAR***"<<endl<<endl;
-		this->xbar->printMatrix();
-		cout<<endl<<"***END CROSSBAR***"<<endl<<endl;
+	if(this->context->options.verbose){
+		verboseLog<<"***CROSSBAR***"<<endl<<endl;
+		this->xbar->printMatrix(verboseLog);
+		verboseLog<<endl<<"***END CROSSBAR***"<<endl<<endl;
 	}
 }
 
@@ -143,186 +181,233 @@ void Translator::generateCrossbar(){
  * For the object Crossbar, compute, for each state of the FBLC FSM, each nano-wire voltage
  * */
 void Translator::generateVoltages(){
+	PhaseTimer timer("Translator::generateVoltages", this->level);
 
-	//****generate stage INA (reset)****
-	map<string,string> INA;
-
-	//horizontal
-	for(int i=0;i<this->xbar->getHeight();i++)
-		INA.insert(make_pair("XbG_H"+to_string(i),"Vw"));
-
-	//vertical
-	for(int i=0;i<this->xbar->getWidth();i++)
-		INA.insert(make_pair("XbG_V"+to_string(i),"zero"));
-
-	this->xbar->voltages.insert(make_pair("A_INA",INA));
-
-
-	//****generate stage RI (SFC)****
-	map<string,string> RI;
+	//the stages are set wire range by wire range, following the layout of create_index()
+	this->xbar->voltages.generate(this->func.getNumInput(),this->func.getNumOutput());
 
-	//horizontal
-	RI.insert(make_pair("XbG_H0","zero"));
-	for(int i=1;i<this->xbar->getHeight();i++)
-		RI.insert(make_pair("XbG_H"+to_string(i),"Vr"));
-
-	//vertical
-	for(vector<string>::const_iterator i = this->func.inputs.begin(); i!= this->func.inputs.end(); i++)
-		RI.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Z"));
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		RI.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Vr"));
-		RI.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find("not_"+(*i))->second),"Vr"));
+	if(this->context->options.verbose){
+		verboseLog<<"***VOLTAGES***"<<endl<<endl;
+		this->xbar->printVoltages(verboseLog);
+		verboseLog<<endl<<"***END VOLTAGES***"<<endl<<endl;
 	}
+}
 
-	this->xbar->voltages.insert(make_pair("B_RI",RI));
-
-
-	//****generate stage CFM (MFC)****
-	map<string,string> CFM;
-
-	//horizontal
-	CFM.insert(make_pair("XbG_H0","Vw"));
-	for(multimap<string,vector<string> >::const_iterator i = this->func.minterms.begin(); i!= this->func.minterms.end(); i++){
-		string toFind;
-		for(vector<string>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			if(j+1 != i->second.end())
-				toFind+=*j+"*";
-			else
-				toFind+=*j;
-		}
-		CFM.insert(make_pair("XbG_H"+to_string(this->xbar->rowIndex.find(toFind)->second),"zero"));
-	}
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		CFM.insert(make_pair("XbG_H"+to_string(this->xbar->rowIndex.find("not_"+(*i))->second),"Vr"));
-	}
+/**
+ * appends to 's' the length of 'name' and 'name'
+ */
+static void appendName(string* s, const string& name){
+	uint32_t length = name.size();
+	appendBytes(s, &length, sizeof(length));
+	*s += name;
+}
 
-	//vertical
-	for(vector<string>::const_iterator i = this->func.inputs.begin(); i!= this->func.inputs.end(); i++)
-		CFM.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Z"));
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		CFM.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Vr"));
-		CFM.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find("not_"+(*i))->second),"Vr"));
+/**
+ * Canonical description of the sub-function, which doesn't depend on the symbols of this run:
+ * the options which change the crossbar, the names of the variables, the inputs (variable and polarity),
+ * the outputs and the cubes, with the output of each one
+ * */
+string Translator::describe(){
+	string d = "XbarGen crossbar 1";
+	d += this->context->options.minimize? 'm' : '-';
+	unordered_map<symbol,int> variableOf;
+	int count = func.variables.size();
+	appendBytes(&d, &count, sizeof(int));
+	for(int v=0; v<count; v++){
+		variableOf[func.variables[v]] = v;
+		appendName(&d, signalTable().name(func.variables[v]));
 	}
-
-	this->xbar->voltages.insert(make_pair("C_CFM",CFM));
-
-
-	//****generate stage EVM (SFNAND)****
-	map<string,string> EVM;
-
-	//horizontal
-	EVM.insert(make_pair("XbG_H0","Vr"));
-	for(multimap<string,vector<string> >::const_iterator i = this->func.minterms.begin(); i!= this->func.minterms.end(); i++){
-		string toFind;
-		for(vector<string>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			if(j+1 != i->second.end())
-				toFind+=*j+"*";
-			else
-				toFind+=*j;
-		}
-		EVM.insert(make_pair("XbG_H"+to_string(this->xbar->rowIndex.find(toFind)->second),"Z"));
+	count = func.inputs.size();
+	appendBytes(&d, &count, sizeof(int));
+	for(vector<literal>::const_iterator i = func.inputs.begin(); i != func.inputs.end(); ++i){
+		int in = 2*variableOf[symbolOf(*i)] + (isNegated(*i)? 1 : 0);
+		appendBytes(&d, &in, sizeof(int));
 	}
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		EVM.insert(make_pair("XbG_H"+to_string(this->xbar->rowIndex.find("not_"+(*i))->second),"Vr"));
+	unordered_map<symbol,int> outputOf;
+	count = func.outputs.size();
+	appendBytes(&d, &count, sizeof(int));
+	for(int o=0; o<count; o++){
+		outputOf[func.outputs[o]] = o;
+		appendName(&d, signalTable().name(func.outputs[o]));
 	}
-
-	//vertical
-	for(vector<string>::const_iterator i = this->func.inputs.begin(); i!= this->func.inputs.end(); i++)
-		EVM.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Vr"));
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		EVM.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Vr"));
-		EVM.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find("not_"+(*i))->second),"Vw"));
+	count = func.cubes.size();
+	appendBytes(&d, &count, sizeof(int));
+	if(count>0)
+		appendBytes(&d, func.cubes.cube(0), (size_t)count*func.cubes.getNumWords()*sizeof(uint64_t));
+	for(int c=0; c<count; c++){
+		int o = outputOf[func.cubeOutputs[c]];
+		appendBytes(&d, &o, sizeof(int));
 	}
+	return d;
+}
 
-	this->xbar->voltages.insert(make_pair("D_EVM",EVM));
-
+/**
+ * What the VHDL files depend on besides the crossbar: the level, the VHDL names of the signals,
+ * whether the clock is shared and the form of the structure
+ * */
+string Translator::describeFiles(){
+	ostringstream d;
+	d<<this->cacheDescription<<"VHDL "<<level;
+	for(vector<symbol>::const_iterator v = func.variables.begin(); v != func.variables.end(); ++v)
+		d<<' '<<VHDLsintaxFilter(signalTable().name(*v));
+	for(vector<symbol>::const_iterator o = func.outputs.begin(); o != func.outputs.end(); ++o)
+		d<<' '<<VHDLsintaxFilter(signalTable().name(*o));
+	if(this->context->options.sharedClock)
+		d<<" shared-clock";
+	if(this->context->options.sparseStructure)
+		d<<" sparse";
+	return d.str();
+}
 
-	//****generate stage EVR (AND)****
-	map<string,string> EVR;
+/**
+ * names of the VHDL files of the crossbar (see Crossbar::generateVHDLfiles())
+ * */
+vector<string> Translator::VHDLfileNames(){
+	vector<string> names;
+	names.push_back("crossbar_structure_"+to_string(level)+".vhd");
+	names.push_back("crossbar_"+to_string(level)+".vhd");
+	names.push_back("controller_"+to_string(level)+".vhd");
+	return names;
+}
 
-	//horizontal
-	EVR.insert(make_pair("XbG_H0","Vr"));
-	for(multimap<string,vector<string> >::const_iterator i = this->func.minterms.begin(); i!= this->func.minterms.end(); i++){
-		string toFind;
-		for(vector<string>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			if(j+1 != i->second.end())
-				toFind+=*j+"*";
-			else
-				toFind+=*j;
+/**
+ * Looks for the crossbar of the sub-function in the cache (if the cache is enabled): if it's there,
+ * the minimized cubes (with minimization), the matrix and the voltages are taken from it and true is returned,
+ * otherwise generateCrossbar() and generateVoltages() have to be called (minimize() before them).
+ * The indexes aren't cached: they follow from the sub-function.
+ * */
+bool Translator::loadFromCache(){
+	if(this->context->options.cacheDir.empty())
+		return false;
+	PhaseTimer timer("Translator::loadFromCache", this->level);
+	this->cacheDescription = describe();
+	string payload;
+	if(!CrossbarCache(this->context->options.cacheDir).read(this->cacheDescription, &payload))
+		return false;
+
+	//the entry is checked as a whole before anything is changed
+	size_t pos = 0;
+	int rows, memristors;
+	if(!readBytes(payload, &pos, &rows, sizeof(int)) || !readBytes(payload, &pos, &memristors, sizeof(int)))
+		return false;
+	bool minimized = this->context->options.minimize;
+	CubeSet cubes(func.cubes.getNumVars());
+	vector<symbol> cubeOutputs;
+	int numMinterms = func.getNumMinterms_NoDuplicate();
+	if(minimized){
+		int numCubes;
+		if(!readBytes(payload, &pos, &numCubes, sizeof(int)) || numCubes<0)
+			return false;
+		vector<uint64_t> words(cubes.getNumWords());
+		for(int c=0; c<numCubes; c++){
+			if(!readBytes(payload, &pos, words.data(), words.size()*sizeof(uint64_t)))
+				return false;
+			cubes.addCube(words.data());
 		}
-		EVR.insert(make_pair("XbG_H"+to_string(this->xbar->rowIndex.find(toFind)->second),"Vw"));
-	}
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		EVR.insert(make_pair("XbG_H"+to_string(this->xbar->rowIndex.find("not_"+(*i))->second),"zero"));
+		for(int c=0; c<numCubes; c++){
+			int o;
+			if(!readBytes(payload, &pos, &o, sizeof(int)) || o<0 || o>=func.getNumOutput())
+				return false;
+			cubeOutputs.push_back(func.outputs[o]);
+		}
+		vector<int> first = cubes.firstOccurrences();
+		numMinterms = 0;
+		for(int c=0; c<(int)first.size(); c++)
+			if(first[c]==c)
+				numMinterms++;
 	}
-
-	//vertical
-	for(vector<string>::const_iterator i = this->func.inputs.begin(); i!= this->func.inputs.end(); i++)
-		EVR.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Vr"));
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		EVR.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Vr"));
-		EVR.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find("not_"+(*i))->second),"Z"));
+	Crossbar* cached = new Crossbar(func.getNumInput(), func.getNumOutput(), numMinterms);
+	int height = cached->getHeight(), width = cached->getWidth();
+	if(!cached->matrix.deserialize(payload, &pos) || (int)cached->getHeight()!=height || (int)cached->getWidth()!=width
+			|| !cached->voltages.deserialize(payload, &pos) || pos!=payload.size()){
+		delete cached;
+		return false;
 	}
 
-	this->xbar->voltages.insert(make_pair("E_EVR",EVR));
-
-
-	//****generate stage INR (INV)****
-	map<string,string> INR;
-
-	//horizontal
-	INR.insert(make_pair("XbG_H0","Vr"));
-	for(multimap<string,vector<string> >::const_iterator i = this->func.minterms.begin(); i!= this->func.minterms.end(); i++){
-		string toFind;
-		for(vector<string>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			if(j+1 != i->second.end())
-				toFind+=*j+"*";
-			else
-				toFind+=*j;
+	if(minimized){
+		int minterms = func.getNumMinterms_NoDuplicate();
+		rowsBeforeMinimization = rows;
+		memristorsBeforeMinimization = memristors;
+		//the minimized cubes are the same when the minimization didn't pay off: then the minterms are kept as they are
+		bool same = cubes.size()==func.cubes.size() && cubeOutputs==func.cubeOutputs && (cubes.size()==0
+				|| equal(cubes.cube(0), cubes.cube(0)+(size_t)cubes.size()*cubes.getNumWords(), func.cubes.cube(0)));
+		if(!same)
+			func.setCubes(move(cubes), move(cubeOutputs));
+		if(this->context->options.verbose){
+			verboseLog<<"***MINIMIZATION***"<<endl<<endl;
+			verboseLog<<"minterms: "<<minterms<<" -> "<<func.getNumMinterms_NoDuplicate()<<endl;
+			verboseLog<<"memristors: "<<memristorsBeforeMinimization<<" -> "<<func.getNumMemristors()<<endl;
+			func.printFunction(verboseLog);
+			verboseLog<<endl<<endl<<"***END MINIMIZATION***"<<endl<<endl;
 		}
-		INR.insert(make_pair("XbG_H"+to_string(this->xbar->rowIndex.find(toFind)->second),"Vr"));
 	}
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		INR.insert(make_pair("XbG_H"+to_string(this->xbar->rowIndex.find("not_"+(*i))->second),"Z"));
-	}
-
-	//vertical
-	for(vector<string>::const_iterator i = this->func.inputs.begin(); i!= this->func.inputs.end(); i++)
-		INR.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Vr"));
-	for(vector<string>::const_iterator i = this->func.outputs.begin(); i!= this->func.outputs.end(); i++){
-		INR.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find(*i)->second),"Vw"));
-		INR.insert(make_pair("XbG_V"+to_string(this->xbar->columnIndex.find("not_"+(*i))->second),"Vr"));
+	this->xbar = cached;
+	create_index();
+	if(this->context->options.verbose){
+		verboseLog<<"***CROSSBAR***"<<endl<<endl;
+		this->xbar->printMatrix(verboseLog);
+		verboseLog<<endl<<"***END CROSSBAR***"<<endl<<endl;
+		verboseLog<<"***VOLTAGES***"<<endl<<endl;
+		this->xbar->printVoltages(verboseLog);
+		verboseLog<<endl<<"***END VOLTAGES***"<<endl<<endl;
 	}
+	this->crossbarFromCache = true;
+	return true;
+}
 
-	this->xbar->voltages.insert(make_pair("F_INR",INR));
-
-	if(execParameters.verbose){
-		cout<<"***VOLTAGES***"<<endl<<endl;
-		this->xbar->printVoltages();
-		cout<<endl<<"***END VOLTAGES***"<<endl<<endl;
+/**
+ * stores in the cache (if it's enabled) the crossbar just generated, after loadFromCache() didn't find it
+ * */
+void Translator::storeInCache(){
+	if(this->context->options.cacheDir.empty() || this->xbar==NULL)
+		return;
+	PhaseTimer timer("Translator::storeInCache", this->level);
+	string payload;
+	appendBytes(&payload, &rowsBeforeMinimization, sizeof(int));
+	appendBytes(&payload, &memristorsBeforeMinimization, sizeof(int));
+	if(this->context->options.minimize){
+		int numCubes = func.cubes.size();
+		appendBytes(&payload, &numCubes, sizeof(int));
+		if(numCubes>0)
+			appendBytes(&payload, func.cubes.cube(0), (size_t)numCubes*func.cubes.getNumWords()*sizeof(uint64_t));
+		for(int c=0; c<numCubes; c++){
+			int o = find(func.outputs.begin(), func.outputs.end(), func.cubeOutputs[c]) - func.outputs.begin();
+			appendBytes(&payload, &o, sizeof(int));
+		}
 	}
+	this->xbar->matrix.serialize(&payload);
+	this->xbar->voltages.serialize(&payload);
+	if(!CrossbarCache(this->context->options.cacheDir).write(this->cacheDescription, payload))
+		cout<<"WARNING: unable to write the crossbar of level "<<level<<" in the cache"<<endl;
 }
 
 /**
  * this procedure generates VHDL version of the assigned Crossbar invoking the corresponding
- * function on the managed Crossbar object
+ * function on the managed Crossbar object (or takes the files from the cache, if they're there)
  * */
 void Translator::generateOutputVHDL(){
-	this->xbar->generateVHDLfiles(level,func.inputs,func.outputs);
+	PhaseTimer timer("Translator::generateOutputVHDL", this->level);
+	if(this->context->options.cacheDir.empty()){
+		this->xbar->generateVHDLfiles(outputDir,level,func.inputs,func.outputs,this->context->options.sharedClock,
+				this->context->options.sparseStructure);
+		return;
+	}
+	CrossbarCache cache(this->context->options.cacheDir);
+	string key = CrossbarCache::keyOf(describeFiles());
+	vector<string> names = VHDLfileNames();
+	this->filesFromCache = cache.restoreFiles(key,outputDir,names);
+	if(!this->filesFromCache){
+		this->xbar->generateVHDLfiles(outputDir,level,func.inputs,func.outputs,this->context->options.sharedClock,
+				this->context->options.sparseStructure);
+		cache.storeFiles(key,outputDir,names);
+	}
 }
 
 /**
- * retrieves the number of minterms of the assigned sub-function
+ * retrieves the number of memristors of the assigned Crossbar
  * */
 int Translator::getNumMemristor(){
-	int n=0;
-	for(vector< vector<int> >::const_iterator i = (this->xbar->matrix).begin(); i!= (this->xbar->matrix).end(); i++){
-		for(vector<int>::const_iterator j = i->begin(); j!= i->end(); j++){
-			if(*j!=0)
-				n++;
-		}
-	}
-	return n;
+	return this->xbar->matrix.count();
 }
 
 /**
@@ -333,122 +418,25 @@ int Translator::getArea(){
 }
 
 /**
- * retrieves the power consumption estimation for memristors which are dependent on workload
+ * retrieves the switching activity of the operative memristors, which depends on workload:
+ * exact for the sub-functions with few variables, found by a local search for the others
  * */
-int* Translator::getOperativeMemristorPowerConsumption(){
-
-	struct literal{
-		string name;
-		bool check;
-		int qta;
-	};
-
-	unordered_map<string,pair< literal*,literal*> > pointers;
-
-	//create 2 lists: input in negative and positive forms -- UNUSED
-	multimap<int, literal* > orderedLiteralCount;
-	multimap<int, literal* > orderedLiteralCountNegate;
-
-	for(map<string,int>::const_iterator i = this->func.literalCount.begin(); i != this->func.literalCount.end();i++){
-
-		literal *l = new literal;
-		l->name=(*i).first;l->check=false;l->qta=(*i).second;
-
-		unordered_map<string,pair< literal*,literal*> >::iterator it;
-
-		if((*i).first.find("not", 0, 3)!=string::npos){
-			it = pointers.find(l->name.substr(4,string::npos ));
-			orderedLiteralCountNegate.insert(pair<int, literal*>((*i).second,l));
-			if(it == pointers.end())
-				pointers.insert(pair <string,pair< literal*,literal*> > ( l->name.substr(4,string::npos ),pair<literal*,literal*>(NULL,l)));
-			else
-				(*it).second.second = l;
-		}
-		else{
-			it = pointers.find(l->name);
-			orderedLiteralCount.insert(pair<int, literal*>((*i).second,l));
-			if(it == pointers.end())
-				pointers.insert(pair <string,pair< literal*,literal*> > ( l->name,pair<literal*,literal*>(l,NULL)));
-			else
-				(*it).second.first = l;
-		}
-	}
-	/*now we have 2 lists with the number of occurrence of each literal in the crossbar
-	 * we have to select the input vector that make switch the biggest(smallest) number of memristors -- UNUSED*/
-
-	/*NmNandMax is the max number of NAND memristors that could be switched at the same time using a specific input vector*/
-	/*NmNandMin is the min number of NAND memristors that could be switched at the same time using a specific input vector*/
-	int NmNandMax = 0;
-	int NmNandMin = 0;
-	set<string> notchecked;
-	set<string> checked;
-	for(vector<string>::const_iterator i = this->func.inputs.begin(); i != this->func.inputs.end(); i++){
-
-		string lpos, lneg;
-		//found a negation of a literal
-		if((*i).find("not", 0, 3)!=string::npos){
-			//create its 'positive'
-			lpos = (*i).substr(4,string::npos);
-			lneg = (*i);
-		}
-		else{
-			lpos = (*i);
-			lneg = "not_" + (*i);
-		}
-		//if the occurrences of the negative form are more than the ones of the positive, take it
-		if(this->func.literalCount[lneg] > this->func.literalCount[lpos]){
-			pair<set<string>::iterator,bool> result = notchecked.insert(lpos);
-			checked.insert(lneg);
-			if(result.second){
-				NmNandMax += this->func.literalCount[lneg];
-				NmNandMin += this->func.literalCount[lpos];
-				if(pointers[lneg].second)
-					pointers[lneg].second->check = true;
-			}
-		}
-		//otherwise, take the positive one
-		else{
-			pair<set<string>::iterator,bool> result = notchecked.insert(lneg);
-			checked.insert(lpos);
-			if(result.second){
-				NmNandMax += this->func.literalCount[lpos];
-				NmNandMin += this->func.literalCount[lneg];
-				if(pointers[lpos].second)
-					pointers[lpos].second->check = true;
-			}
-		}
-	}
-
-	/*since a 'selected' inputs are set as '0' and since the NAND operation gives '0' only if takes all 1s as input
-	 * we stored unselected inputs (set as '1') in order to check if there is any minterm that contains all of them.
-	 * if some minterms satisfy these conditions, they give 0 as output (so they're considered as 'commutations' -> powerCons)
-	 * those who are
-	 * */
-	int NmAndWorst = 0, NmAndWorstError = 0, NmAndBest = 0;
-	for(multimap<string,vector<string> >::const_iterator i = this->func.minterms.begin(); i != this->func.minterms.end();i++){
-		bool foundWorst = true;
-		bool foundBest = true;
-		for(vector<string>::const_iterator j = (*i).second.begin(); j != (*i).second.end();j++){
-			if(find(notchecked.begin(), notchecked.end(), *j) == notchecked.end() && foundWorst == true){
-				foundWorst = false;
-				NmAndWorstError++;
-			}
-			if(find(checked.begin(), checked.end(), *j) == checked.end() && foundBest == true)
-				foundBest = false;
-
-			if(!foundWorst && !foundBest)
-				break;
-		}
-		if(foundWorst)
-			NmAndWorst++;
-		if(foundBest)
-			NmAndBest++;
-	}
+SwitchingActivity Translator::getSwitchingActivity(){
+	return this->func.switchingActivity(this->context->options.jobs);
+}
 
-	int* toRet = new int[4];
-	toRet[0] = NmNandMax + NmAndWorst;
-	toRet[1] = NmNandMin + NmAndBest;
-	toRet[2] = NmAndWorstError;
-	toRet[3] = NmAndBest;
-	return toRet;
+/**
+ * retrieves the crossbar size before and after the minimization: rows before, rows after,
+ * columns, memristors before, memristors after (empty if the sub-function wasn't minimized)
+ * */
+vector<int> Translator::getMinimizationStats(){
+	vector<int> sizes;
+	if(rowsBeforeMinimization<0)
+		return sizes;
+	sizes.push_back(rowsBeforeMinimization);
+	sizes.push_back(this->xbar->getHeight());
+	sizes.push_back(this->xbar->getWidth());
+	sizes.push_back(memristorsBeforeMinimization);
+	sizes.push_back(getNumMemristor());
+	return sizes;
 }
@@ -0,0 +1,199 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures. 
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * XbarGenContext.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "control.h"
+#include "my_utils.h"
+#include <iostream>
+#include <cerrno>
+#include <sys/stat.h>
+
+using namespace std;
+
+//context of the threads which didn't select one
+static XbarGenContext processContext;
+static thread_local XbarGenContext* threadContext = NULL;
+
+/**
+ * returns the context of the calling thread
+ */
+XbarGenContext& currentContext(){
+	return threadContext!=NULL? *threadContext : processContext;
+}
+
+ContextScope::ContextScope(XbarGenContext& context) : previous(threadContext){
+	threadContext = &context;
+}
+
+ContextScope::~ContextScope(){
+	threadContext = this->previous;
+}
+
+SymbolTable& signalTable(){
+	return currentContext().getSymbols();
+}
+
+string VHDLsintaxFilter(string s){
+	return currentContext().VHDLsintaxFilter(s);
+}
+
+/**
+ * Synthesizes the circuit of the EQN file 'file' in the directory 'outputDir' (ending with '/'):
+ * its crossbars and, if the options demand them, the dot files, the VHDL files and the statistics.
+ * Each call starts from an empty symbol table, so the result doesn't depend on the previous calls.
+ * The directory is created once the file is read, so unreadable files leave nothing behind.
+ * If 'stats' isn't NULL, it gets the size statistics of the crossbars.
+ * Returns false if the file can't be read, if the circuit has a combinational cycle, if the simulation
+ * of its crossbars (when demanded) gives a wrong output or if they don't compute the function of the file
+ * (when the check is demanded).
+ */
+bool XbarGenContext::compile(string file, string outputDir, vector< pair<string,double> >* stats){
+	ContextScope scope(*this);
+	this->symbols = SymbolTable();
+	Analyzer an(file, outputDir);
+
+	//the analyzer extracts a model of the input function
+	if(!an.analyzeFunctionFromEQN())
+		return false;
+	if(mkdir(outputDir.c_str(),0777)!=0 && errno!=EEXIST){
+		cout<<"ERROR: unable to create the directory "<<outputDir<<endl;
+		return false;
+	}
+
+	//the analyzer explores the function's subsets
+	if(!an.createDependenciesGraph())
+		return false;
+
+	//for each subset, the analyzer generates the corresponding crossbar
+	an.generateCrossbar();
+
+	//if user wants the crossbars checked against their sub-functions
+	bool simulated = !this->options.simulate || an.simulateCrossbars();
+	//if user wants the crossbars checked against the function of the file
+	bool verified = !this->options.verify || an.verifyEquivalence();
+
+	//if user wants the vhdl implementation of the circuit
+	if(this->options.vhdl){
+		if(!hasVHDLReservedWords() && !loadVHDLReservedWords())
+			cout<<"WARNING: VHDL reserved words are not loaded\n";
+		//generate the VHDL output
+		an.generateOutputVHDL();
+	}
+	//if user wants statistics
+	if(this->options.stat)
+		//print out statistics
+		an.printOutputStats();
+	if(stats!=NULL)
+		*stats = an.getSizeStats();
+	return simulated && verified;
+}
+
+/**
+ * load the VHDL 'reserved keywords' from 'file' (a word per line).
+ * The words are kept even if the file can't be read (no words), so they're looked for once.
+ */
+bool XbarGenContext::loadVHDLReservedWords(string file){
+	unordered_set<string>* words = new unordered_set<string>();
+	this->reservedWords.reset(words);
+	string line;
+	ifstream myfile(file.c_str());
+	if (myfile.is_open())
+	{
+		while ( getline (myfile,line) )
+		{
+			words->insert(trim(line));
+		}
+		myfile.close();
+		return true;
+	}
+	else cout << "Unable to open file";
+	return false;
+}
+
+/**
+ * uses the VHDL reserved words of 'context' (without reading them again)
+ */
+void XbarGenContext::shareVHDLReservedWords(const XbarGenContext& context){
+	this->reservedWords = context.reservedWords;
+}
+
+/**
+ * starting from a string 's', expected to be a VHDL name (e.g. instance of a signal), returns its 'clean' version
+ * (not allowed characters and names are deleted or replaced).
+ * The VHDL files of the levels can be written concurrently, and they share the filtered names.
+ */
+string XbarGenContext::VHDLsintaxFilter(string s){
+	lock_guard<mutex> g(this->filterLock);
+	if(this->filteredNames.find(s) != this->filteredNames.end()){
+		s = this->filteredNames.find(s)->second;
+	}
+	else{
+		string initial = s;
+		while(s.find("[")!= std::string::npos){
+			s.replace(s.find("["),1,"_");
+		}
+		while(s.find("]")!= std::string::npos){
+			s.replace(s.find("]"),1,"_");
+		}
+		while(s.find("<")!= std::string::npos){
+			s.replace(s.find("<"),1,"_");
+		}
+		while(s.find(">")!= std::string::npos){
+			s.replace(s.find(">"),1,"_");
+		}
+		while(s.find(".")!= std::string::npos){
+			s.replace(s.find("."),1,"_");
+		}
+		while(s.find("__")!= std::string::npos){
+			s.replace(s.find("__"),2,"_");
+		}
+		while(s.back()=='_' || s.front()=='_' || s.front()=='-'|| isdigit(s.front())){
+			if(s.back()=='_'){
+				s.erase(--s.end());
+			}
+			if(s.front()=='_'){
+				s.erase(s.begin());
+			}
+			if(s.front()=='-'){
+				s.erase(s.begin());
+			}
+			while(isdigit(s.front())){
+				s.erase(s.begin());
+			}
+		}
+		if(this->reservedWords!=nullptr && !this->reservedWords->empty()){
+			if(this->reservedWords->find(s) != this->reservedWords->end())
+				s = "XbG_" + s;
+		}
+
+		if(s.empty()){
+			//get a 7 random character string (lowercase)
+			for (int i=0;i<7;i++)
+				s += rand() % 25 + 97;
+		}
+		this->filteredNames.insert(make_pair(initial,s));
+	}
+	return s;
+}
@@ -26,82 +26,130 @@
  */
 
 #include "entities.h"
+#include "boundary.h"
+#include <my_utils.h>
 #include <iostream>
 #include <cstdlib>
-#include <fstream>
 #include <array>
 using namespace std;
 
 /**
  * Constructor with parameters. Initializes the memristor matrix with 0 values
  * */
-Crossbar::Crossbar(int numInput, int numOutput, int numMinterms) : numMemristors(0){
-	for(int i=0; i<(1+numMinterms+numOutput);i++){
-		vector<int> v;
-		for(int j=0; j<(numInput+(numOutput*2));j++){
-			v.push_back(0);
-		}
-		this->matrix.push_back(v);
-	}
+Crossbar::Crossbar(int numInput, int numOutput, int numMinterms) :
+		matrix(1+numMinterms+numOutput, numInput+(numOutput*2)),
+		voltages(1+numMinterms+numOutput, numInput+(numOutput*2)){
+}
+
+Crossbar::~Crossbar(){
 }
 
 /**
- * Prints out the matrix through the std output
+ * Prints out the matrix through the given stream (std output by default)
  * */
-void Crossbar::printMatrix(){
-	for(vector< vector<int> >::iterator i = this->matrix.begin(); i != this->matrix.end(); i++){
-		for(vector<int>::iterator j = i->begin(); j != i->end(); j++){
-			cout<<*j<<"\t";
+void Crossbar::printMatrix(ostream& out){
+	for(int i=0; i<this->matrix.getHeight(); i++){
+		for(int j=0; j<this->matrix.getWidth(); j++){
+			out<<this->matrix.get(i,j)<<"\t";
 		}
-		cout<<endl;
+		out<<endl;
 	}
 }
 
 /**
- * Prints out the voltages for each nanowire, for each stage
+ * Prints out the voltages for each nanowire, for each stage, through the given stream (std output by default)
  * */
-void Crossbar::printVoltages(){
-	for(map< string, map<string,string> >::iterator i = this->voltages.begin(); i != this->voltages.end(); i++){
-		cout<<"Stage "<<i->first<<":"<<endl;
-		for(map<string,string>::iterator j = i->second.begin(); j != i->second.end(); j++){
-			cout<<j->first<<"="<<j->second<<endl;
+void Crossbar::printVoltages(ostream& out){
+	this->voltages.print(out);
+}
+
+/**
+ * Reads back, from the memristors of the matrix, the two-level function the crossbar computes:
+ * - an output is found by its memristor (tagged 2+output), in its row and in its positive column
+ * - each other row (but IL) is a product of the literals of the input columns with a memristor, and it's
+ * 		a minterm of each output which has a memristor in its negated column
+ * Nothing is taken from the sub-function the crossbar was built from.
+ * */
+Function Crossbar::readFunction() const{
+	Function f;
+	int numInputs = this->matrix.getWidth();
+	vector<bool> outputRow(this->matrix.getHeight(), false);
+	map<int, symbol> outputs;	//tag of each output, and the output
+	vector<int> outputOfColumn(this->matrix.getWidth(), -1);	//negated column of each output
+	for(CrossbarMatrix::const_iterator i = this->matrix.begin(); i != this->matrix.end(); ++i){
+		CrossbarMatrix::cell c = *i;
+		if(c.value<2)
+			continue;
+		outputs[c.value] = symbolOf(this->columnLiterals[c.column]);
+		outputRow[c.row] = true;
+		outputOfColumn[c.column+1] = c.value;
+		numInputs = min(numInputs, c.column);
+	}
+	for(int c=0; c<numInputs; c++)
+		f.addInput(this->columnLiterals[c]);
+	for(map<int, symbol>::const_iterator o = outputs.begin(); o != outputs.end(); ++o)
+		f.addOutput(o->second);
+
+	vector<literal> literals;
+	vector<int> tags;
+	CrossbarMatrix::const_iterator i = this->matrix.begin();
+	while(i != this->matrix.end()){
+		int row = (*i).row;
+		literals.clear();
+		tags.clear();
+		for(; i != this->matrix.end() && (*i).row==row; ++i){
+			CrossbarMatrix::cell c = *i;
+			if(c.column<numInputs)
+				literals.push_back(this->columnLiterals[c.column]);
+			else if(outputOfColumn[c.column]>=0)
+				tags.push_back(outputOfColumn[c.column]);
 		}
-		cout<<endl;
+		if(row==inputLatchRow || outputRow[row])
+			continue;
+		for(vector<int>::const_iterator t = tags.begin(); t != tags.end(); ++t)
+			f.addMinterm(outputs[*t], literals);
 	}
+	return f;
 }
 
 /**
- * This procedure generates VHDL version of the whole sub-Crossbar
+ * This procedure generates VHDL version of the whole sub-Crossbar, in the directory 'dir'.
+ * With 'sharedClock', the memristors and the controller don't have their own clock: they take it
+ * from the 'XbG_clk' port of the controller (see the *_shared_clock models in memristorModel/):
+ * the XbG_ prefix keeps it apart from the signals of the circuit.
+ * With 'sparse', the structure is the list of the memristors instead of the whole matrix.
  * */
-void Crossbar::generateVHDLfiles(int level,vector<string> inputs, vector<string> outputs){
-	generateCrossbarStructureFile(level);
-	generateCrossbarFile(level,outputs.size());
-	generateCrossbarControllerFile(level,inputs,outputs);
+void Crossbar::generateVHDLfiles(const string& dir,int level,vector<literal> inputs, vector<symbol> outputs, bool sharedClock, bool sparse){
+	generateCrossbarStructureFile(dir,level,sparse);
+	generateCrossbarFile(dir,level,outputs.size(),sharedClock,sparse);
+	generateCrossbarControllerFile(dir,level,inputs,outputs,sharedClock);
 }
 
 /**
  * This procedure generates the Crossbar's implementation VHDL file
  * */
-void Crossbar::generateCrossbarFile(int level,int outSize){
-	std::ofstream out(string("./crossbar_"+to_string(level)+".vhd").c_str());
-	std::streambuf *coutbuf = std::cout.rdbuf(); //save old buf
-	std::cout.rdbuf(out.rdbuf()); //redirect std::cout
+void Crossbar::generateCrossbarFile(const string& dir,int level,int outSize,bool sharedClock,bool sparse){
+	FileWriter out(dir+"crossbar_"+to_string(level)+".vhd");
+	string model = sharedClock? "Memristor_behavioral_Snider_shared_clock" : "Memristor_behavioral_Snider_internal_clock";
+	const char* clockPort = sharedClock? "clk : IN std_logic;\n" : "";	//the port of the memristor models
+	const char* clockMap = sharedClock? "clk => XbG_clk,\n" : "";
 
 
-	cout<<"----------------------------------------------------------------------------------\n"
+	out<<"----------------------------------------------------------------------------------\n"
 			"-- Engineer: 		Marcello Traiola\n"
 			"--\n"
 			"-- Create Date: ";
 	time_t t = time(0);   // get time now
-	struct tm * now = localtime( & t );
-	cout << (now->tm_hour) << ':'
+	struct tm date;
+	struct tm * now = localtime_r( & t, & date );	//levels can be written concurrently
+	out << (now->tm_hour) << ':'
 			<< (now->tm_min) << ':'
 			<< (now->tm_sec) << ' '
 			<<(now->tm_mday) << '/'
 			<< (now->tm_mon + 1) << '/'
 			<< (now->tm_year + 1900)
-			<< endl;
-	cout<<
+			<< '\n';
+	out<<
 			"-- Design Name: \n"
 			"-- Module Name: \n"
 			"-- Project Name: \n"
@@ -119,6 +167,7 @@ void Crossbar::generateCrossbarFile(int level,int outSize){
 			"\n"
 			"entity "<<string("crossbar_"+to_string(level)).c_str()<<" is\n"
 			"Port (\n"
+			<<(sharedClock? "XbG_clk : in  STD_LOGIC;\n" : "")<<
 			"Vpos : in  voltage_vector (0 to cb_width-1);\n"
 			"Vneg : in  voltage_vector (0 to cb_height-1);\n"
 			//			"output : out word\n"
@@ -128,16 +177,18 @@ void Crossbar::generateCrossbarFile(int level,int outSize){
 			"\n"
 			"architecture Behavioral of "<<string("crossbar_"+to_string(level)).c_str()<<" is\n"
 			"\n"
-			"COMPONENT Memristor_behavioral_Snider_internal_clock\n"
+			"COMPONENT "<<model<<"\n"
 			"PORT(\n"
+			<<clockPort<<
 			"Vpos : INOUT voltage;\n"
 			"Vneg : INOUT voltage;\n"
 			"Rout : OUT std_logic\n"
 			");\n"
 			"END COMPONENT;\n"
 			"\n"
-			"COMPONENT Memristor_behavioral_Snider_internal_clock_noOutput\n"
+			"COMPONENT "<<model<<"_noOutput\n"
 			"PORT(\n"
+			<<clockPort<<
 			"Vpos : INOUT voltage;\n"
 			"Vneg : INOUT voltage\n"
 			");\n"
@@ -149,20 +200,50 @@ void Crossbar::generateCrossbarFile(int level,int outSize){
 			"begin\n"
 			"\n"
 			"verticalWires <= Vpos;\n"
-			"horizontalWires <= Vneg;\n"
+			"horizontalWires <= Vneg;\n";
+	if(sparse){
+		//a memristor for each site of the list
+		out<<
+				"memristori : for k in 0 to cb_sites-1 generate\n"
+				"\n"
+				"check: if (cb_structure(k).tag=1) generate\n"
+				"memristor_riga : "<<model<<"_noOutput PORT MAP(\n"
+				<<clockMap<<
+				"Vpos => verticalWires(cb_structure(k).col),\n"
+				"Vneg => horizontalWires(cb_structure(k).row)\n"
+				");\n"
+				"end generate check;\n"
+				"\n"
+				"check_output: if (cb_structure(k).tag>1) generate\n"
+				"memristor_riga : "<<model<<" PORT MAP(\n"
+				<<clockMap<<
+				"Vpos => verticalWires(cb_structure(k).col),\n"
+				"Vneg => horizontalWires(cb_structure(k).row),\n"
+				"Rout => output(cb_structure(k).tag-2)\n"
+				");\n"
+				"end generate check_output;\n"
+				"\n"
+				"end generate memristori;\n"
+				"\n"
+				"end Behavioral;\n";
+		return;
+	}
+	out<<
 			"righe : for i in cb_height-1 downto 0 generate\n"
 			"\n"
 			"colonne : for j in cb_width-1 downto 0 generate\n"
 			"\n"
 			"check: if (cb_structure(i)(j)=1) generate\n"
-			"memristor_riga : Memristor_behavioral_Snider_internal_clock_noOutput PORT MAP(\n"
+			"memristor_riga : "<<model<<"_noOutput PORT MAP(\n"
+			<<clockMap<<
 			"Vpos => verticalWires(j),\n"
 			"Vneg => horizontalWires(i)\n"
 			");\n"
 			"end generate check;\n"
 			"\n"
 			"check_output: if (cb_structure(i)(j)>1) generate\n"
-			"memristor_riga : Memristor_behavioral_Snider_internal_clock PORT MAP(\n"
+			"memristor_riga : "<<model<<" PORT MAP(\n"
+			<<clockMap<<
 			"Vpos => verticalWires(j),\n"
 			"Vneg => horizontalWires(i),\n"
 			"Rout => output(cb_structure(i)(j)-2)\n"
@@ -178,20 +259,19 @@ void Crossbar::generateCrossbarFile(int level,int outSize){
 			"end generate righe;\n"
 			"\n"
 			"end Behavioral;\n";
-	std::cout.rdbuf(coutbuf); //reset to standard output again
 
 }
 
 /**
- * This procedure generates the Crossbar's structure VHDL file
+ * This procedure generates the Crossbar's structure VHDL file: the matrix of the cells (0 if there isn't
+ * a memristor, 1 or the tag of an output memristor) or, if 'sparse', the list of the memristors
+ * (row, column, 1 or tag), so that its size follows the number of memristors rather than the area
  * */
-void Crossbar::generateCrossbarStructureFile(int level){
+void Crossbar::generateCrossbarStructureFile(const string& dir,int level,bool sparse){
 
-	std::ofstream out(string("./crossbar_structure_"+to_string(level)+".vhd").c_str());
-	std::streambuf *coutbuf = std::cout.rdbuf(); //save old buf
-	std::cout.rdbuf(out.rdbuf()); //redirect std::cout
+	FileWriter out(dir+"crossbar_structure_"+to_string(level)+".vhd");
 
-	cout<<"--\n"
+	out<<"--\n"
 			"--	Package File\n"
 			"--\n"
 			"--	Purpose: This package defines Crossbar constants and structure\n"
@@ -206,7 +286,33 @@ void Crossbar::generateCrossbarStructureFile(int level){
 			"\n"
 			"constant cb_height : integer := "<<this->getHeight()<<";\n"
 			"constant cb_width : integer := "<<this->getWidth()<<";\n"
-			"\n"
+			"\n";
+	if(sparse){
+		int sites = this->matrix.count();
+		out<<
+				"constant cb_sites : integer := "<<sites<<";\n"
+				"\n"
+				"type site is record\n"
+				"row : integer;\n"
+				"col : integer;\n"
+				"tag : integer;\n"
+				"end record;\n"
+				"\n"
+				"type site_list is array (0 to cb_sites-1) of site;\n"
+				"\n"
+				"constant cb_structure : site_list := (\n";
+		//named association, which is valid even for a list of one site
+		int k = 0;
+		for(CrossbarMatrix::const_iterator m = this->matrix.begin(); m != this->matrix.end(); ++m, ++k){
+			CrossbarMatrix::cell c = *m;
+			out<<"\t\t\t\t\t"<<k<<" => ("<<c.row<<","<<c.column<<","<<c.value<<")"<<(k!=sites-1? "," : "")<<'\n';
+		}
+		out<<
+				");\n"
+				"end "<<string("crossbar_structure_"+to_string(level)).c_str()<<";";
+		return;
+	}
+	out<<
 //			"type word is array(0 to cb_height-1) of std_logic_vector(0 to cb_width-1);\n"
 			"type matrix_row is array (0 to cb_width-1) of integer\n;"
 			"\n"
@@ -216,50 +322,54 @@ void Crossbar::generateCrossbarStructureFile(int level){
 //			"\n"
 			"constant cb_structure : matrix := (\n";
 
-	for(vector< vector<int> >::iterator i = this->matrix.begin(); i != this->matrix.end(); i++){
-		cout<<"\t\t\t\t\t(";
-		for(vector<int>::iterator j = i->begin(); j != i->end(); j++){
-			if(j!=(i->end())-1)
-				cout<<*j<<",";
-			else
-				cout<<*j;
+	//only the memristors are visited: the zeros between them are written in runs
+	CrossbarMatrix::const_iterator m = this->matrix.begin();
+	for(int i=0; i<this->matrix.getHeight(); i++){
+		out<<"\t\t\t\t\t(";
+		int j=0;
+		for(; m != this->matrix.end() && (*m).row == i; ++m){
+			CrossbarMatrix::cell c = *m;
+			for(; j<c.column; j++)
+				out<<"0,";
+			out<<c.value<<(c.column!=this->matrix.getWidth()-1? "," : "");
+			j++;
 		}
-		if(i!=this->matrix.end()-1)
-			cout<<"),"<<endl;
+		for(; j<this->matrix.getWidth(); j++)
+			out<<"0"<<(j!=this->matrix.getWidth()-1? "," : "");
+		if(i!=this->matrix.getHeight()-1)
+			out<<"),"<<'\n';
 		else
-			cout<<")"<<endl;
+			out<<")"<<'\n';
 	}
-	cout<<
+	out<<
 			");\n"
 			"end "<<string("crossbar_structure_"+to_string(level)).c_str()<<";";
 
-	std::cout.rdbuf(coutbuf); //reset to standard output again
 }
 
 /**
  * This procedure generates the Crossbar's controller VHDL file (FSM)
  * */
-void Crossbar::generateCrossbarControllerFile(int level,vector<string> inputs, vector<string> outputs){
+void Crossbar::generateCrossbarControllerFile(const string& dir,int level,vector<literal> inputs, vector<symbol> outputs, bool sharedClock){
 
-	std::ofstream out(string("./controller_"+to_string(level)+".vhd").c_str());
-	std::streambuf *coutbuf = std::cout.rdbuf(); //save old buf
-	std::cout.rdbuf(out.rdbuf()); //redirect std::cout
+	FileWriter out(dir+"controller_"+to_string(level)+".vhd");
 
 
-	cout<<"----------------------------------------------------------------------------------\n"
+	out<<"----------------------------------------------------------------------------------\n"
 			"-- Engineer: 		Marcello Traiola\n"
 			"--\n"
 			"-- Create Date: ";
 	time_t t = time(0);   // get time now
-	struct tm * now = localtime( & t );
-	cout << (now->tm_hour) << ':'
+	struct tm date;
+	struct tm * now = localtime_r( & t, & date );	//levels can be written concurrently
+	out << (now->tm_hour) << ':'
 			<< (now->tm_min) << ':'
 			<< (now->tm_sec) << ' '
 			<<(now->tm_mday) << '/'
 			<< (now->tm_mon + 1) << '/'
 			<< (now->tm_year + 1900)
-			<< endl;
-	cout<<
+			<< '\n';
+	out<<
 			"-- Design Name: \n"
 			"-- Module Name: \n"
 			"-- Project Name: \n"
@@ -276,15 +386,17 @@ void Crossbar::generateCrossbarControllerFile(int level,vector<string> inputs, v
 			"\n"
 			"entity "<<string("crossbar_controller_"+to_string(level)).c_str()<<" is\n"
 			"Port ( \n";
-	for(vector<string>::const_iterator i = inputs.begin(); i!= inputs.end();i++){
-		if((*i).find("not_") == std::string::npos)
-			cout<<VHDLsintaxFilter(*i)<<" : in  STD_LOGIC;\n";
+	for(vector<literal>::const_iterator i = inputs.begin(); i!= inputs.end();i++){
+		if(!isNegated(*i))
+			out<<VHDLsintaxFilter(signalTable().name(symbolOf(*i)))<<" : in  STD_LOGIC;\n";
 	}
-	cout<<"en : in STD_LOGIC;\n";
-	for(vector<string>::const_iterator i = outputs.begin(); i!= outputs.end();i++){
-		cout<<VHDLsintaxFilter(*i)<<" : out  STD_LOGIC;\n";
+	out<<"en : in STD_LOGIC;\n";
+	if(sharedClock)
+		out<<"XbG_clk : in STD_LOGIC;\n";
+	for(vector<symbol>::const_iterator i = outputs.begin(); i!= outputs.end();i++){
+		out<<VHDLsintaxFilter(signalTable().name(*i))<<" : out  STD_LOGIC;\n";
 	}
-	cout<<"done : out STD_LOGIC\n"
+	out<<"done : out STD_LOGIC\n"
 			");\n"
 			"end "<<string("crossbar_controller_"+to_string(level)).c_str()<<";\n"
 			"\n"
@@ -292,6 +404,7 @@ void Crossbar::generateCrossbarControllerFile(int level,vector<string> inputs, v
 			"\n"
 			"COMPONENT "<<string("crossbar_"+to_string(level)).c_str()<<"\n"
 			"PORT(\n"
+			<<(sharedClock? "XbG_clk : IN std_logic;\n" : "")<<
 			"Vpos : IN voltage_vector(0 to "<<getWidth()-1<<");\n"
 			"Vneg : IN voltage_vector(0 to "<<getHeight()-1<<");\n"
 			//			"output : OUT word\n"
@@ -305,63 +418,66 @@ void Crossbar::generateCrossbarControllerFile(int level,vector<string> inputs, v
 			"signal output_temp : STD_LOGIC_VECTOR(0 to "<<outputs.size()-1<<");\n"
 			"\n";
 	for(int i=0; i<getWidth();i++){
-		cout<<"	alias XbG_V"<<i<<" : voltage is Vpos_temp("<<i<<");\n";
+		out<<"	alias XbG_V"<<i<<" : voltage is Vpos_temp("<<i<<");\n";
 	}
 	for(int i=0; i<getHeight();i++){
-		cout<<"	alias XbG_H"<<i<<" : voltage is Vneg_temp("<<i<<");\n";
+		out<<"	alias XbG_H"<<i<<" : voltage is Vneg_temp("<<i<<");\n";
 	}
 	int j=0;
-	for(vector<string>::const_iterator i = outputs.begin(); i!= outputs.end();i++){
-		//		cout<<"alias "<<*i<<"_tmp : std_logic is output_temp("<<rowIndex.find("not_"+*i)->second<<")("<<columnIndex.find(*i)->second<<");\n";
-		cout<<"alias "<<VHDLsintaxFilter(*i)<<"_tmp : std_logic is output_temp("<<j++<<");\n";
+	for(vector<symbol>::const_iterator i = outputs.begin(); i!= outputs.end();i++){
+		out<<"alias "<<VHDLsintaxFilter(signalTable().name(*i))<<"_tmp : std_logic is output_temp("<<j++<<");\n";
 	}
 
-	cout<<"type FSMstate is (IDLE";
-	for(map< string, map<string, string> >::const_iterator i = voltages.begin(); i != voltages.end(); i++){
-		cout<<","<<i->first;
+	out<<"type FSMstate is (IDLE";
+	for(int s=0; s<CrossbarVoltages::numStages; s++){
+		out<<","<<CrossbarVoltages::stageName(CrossbarVoltages::stage(s));
 	}
-	cout<<
+	out<<
 			");\n"
 			"\n"
 			"signal state, next_state : FSMstate := IDLE;\n"
 			"\n"
-			"signal clk : std_logic := '0';\n"
-			"\n"
+			<<(sharedClock? "" : "signal clk : std_logic := '0';\n\n")<<
 			"constant clk_period : time := 1 ns;\n"
 			"\n"
 			"begin\n"
 			"\n"
 			"Inst_Crossbar : "<<string("crossbar_"+to_string(level)).c_str()<<" PORT MAP(\n"
+			<<(sharedClock? "XbG_clk => XbG_clk,\n" : "")<<
 			"Vpos => Vpos_temp,\n"
 			"Vneg => Vneg_temp,\n"
 			"output => output_temp\n"
 			");\n"
 			"\n";
 
-	for(vector<string>::const_iterator i = outputs.begin(); i!= outputs.end();i++){
-		cout<<VHDLsintaxFilter(*i)<<"<="<<VHDLsintaxFilter(*i)<<"_tmp;\n";
+	for(vector<symbol>::const_iterator i = outputs.begin(); i!= outputs.end();i++){
+		string name = VHDLsintaxFilter(signalTable().name(*i));
+		out<<name<<"<="<<name<<"_tmp;\n";
 	}
-	cout<<
-			"\n"
-			"-- Clock process definitions\n"
-			"clk_process : process (clk)\n"
-			"begin\n"
-			"clk <= not(clk) after clk_period/2; --only behavioral simulation\n"
-			"end process;\n"
-			"\n"
-			"change_state: process (clk)\n"
+	out<<"\n";
+	if(!sharedClock)
+		out<<
+				"-- Clock process definitions\n"
+				"clk_process : process (clk)\n"
+				"begin\n"
+				"clk <= not(clk) after clk_period/2; --only behavioral simulation\n"
+				"end process;\n"
+				"\n";
+	string clock = sharedClock? "XbG_clk" : "clk";
+	out<<
+			"change_state: process ("<<clock<<")\n"
 			"begin\n"
-			"if(clk'event and clk='1') then\n"
+			"if("<<clock<<"'event and "<<clock<<"='1') then\n"
 			"state <= next_state;   --state change.\n"
 			"end if;\n"
 			"end process;\n"
 			"\n"
 			"FSM: process(state,";
-	for(vector<string>::const_iterator i = inputs.begin(); i!= inputs.end();i++){
-		if((*i).find("not_") == std::string::npos)
-			cout<<VHDLsintaxFilter(*i)<<",";
+	for(vector<literal>::const_iterator i = inputs.begin(); i!= inputs.end();i++){
+		if(!isNegated(*i))
+			out<<VHDLsintaxFilter(signalTable().name(symbolOf(*i)))<<",";
 	}
-	cout<<
+	out<<
 			"en)\n"
 			"begin\n"
 			"\n"
@@ -378,23 +494,28 @@ void Crossbar::generateCrossbarControllerFile(int level,vector<string> inputs, v
 			"end if;\n"
 			"\n";
 
-	for(map< string, map<string, string> >::const_iterator i = voltages.begin(); i != voltages.end();i++){
-		if(i->first.find("A_") == string::npos){
-			cout<<
+	//wires in order of name, as the voltages of each stage used to be listed
+	vector<int> rows = decimalOrder(getHeight());
+	vector<int> columns = decimalOrder(getWidth());
+	for(int s=0; s<CrossbarVoltages::numStages; s++){
+		CrossbarVoltages::stage st = CrossbarVoltages::stage(s);
+		if(st != CrossbarVoltages::INA){
+			out<<
 					"\n"
-					"next_state<="<<i->first<<";\n"
+					"next_state<="<<CrossbarVoltages::stageName(st)<<";\n"
 					"\n";
 		}
-		cout<<
-				"when "<<i->first<<" =>\n"
+		out<<
+				"when "<<CrossbarVoltages::stageName(st)<<" =>\n"
 				"\n";
-		for(map<string, string>::const_iterator j = i->second.begin(); j != i->second.end();j++){
-			cout<<voltageFilter(i->first,j->first)<<endl;
-		}
+		for(vector<int>::const_iterator i = rows.begin(); i != rows.end(); i++)
+			voltageFilter(out,st,false,*i);
+		for(vector<int>::const_iterator i = columns.begin(); i != columns.end(); i++)
+			voltageFilter(out,st,true,*i);
 	}
 
 
-	cout<<
+	out<<
 			"\n"
 			"done<='1' after clk_period;\n"
 			"\n"
@@ -406,41 +527,38 @@ void Crossbar::generateCrossbarControllerFile(int level,vector<string> inputs, v
 			"\n"
 			"end Behavioral;\n";
 
-	std::cout.rdbuf(coutbuf); //reset to standard output again
 }
 
 /**
- * This function adapt "logic" voltages that we computed to VHDL compliant signals.
+ * This function adapt "logic" voltages that we computed to VHDL compliant signals, and writes
+ * the assignment of the wire 'wire' (vertical or horizontal) in the stage 'stage' to 'out'.
  * N.B. Actually, a "definition file" is provided with our memristor VHDL model
  * (e.g. here we use signals like Vr, Vw, etc that are actually translated to VHDL compliant
  * signals, within the definition file)
  * */
-string Crossbar::voltageFilter(string stage, string voltage){
-	map<string, string>::const_iterator tension = voltages.find(stage)->second.find(voltage);
-	if(tension->second=="Z"){
-		string isZ;
+void Crossbar::voltageFilter(FileWriter& out, CrossbarVoltages::stage stage, bool vertical, int wire){
+	const char* direction = vertical? "XbG_V" : "XbG_H";
+	CrossbarVoltages::voltage tension = vertical? voltages.getVertical(stage,wire) : voltages.getHorizontal(stage,wire);
+	if(tension==CrossbarVoltages::Z){
 		/***TEMPORARY***
 		 * If we are within the RI stage (ReceiveInputs), we assign the input values "manually"
 		 * to memristors within "IL" input register
 		 * even though they should come from the previous crossbar
 		 */
-		if(stage.find("RI") != string::npos){
-			map<int, string> reverseIndexColumn;
-			for(map<string,int>::const_iterator i = columnIndex.begin(); i!= columnIndex.end();i++){
-				reverseIndexColumn.insert(make_pair(i->second,i->first));
-			}
-			if(reverseIndexColumn.find(stoi(voltage.substr(5,string::npos)))->second.find("not_") != string::npos)
-				isZ+="if "+VHDLsintaxFilter((reverseIndexColumn.find(stoi(voltage.substr(5,string::npos)))->second).substr(4,string::npos))+"='0' then "+voltage+"<=Vw_neg; else "+voltage+"<=Vw; end if;\n";
-			else
-				isZ+="if "+VHDLsintaxFilter(reverseIndexColumn.find(stoi(voltage.substr(5,string::npos)))->second)+"='1' then "+voltage+"<=Vw_neg; else "+voltage+"<=Vw; end if;\n";
+		if(stage==CrossbarVoltages::RI){
+			literal in = this->columnLiterals[wire];
+			out<<"if "<<VHDLsintaxFilter(signalTable().name(symbolOf(in)))<<(isNegated(in)? "='0'" : "='1'")
+					<<" then "<<direction<<wire<<"<=Vw_neg; else "<<direction<<wire<<"<=Vw; end if;\n";
 		}
-		else if((--(voltages.find(stage)))->second.find(voltage)->second.find("Vw") != string::npos){
-			isZ+=tension->first+"<=Vr;\n";
-			isZ+=tension->first+"<=(others=>'Z') after 1 ps;";
+		else if((vertical? voltages.getVertical(CrossbarVoltages::stage(stage-1),wire)
+				: voltages.getHorizontal(CrossbarVoltages::stage(stage-1),wire)) == CrossbarVoltages::Vw){
+			out<<direction<<wire<<"<=Vr;\n";
+			out<<direction<<wire<<"<=(others=>'Z') after 1 ps;";
 		}
 		else
-			isZ+=tension->first+"<=(others=>'Z');";
-		return isZ;
+			out<<direction<<wire<<"<=(others=>'Z');";
+		out<<'\n';
+		return;
 	}
-	return tension->first+"<="+tension->second+";";
+	out<<direction<<wire<<"<="<<CrossbarVoltages::voltageName(tension)<<";\n";
 }
@@ -0,0 +1,149 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * CrossbarMatrix.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "entities.h"
+#include "my_utils.h"
+
+/**
+ * Constructor: a 'height' x 'width' matrix without memristors
+ */
+CrossbarMatrix::CrossbarMatrix(int height, int width) : height(height), width(width){
+	this->rowWords = (width+63)/64;
+	this->bits.assign((size_t)height*rowWords, 0);
+}
+
+/**
+ * sets the value of a cell: 0 removes the memristor, 1 places it, a greater value places a tagged one
+ */
+void CrossbarMatrix::set(int row, int column, int value){
+	uint64_t& w = this->bits[(size_t)row*rowWords + column/64];
+	uint64_t bit = 1ULL << (column%64);
+	if(value==0)
+		w &= ~bit;
+	else
+		w |= bit;
+	if(value>1)
+		this->tags[make_pair(row,column)] = value;
+	else
+		this->tags.erase(make_pair(row,column));
+}
+
+int CrossbarMatrix::get(int row, int column) const{
+	if((this->bits[(size_t)row*rowWords + column/64] & (1ULL << (column%64))) == 0)
+		return 0;
+	map<pair<int,int>, int>::const_iterator t = this->tags.find(make_pair(row,column));
+	return t==this->tags.end()? 1 : t->second;
+}
+
+/**
+ * number of memristors (cells with a value different from 0)
+ */
+int CrossbarMatrix::count() const{
+	int n = 0;
+	for(vector<uint64_t>::const_iterator i = this->bits.begin(); i != this->bits.end(); i++)
+		n += __builtin_popcountll(*i);
+	return n;
+}
+
+/**
+ * bytes taken by the matrix
+ */
+size_t CrossbarMatrix::memoryUsage() const{
+	//a map node holds the key, the value and (about) three pointers and a color
+	return sizeof(*this) + this->bits.capacity()*sizeof(uint64_t)
+			+ this->tags.size()*(sizeof(pair<const pair<int,int>, int>) + 4*sizeof(void*));
+}
+
+/**
+ * appends the matrix to 's' (size, bits and tagged cells), to be read back by deserialize()
+ */
+void CrossbarMatrix::serialize(string* s) const{
+	appendBytes(s, &this->height, sizeof(int));
+	appendBytes(s, &this->width, sizeof(int));
+	appendBytes(s, this->bits.data(), this->bits.size()*sizeof(uint64_t));
+	int numTags = this->tags.size();
+	appendBytes(s, &numTags, sizeof(int));
+	for(map<pair<int,int>, int>::const_iterator t = this->tags.begin(); t != this->tags.end(); ++t){
+		int cell[3] = {t->first.first, t->first.second, t->second};
+		appendBytes(s, cell, sizeof(cell));
+	}
+}
+
+/**
+ * reads the matrix written by serialize() from 's', starting at '*pos'.
+ * Returns false (and leaves an empty matrix) if the data is truncated or inconsistent.
+ */
+bool CrossbarMatrix::deserialize(const string& s, size_t* pos){
+	int h, w, numTags;
+	bool ok = readBytes(s, pos, &h, sizeof(int)) && readBytes(s, pos, &w, sizeof(int)) && h>=0 && w>=0;
+	if(ok){
+		*this = CrossbarMatrix(h, w);
+		ok = readBytes(s, pos, this->bits.data(), this->bits.size()*sizeof(uint64_t))
+				&& readBytes(s, pos, &numTags, sizeof(int)) && numTags>=0;
+	}
+	for(int t=0; ok && t<numTags; t++){
+		int cell[3];
+		ok = readBytes(s, pos, cell, sizeof(cell)) && cell[0]>=0 && cell[0]<h && cell[1]>=0 && cell[1]<w;
+		if(ok)
+			this->tags[make_pair(cell[0],cell[1])] = cell[2];
+	}
+	if(!ok)
+		*this = CrossbarMatrix();
+	return ok;
+}
+
+CrossbarMatrix::const_iterator::const_iterator(const CrossbarMatrix* m, size_t word) : m(m), word(word), pending(0){
+	if(word < m->bits.size()){
+		pending = m->bits[word];
+		skipEmpty();
+	}
+}
+
+/**
+ * moves to the first word with a memristor still to visit (or to the end)
+ */
+void CrossbarMatrix::const_iterator::skipEmpty(){
+	while(pending==0 && ++word < m->bits.size())
+		pending = m->bits[word];
+	if(word >= m->bits.size()){
+		word = m->bits.size();
+		pending = 0;
+	}
+}
+
+CrossbarMatrix::cell CrossbarMatrix::const_iterator::operator*() const{
+	cell c;
+	c.row = word/m->rowWords;
+	c.column = (word%m->rowWords)*64 + __builtin_ctzll(pending);
+	c.value = m->tags.empty()? 1 : m->get(c.row, c.column);
+	return c;
+}
+
+CrossbarMatrix::const_iterator& CrossbarMatrix::const_iterator::operator++(){
+	pending &= pending-1;
+	skipEmpty();
+	return *this;
+}
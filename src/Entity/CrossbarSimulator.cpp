@@ -0,0 +1,318 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+ * CrossbarSimulator.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "entities.h"
+#include <algorithm>
+
+namespace {
+
+//voltages a wire can take (memristor_lib/types.vhd): the ones of CrossbarVoltages and Vw_neg, used for the inputs
+enum level {Vw_neg, zero, Vr, Vw, numLevels};
+const int volts[numLevels] = {-4, 0, 2, 4};
+const int Vth = 3;
+
+level levelOf(CrossbarVoltages::voltage v){
+	static const level levels[] = {zero, Vr, Vw};
+	return levels[v];
+}
+
+//conditions on the voltage across a memristor: it switches to 'zero' above Vth, to 'one' below -Vth,
+//and in state 'zero' it drives a floating wire if the voltage isn't 0
+enum condition {above, below, nonZero, numConditions};
+
+/**
+ * whether each condition holds for each pair of levels (of the column, of the row), and whether it holds
+ * for some pair of two sets of levels (bit 'l' of a set is the level 'l'). The voltage across the memristor
+ * is a 4-bit signed value in the VHDL model, so it's wrapped the same way
+ */
+struct conditionTable{
+	bool holds[numConditions][numLevels][numLevels];
+	bool holdsSome[numConditions][1<<numLevels][1<<numLevels];
+
+	conditionTable(){
+		for(int a=0; a<numLevels; a++)
+			for(int b=0; b<numLevels; b++){
+				int v = ((volts[a]-volts[b]+8)&15)-8;
+				holds[above][a][b] = v>Vth;
+				holds[below][a][b] = v<-Vth;
+				holds[nonZero][a][b] = v!=0;
+			}
+		for(int c=0; c<numConditions; c++)
+			for(int x=0; x<(1<<numLevels); x++)
+				for(int y=0; y<(1<<numLevels); y++){
+					holdsSome[c][x][y] = false;
+					for(int a=0; a<numLevels; a++)
+						for(int b=0; b<numLevels; b++)
+							if((x>>a&1) && (y>>b&1) && holds[c][a][b])
+								holdsSome[c][x][y] = true;
+				}
+	}
+};
+
+//the level of a set with a single one, -1 otherwise
+int single(int levels){
+	return levels!=0 && (levels&(levels-1))==0? __builtin_ctz(levels) : -1;
+}
+
+const conditionTable conditions;
+
+}
+
+/**
+ * Takes the memristors of 'xbar' (the output ones are found through their tag) and the voltages of its stages
+ */
+CrossbarSimulator::CrossbarSimulator(const Crossbar& xbar) : height(xbar.matrix.getHeight()), width(xbar.matrix.getWidth()),
+		columnLiterals(xbar.columnLiterals), voltages(xbar.voltages){
+	for(CrossbarMatrix::const_iterator i = xbar.matrix.begin(); i != xbar.matrix.end(); ++i){
+		CrossbarMatrix::cell c = *i;
+		if(c.value>1){
+			if((int)this->outputMemristors.size()<c.value-1)
+				this->outputMemristors.resize(c.value-1, -1);
+			this->outputMemristors[c.value-2] = this->memristors.size();
+		}
+		memristor m = {c.row, this->height+c.column};
+		this->memristors.push_back(m);
+	}
+}
+
+/**
+ * Runs the stages of the FSM on 64*'words' input vectors: 'values' holds, for each signal (indexed by symbol),
+ * 'words' words with a bit per vector. The value of each output (in order of output) is written in 'outputs',
+ * 'words' words each.
+ * In each stage the wires are set, the floating ones are driven until nothing changes, and then each memristor
+ * switches (at most once: it's clocked once per stage) by the voltage across it.
+ * The levels each wire takes (for some vector) are kept aside: most wires have the same one for all the vectors
+ * (e.g. all the driven ones), so most memristors either can't switch in a stage or switch for all the vectors,
+ * and only the others are evaluated vector by vector. Such a memristor usually has a wire with a single level,
+ * so its condition is the one of all the memristors between its other wire and that level: it's computed once.
+ */
+void CrossbarSimulator::run(const uint64_t* values, int words, uint64_t* outputs) const{
+	int wires = this->height+this->width;
+	//voltage of each wire: the set of the levels it takes and, if they're more than one, a mask of the vectors for each level
+	vector<uint64_t> wire((size_t)wires*numLevels*words, 0);
+	vector<int> levels(wires, 1<<zero);
+	vector<uint64_t> driven((size_t)wires*numLevels*words);
+	vector<uint64_t> state(this->memristors.size()*words, ~0ULL);	//'one' is the initial state
+	//whether a memristor is in state 'one' for all the vectors, in state 'zero' for all of them, or it depends
+	enum {allZero, allOne, mixed};
+	vector<char> states(this->memristors.size(), allOne);
+	vector<char> floating(wires), hasDrivers(wires);
+
+	//masks of the conditions, 'words' words each: none, all, one for each condition of the memristor
+	//being evaluated, and then the ones of a wire against a level (which are valid until the wires change)
+	enum {none, all, firstScratch, firstShared = firstScratch+numConditions};
+	vector<uint64_t> masks((size_t)firstShared*words, 0);
+	fill(&masks[all*words], &masks[(all+1)*words], ~0ULL);
+	vector<int> shared((size_t)numConditions*2*wires*numLevels, -1);
+	vector<int> sharedKeys;
+	auto forgetShared = [&](){
+		for(vector<int>::const_iterator k = sharedKeys.begin(); k != sharedKeys.end(); ++k)
+			shared[*k] = -1;
+		sharedKeys.clear();
+		masks.resize((size_t)firstShared*words);
+	};
+
+	//mask (its index in 'masks') of the vectors for which the condition 'c' holds across the memristor 'm'
+	auto across = [&](const memristor& m, condition c) -> int{
+		int a = single(levels[m.column]), b = single(levels[m.row]);
+		if(a>=0 && b>=0)
+			return conditions.holds[c][a][b]? all : none;
+		int index = firstScratch+c;
+		if(a>=0 || b>=0){
+			int key = ((c*2 + (a>=0? 1 : 0))*wires + (a>=0? m.row : m.column))*numLevels + (a>=0? a : b);
+			if(shared[key]>=0)
+				return shared[key];
+			index = shared[key] = masks.size()/words;
+			sharedKeys.push_back(key);
+			masks.resize(masks.size()+words);
+		}
+		uint64_t* out = &masks[(size_t)index*words];
+		fill(out, out+words, 0);
+		for(int x=0; x<numLevels; x++)
+			for(int y=0; y<numLevels; y++){
+				if(!(levels[m.column]>>x&1) || !(levels[m.row]>>y&1) || !conditions.holds[c][x][y])
+					continue;
+				const uint64_t* col = &wire[((size_t)m.column*numLevels+x)*words];
+				const uint64_t* row = &wire[((size_t)m.row*numLevels+y)*words];
+				if(a>=0)
+					for(int w=0; w<words; w++)
+						out[w] |= row[w];
+				else if(b>=0)
+					for(int w=0; w<words; w++)
+						out[w] |= col[w];
+				else
+					for(int w=0; w<words; w++)
+						out[w] |= col[w] & row[w];
+			}
+		return index;
+	};
+	//masks of a wire with a single level
+	auto fillMasks = [&](int i){
+		uint64_t* v = &wire[(size_t)i*numLevels*words];
+		for(int l=0; l<numLevels; l++)
+			fill(v+l*words, v+(l+1)*words, levels[i]==1<<l? ~0ULL : 0);
+	};
+
+	vector<uint64_t> mask(words);
+	for(int s=0; s<CrossbarVoltages::numStages; s++){
+		CrossbarVoltages::stage st = CrossbarVoltages::stage(s);
+		bool anyFloating = false;
+		for(int i=0; i<wires; i++){
+			bool vertical = i>=this->height;
+			CrossbarVoltages::voltage v = vertical? this->voltages.getVertical(st,i-this->height) : this->voltages.getHorizontal(st,i);
+			floating[i] = false;
+			if(v!=CrossbarVoltages::Z){
+				levels[i] = 1<<levelOf(v);
+				continue;
+			}
+			if(st==CrossbarVoltages::RI && vertical){
+				//the controller writes the inputs: Vw_neg where the literal of the column is 1, Vw where it's 0
+				literal l = this->columnLiterals[i-this->height];
+				const uint64_t* in = &values[(size_t)symbolOf(l)*words];
+				uint64_t* out = &wire[(size_t)i*numLevels*words];
+				fill(out, out+numLevels*words, 0);
+				for(int w=0; w<words; w++){
+					uint64_t one = isNegated(l)? ~in[w] : in[w];
+					out[Vw_neg*words+w] = one;
+					out[Vw*words+w] = ~one;
+				}
+				levels[i] = 1<<Vw_neg | 1<<Vw;
+				continue;
+			}
+			//a wire left floating after a write gets Vr for a moment, so the memristors forget Vw
+			CrossbarVoltages::voltage previous = st==CrossbarVoltages::INA? CrossbarVoltages::Z
+					: vertical? this->voltages.getVertical(CrossbarVoltages::stage(s-1),i-this->height)
+					: this->voltages.getHorizontal(CrossbarVoltages::stage(s-1),i);
+			if(previous==CrossbarVoltages::Vw)
+				levels[i] = 1<<Vr;
+			floating[i] = true;
+			anyFloating = true;
+		}
+
+		//a memristor in state 'zero' drives a floating wire to the voltage of its other wire, as long as
+		//it sees a voltage across it; where the drivers disagree, the wire keeps its voltage
+		for(int round=0; anyFloating && round<wires; round++){
+			fill(hasDrivers.begin(), hasDrivers.end(), 0);
+			forgetShared();
+			for(size_t k=0; k<this->memristors.size(); k++){
+				const memristor& m = this->memristors[k];
+				if((!floating[m.row] && !floating[m.column]) || states[k]==allOne
+						|| !conditions.holdsSome[nonZero][levels[m.column]][levels[m.row]])
+					continue;
+				const uint64_t* v = &masks[(size_t)across(m, nonZero)*words];
+				uint64_t any = 0;
+				for(int w=0; w<words; w++){
+					mask[w] = v[w] & ~state[k*words+w];
+					any |= mask[w];
+				}
+				if(any==0)
+					continue;
+				for(int side=0; side<2; side++){
+					int target = side==0? m.row : m.column;
+					int source = side==0? m.column : m.row;
+					if(!floating[target])
+						continue;
+					if(!hasDrivers[target]){
+						fill(&driven[(size_t)target*numLevels*words], &driven[(size_t)(target+1)*numLevels*words], 0);
+						hasDrivers[target] = 1;
+					}
+					for(int l=0; l<numLevels; l++){
+						if(!(levels[source]>>l&1))
+							continue;
+						uint64_t* d = &driven[((size_t)target*numLevels+l)*words];
+						const uint64_t* v = &wire[((size_t)source*numLevels+l)*words];
+						if(levels[source]==1<<l)
+							for(int w=0; w<words; w++)
+								d[w] |= mask[w];
+						else
+							for(int w=0; w<words; w++)
+								d[w] |= mask[w] & v[w];
+					}
+				}
+			}
+			bool changed = false;
+			for(int i=0; i<wires; i++){
+				if(!hasDrivers[i])
+					continue;
+				uint64_t* d = &driven[(size_t)i*numLevels*words];
+				uint64_t* v = &wire[(size_t)i*numLevels*words];
+				if(single(levels[i])>=0)
+					fillMasks(i);
+				for(int w=0; w<words; w++){
+					uint64_t any = 0, conflict = 0;
+					for(int l=0; l<numLevels; l++){
+						conflict |= any & d[l*words+w];
+						any |= d[l*words+w];
+					}
+					uint64_t valid = any & ~conflict;
+					for(int l=0; l<numLevels; l++){
+						uint64_t next = (v[l*words+w] & ~valid) | (d[l*words+w] & valid);
+						changed |= next!=v[l*words+w];
+						v[l*words+w] = next;
+					}
+				}
+				levels[i] = 0;
+				for(int l=0; l<numLevels; l++)
+					if(count(v+l*words, v+(l+1)*words, 0)!=words)
+						levels[i] |= 1<<l;
+			}
+			if(!changed)
+				break;
+		}
+
+		//clock edge: 'one' -> 'zero' above Vth, 'zero' -> 'one' below -Vth
+		forgetShared();
+		for(size_t k=0; k<this->memristors.size(); k++){
+			const memristor& m = this->memristors[k];
+			uint64_t* x = &state[k*words];
+			int col = levels[m.column], row = levels[m.row];
+			bool toZero = states[k]!=allZero && conditions.holdsSome[above][col][row];
+			bool toOne = states[k]!=allOne && conditions.holdsSome[below][col][row];
+			if(!toZero && !toOne)
+				continue;
+			int a = single(col), b = single(row);
+			if(a>=0 && b>=0){
+				fill(x, x+words, toZero? 0 : ~0ULL);
+				states[k] = toZero? allZero : allOne;
+				continue;
+			}
+			int u = toZero? across(m, above) : none, d = toOne? across(m, below) : none;
+			const uint64_t* up = &masks[(size_t)u*words];
+			const uint64_t* down = &masks[(size_t)d*words];
+			uint64_t ones = ~0ULL, zeros = 0;
+			for(int w=0; w<words; w++){
+				x[w] = (x[w] & ~up[w]) | (~x[w] & down[w]);
+				ones &= x[w];
+				zeros |= x[w];
+			}
+			states[k] = ones==~0ULL? allOne : zeros==0? allZero : mixed;
+		}
+	}
+
+	for(size_t k=0; k<this->outputMemristors.size(); k++)
+		copy(&state[(size_t)this->outputMemristors[k]*words], &state[(size_t)(this->outputMemristors[k]+1)*words], outputs+k*words);
+}
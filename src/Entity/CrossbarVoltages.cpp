@@ -0,0 +1,123 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * CrossbarVoltages.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "entities.h"
+#include "my_utils.h"
+#include <algorithm>
+
+/**
+ * Computes, for each stage, the voltage of each nanowire. The wires follow the layout built by
+ * Translator::create_index():
+ * - rows: the input latch (row 0), then the cubes, then one row for each output
+ * - columns: the inputs, then two columns (positive and negated) for each output
+ * so each stage is a few fills of contiguous ranges
+ */
+void CrossbarVoltages::generate(int numInputs, int numOutputs){
+	int firstOutputRow = this->height-numOutputs;
+	int firstOutputColumn = numInputs;
+
+	//horizontal: input latch, cubes, outputs
+	const voltage rows[numStages][3] = {
+			{Vw, Vw, Vw},		//INA (reset)
+			{zero, Vr, Vr},		//RI (SFC)
+			{Vw, zero, Vr},		//CFM (MFC)
+			{Vr, Z, Vr},		//EVM (SFNAND)
+			{Vr, Vw, zero},		//EVR (AND)
+			{Vr, Vr, Z}};		//INR (INV)
+	//vertical: inputs, positive outputs, negated outputs
+	const voltage columns[numStages][3] = {
+			{zero, zero, zero},	//INA (reset)
+			{Z, Vr, Vr},		//RI (SFC)
+			{Z, Vr, Vr},		//CFM (MFC)
+			{Vr, Vr, Vw},		//EVM (SFNAND)
+			{Vr, Vr, Z},		//EVR (AND)
+			{Vr, Vw, Vr}};		//INR (INV)
+
+	for(int s=0; s<numStages; s++){
+		voltage* h = horizontal(stage(s));
+		h[0] = rows[s][0];
+		fill(h+1, h+firstOutputRow, rows[s][1]);
+		fill(h+firstOutputRow, h+this->height, rows[s][2]);
+
+		voltage* v = vertical(stage(s));
+		fill(v, v+firstOutputColumn, columns[s][0]);
+		for(int c=firstOutputColumn; c<this->width; c+=2){
+			v[c] = columns[s][1];
+			v[c+1] = columns[s][2];
+		}
+	}
+}
+
+/**
+ * Prints out the voltages for each nanowire, for each stage, through the given stream (std output by default):
+ * wires are in order of name
+ * */
+void CrossbarVoltages::print(ostream& out) const{
+	vector<int> rows = decimalOrder(this->height);
+	vector<int> columns = decimalOrder(this->width);
+	for(int s=0; s<numStages; s++){
+		out<<"Stage "<<stageName(stage(s))<<":"<<endl;
+		for(vector<int>::const_iterator i = rows.begin(); i != rows.end(); i++)
+			out<<"XbG_H"<<*i<<"="<<voltageName(getHorizontal(stage(s),*i))<<endl;
+		for(vector<int>::const_iterator i = columns.begin(); i != columns.end(); i++)
+			out<<"XbG_V"<<*i<<"="<<voltageName(getVertical(stage(s),*i))<<endl;
+		out<<endl;
+	}
+}
+
+/**
+ * appends the table to 's' (size and a byte per entry), to be read back by deserialize()
+ */
+void CrossbarVoltages::serialize(string* s) const{
+	appendBytes(s, &this->height, sizeof(int));
+	appendBytes(s, &this->width, sizeof(int));
+	appendBytes(s, this->table.data(), this->table.size());
+}
+
+/**
+ * reads the table written by serialize() from 's', starting at '*pos'; its size must be the one of this table.
+ * Returns false if the data is truncated or has another size.
+ */
+bool CrossbarVoltages::deserialize(const string& s, size_t* pos){
+	int h, w;
+	if(!readBytes(s, pos, &h, sizeof(int)) || !readBytes(s, pos, &w, sizeof(int))
+			|| h!=this->height || w!=this->width || !readBytes(s, pos, this->table.data(), this->table.size()))
+		return false;
+	for(vector<voltage>::const_iterator v = this->table.begin(); v != this->table.end(); ++v)
+		if(*v>Z)
+			return false;
+	return true;
+}
+
+const char* CrossbarVoltages::stageName(stage s){
+	static const char* names[numStages] = {"A_INA", "B_RI", "C_CFM", "D_EVM", "E_EVR", "F_INR"};
+	return names[s];
+}
+
+const char* CrossbarVoltages::voltageName(voltage v){
+	static const char* names[] = {"zero", "Vr", "Vw", "Z"};
+	return names[v];
+}
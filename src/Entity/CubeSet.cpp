@@ -0,0 +1,744 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * CubeSet.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "entities.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define XBARGEN_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+//the even bit of each variable
+static const uint64_t evenBits = 0x5555555555555555ULL;
+static const uint64_t hashPrime = 0x9E3779B97F4A7C15ULL;
+//the hash runs on 4 interleaved lanes (word k goes to lane k%4), so that SIMD kernels give the same values
+static const uint64_t hashSeed[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+
+/**
+ * Kernels on cubes of 'n' words:
+ * - contains: true if every minterm of 'b' is in 'a' (b & ~a is 0)
+ * - intersect: writes a & b in 'out', returns false if the intersection is empty (a variable is '00')
+ * - equal: true if the cubes are the same
+ * - hash: hash of the cube
+ * - literals: number of literals of the cube (0 bits: padding variables are '11')
+ */
+struct cubeKernels{
+	const char* name;
+	bool (*contains)(const uint64_t*, const uint64_t*, int);
+	bool (*intersect)(const uint64_t*, const uint64_t*, uint64_t*, int);
+	bool (*equal)(const uint64_t*, const uint64_t*, int);
+	uint64_t (*hash)(const uint64_t*, int);
+	int (*literals)(const uint64_t*, int);
+};
+
+/****scalar kernels****/
+
+static inline bool emptyWord(uint64_t w){
+	return (~(w | (w>>1)) & evenBits) != 0;
+}
+
+static inline uint64_t hashStep(uint64_t h, uint64_t w){
+	h = (h ^ w) * hashPrime;
+	return h ^ (h>>29);
+}
+
+static uint64_t hashLanes(uint64_t* lanes, int n){
+	uint64_t h = hashPrime * (uint64_t)(n+1);
+	for(int l=0; l<4; l++){
+		h = (h ^ lanes[l]) * hashPrime;
+		h ^= h>>32;
+	}
+	return h;
+}
+
+static bool containsScalar(const uint64_t* a, const uint64_t* b, int n){
+	for(int k=0; k<n; k++)
+		if((b[k] & ~a[k]) != 0)
+			return false;
+	return true;
+}
+
+static bool intersectScalar(const uint64_t* a, const uint64_t* b, uint64_t* out, int n){
+	bool empty = false;
+	for(int k=0; k<n; k++){
+		out[k] = a[k] & b[k];
+		empty = empty || emptyWord(out[k]);
+	}
+	return !empty;
+}
+
+static bool equalScalar(const uint64_t* a, const uint64_t* b, int n){
+	for(int k=0; k<n; k++)
+		if(a[k] != b[k])
+			return false;
+	return true;
+}
+
+static uint64_t hashScalar(const uint64_t* a, int n){
+	uint64_t lanes[4] = {hashSeed[0], hashSeed[1], hashSeed[2], hashSeed[3]};
+	for(int k=0; k<n; k++)
+		lanes[k&3] = hashStep(lanes[k&3], a[k]);
+	return hashLanes(lanes, n);
+}
+
+static int literalsScalar(const uint64_t* a, int n){
+	int count = 0;
+	for(int k=0; k<n; k++){
+		//SWAR popcount
+		uint64_t x = ~a[k];
+		x = x - ((x>>1) & evenBits);
+		x = (x & 0x3333333333333333ULL) + ((x>>2) & 0x3333333333333333ULL);
+		x = (x + (x>>4)) & 0x0F0F0F0F0F0F0F0FULL;
+		count += (int)((x * 0x0101010101010101ULL) >> 56);
+	}
+	return count;
+}
+
+static const cubeKernels scalarKernels = {"scalar", containsScalar, intersectScalar, equalScalar, hashScalar, literalsScalar};
+
+#ifdef XBARGEN_X86_KERNELS
+
+/****SSE2 kernels (2 words at a time)****/
+
+static bool containsSSE2(const uint64_t* a, const uint64_t* b, int n){
+	int k = 0;
+	for(; k+2<=n; k+=2){
+		__m128i x = _mm_andnot_si128(_mm_loadu_si128((const __m128i*)(a+k)), _mm_loadu_si128((const __m128i*)(b+k)));
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) != 0xFFFF)
+			return false;
+	}
+	return containsScalar(a+k, b+k, n-k);
+}
+
+static bool intersectSSE2(const uint64_t* a, const uint64_t* b, uint64_t* out, int n){
+	const __m128i even = _mm_set1_epi64x((long long)evenBits);
+	__m128i empty = _mm_setzero_si128();
+	int k = 0;
+	for(; k+2<=n; k+=2){
+		__m128i r = _mm_and_si128(_mm_loadu_si128((const __m128i*)(a+k)), _mm_loadu_si128((const __m128i*)(b+k)));
+		_mm_storeu_si128((__m128i*)(out+k), r);
+		empty = _mm_or_si128(empty, _mm_andnot_si128(_mm_or_si128(r, _mm_srli_epi64(r,1)), even));
+	}
+	bool nonEmpty = _mm_movemask_epi8(_mm_cmpeq_epi8(empty, _mm_setzero_si128())) == 0xFFFF;
+	return intersectScalar(a+k, b+k, out+k, n-k) && nonEmpty;
+}
+
+static bool equalSSE2(const uint64_t* a, const uint64_t* b, int n){
+	int k = 0;
+	for(; k+2<=n; k+=2){
+		__m128i x = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a+k)), _mm_loadu_si128((const __m128i*)(b+k)));
+		if(_mm_movemask_epi8(x) != 0xFFFF)
+			return false;
+	}
+	return equalScalar(a+k, b+k, n-k);
+}
+
+/**
+ * low 64 bits of the lane by lane product x*y (SSE2 only multiplies 32-bit halves)
+ */
+static inline __m128i mul64SSE2(__m128i x, __m128i y){
+	__m128i cross = _mm_add_epi64(_mm_mul_epu32(x, _mm_srli_epi64(y,32)), _mm_mul_epu32(_mm_srli_epi64(x,32), y));
+	return _mm_add_epi64(_mm_mul_epu32(x, y), _mm_slli_epi64(cross,32));
+}
+
+static uint64_t hashSSE2(const uint64_t* a, int n){
+	const __m128i prime = _mm_set1_epi64x((long long)hashPrime);
+	__m128i lo = _mm_loadu_si128((const __m128i*)hashSeed);
+	__m128i hi = _mm_loadu_si128((const __m128i*)(hashSeed+2));
+	int k = 0;
+	for(; k+4<=n; k+=4){
+		lo = mul64SSE2(_mm_xor_si128(lo, _mm_loadu_si128((const __m128i*)(a+k))), prime);
+		lo = _mm_xor_si128(lo, _mm_srli_epi64(lo,29));
+		hi = mul64SSE2(_mm_xor_si128(hi, _mm_loadu_si128((const __m128i*)(a+k+2))), prime);
+		hi = _mm_xor_si128(hi, _mm_srli_epi64(hi,29));
+	}
+	uint64_t lanes[4];
+	_mm_storeu_si128((__m128i*)lanes, lo);
+	_mm_storeu_si128((__m128i*)(lanes+2), hi);
+	for(; k<n; k++)
+		lanes[k&3] = hashStep(lanes[k&3], a[k]);
+	return hashLanes(lanes, n);
+}
+
+static const cubeKernels sse2Kernels = {"sse2", containsSSE2, intersectSSE2, equalSSE2, hashSSE2, literalsScalar};
+
+/****AVX2 kernels (4 words at a time)****/
+
+__attribute__((target("avx2")))
+static bool containsAVX2(const uint64_t* a, const uint64_t* b, int n){
+	int k = 0;
+	for(; k+4<=n; k+=4){
+		//testc: (~a & b) == 0
+		if(!_mm256_testc_si256(_mm256_loadu_si256((const __m256i*)(a+k)), _mm256_loadu_si256((const __m256i*)(b+k))))
+			return false;
+	}
+	return containsScalar(a+k, b+k, n-k);
+}
+
+__attribute__((target("avx2")))
+static bool intersectAVX2(const uint64_t* a, const uint64_t* b, uint64_t* out, int n){
+	const __m256i even = _mm256_set1_epi64x((long long)evenBits);
+	__m256i empty = _mm256_setzero_si256();
+	int k = 0;
+	for(; k+4<=n; k+=4){
+		__m256i r = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a+k)), _mm256_loadu_si256((const __m256i*)(b+k)));
+		_mm256_storeu_si256((__m256i*)(out+k), r);
+		empty = _mm256_or_si256(empty, _mm256_andnot_si256(_mm256_or_si256(r, _mm256_srli_epi64(r,1)), even));
+	}
+	bool nonEmpty = _mm256_testz_si256(empty, empty);
+	return intersectScalar(a+k, b+k, out+k, n-k) && nonEmpty;
+}
+
+__attribute__((target("avx2")))
+static bool equalAVX2(const uint64_t* a, const uint64_t* b, int n){
+	int k = 0;
+	for(; k+4<=n; k+=4){
+		__m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a+k)), _mm256_loadu_si256((const __m256i*)(b+k)));
+		if(!_mm256_testz_si256(x, x))
+			return false;
+	}
+	return equalScalar(a+k, b+k, n-k);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i mul64AVX2(__m256i x, __m256i y){
+	__m256i cross = _mm256_add_epi64(_mm256_mul_epu32(x, _mm256_srli_epi64(y,32)), _mm256_mul_epu32(_mm256_srli_epi64(x,32), y));
+	return _mm256_add_epi64(_mm256_mul_epu32(x, y), _mm256_slli_epi64(cross,32));
+}
+
+__attribute__((target("avx2")))
+static uint64_t hashAVX2(const uint64_t* a, int n){
+	const __m256i prime = _mm256_set1_epi64x((long long)hashPrime);
+	__m256i h = _mm256_loadu_si256((const __m256i*)hashSeed);
+	int k = 0;
+	for(; k+4<=n; k+=4){
+		h = mul64AVX2(_mm256_xor_si256(h, _mm256_loadu_si256((const __m256i*)(a+k))), prime);
+		h = _mm256_xor_si256(h, _mm256_srli_epi64(h,29));
+	}
+	uint64_t lanes[4];
+	_mm256_storeu_si256((__m256i*)lanes, h);
+	for(; k<n; k++)
+		lanes[k&3] = hashStep(lanes[k&3], a[k]);
+	return hashLanes(lanes, n);
+}
+
+/**
+ * popcount of the complemented words: nibble lookup (pshufb) and byte sums (psadbw)
+ */
+__attribute__((target("avx2,popcnt")))
+static int literalsAVX2(const uint64_t* a, int n){
+	const __m256i table = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+	const __m256i low = _mm256_set1_epi8(0x0F);
+	const __m256i ones = _mm256_set1_epi8((char)0xFF);
+	__m256i sum = _mm256_setzero_si256();
+	int k = 0;
+	for(; k+4<=n; k+=4){
+		__m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a+k)), ones);
+		__m256i c = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, low)),
+				_mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x,4), low)));
+		sum = _mm256_add_epi64(sum, _mm256_sad_epu8(c, _mm256_setzero_si256()));
+	}
+	uint64_t partial[4];
+	_mm256_storeu_si256((__m256i*)partial, sum);
+	int count = (int)(partial[0]+partial[1]+partial[2]+partial[3]);
+	for(; k<n; k++)
+		count += (int)_mm_popcnt_u64(~a[k]);
+	return count;
+}
+
+static const cubeKernels avx2Kernels = {"avx2", containsAVX2, intersectAVX2, equalAVX2, hashAVX2, literalsAVX2};
+
+#endif
+
+/**
+ * the best kernels supported by the CPU
+ */
+static const cubeKernels* detectKernels(){
+#ifdef XBARGEN_X86_KERNELS
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+		return &avx2Kernels;
+	if(__builtin_cpu_supports("sse2"))
+		return &sse2Kernels;
+#endif
+	return &scalarKernels;
+}
+
+static const cubeKernels* kernels = detectKernels();
+
+/**
+ * selects the kernels by name ("scalar", "sse2", "avx2"): returns false if they aren't available
+ */
+bool CubeSet::useKernels(const string& name){
+	if(name=="scalar"){
+		kernels = &scalarKernels;
+		return true;
+	}
+#ifdef XBARGEN_X86_KERNELS
+	__builtin_cpu_init();
+	if(name=="sse2" && __builtin_cpu_supports("sse2")){
+		kernels = &sse2Kernels;
+		return true;
+	}
+	if(name=="avx2" && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")){
+		kernels = &avx2Kernels;
+		return true;
+	}
+#endif
+	return false;
+}
+
+const char* CubeSet::kernelName(){
+	return kernels->name;
+}
+
+/**
+ * Constructor: an empty set of cubes over 'numVars' variables
+ */
+CubeSet::CubeSet(int numVars) : numVars(numVars){
+	this->numWords = numVars>0? (numVars+31)/32 : 1;
+}
+
+/**
+ * appends the cube with no literals (all variables '11') and returns its index
+ */
+int CubeSet::addCube(){
+	this->words.insert(this->words.end(), this->numWords, ~0ULL);
+	return size()-1;
+}
+
+/**
+ * appends a copy of the cube 'w' (of getNumWords() words) and returns its index
+ */
+int CubeSet::addCube(const uint64_t* w){
+	this->words.insert(this->words.end(), w, w+this->numWords);
+	return size()-1;
+}
+
+/**
+ * removes the cube 'c': the following ones move back by one
+ */
+void CubeSet::removeCube(int c){
+	this->words.erase(this->words.begin()+(size_t)c*numWords, this->words.begin()+(size_t)(c+1)*numWords);
+}
+
+/**
+ * adds the literal of variable 'var' (positive or negated) to the cube 'c'
+ */
+void CubeSet::addLiteral(int c, int var, bool negated){
+	//a positive literal excludes the value 0 (even bit), a negated one the value 1 (odd bit)
+	cube(c)[var/32] &= ~(1ULL << (2*(var%32) + (negated? 1 : 0)));
+}
+
+bool CubeSet::hasLiteral(int c, int var, bool negated) const{
+	return (cube(c)[var/32] & (1ULL << (2*(var%32) + (negated? 1 : 0)))) == 0;
+}
+
+int CubeSet::literalCount(int c) const{
+	return kernels->literals(cube(c), numWords);
+}
+
+/**
+ * true if the cube 'a' contains the cube 'b' (i.e. 'b' implies 'a')
+ */
+bool CubeSet::contains(int a, int b) const{
+	return kernels->contains(cube(a), cube(b), numWords);
+}
+
+bool CubeSet::intersects(int a, int b) const{
+	//the intersection is built in a small buffer, 64 words at a time
+	uint64_t buffer[64];
+	for(int k=0; k<numWords; k+=64){
+		int n = numWords-k<64? numWords-k : 64;
+		if(!kernels->intersect(cube(a)+k, cube(b)+k, buffer, n))
+			return false;
+	}
+	return true;
+}
+
+bool CubeSet::isEmpty(int c) const{
+	const uint64_t* w = cube(c);
+	for(int k=0; k<numWords; k++)
+		if(emptyWord(w[k]))
+			return true;
+	return false;
+}
+
+bool CubeSet::equal(int a, int b) const{
+	return kernels->equal(cube(a), cube(b), numWords);
+}
+
+uint64_t CubeSet::hash(int c) const{
+	return kernels->hash(cube(c), numWords);
+}
+
+/**
+ * true if the cube 'a' contains the cube 'b' (both of 'numWords' words)
+ */
+bool CubeSet::contains(const uint64_t* a, const uint64_t* b, int numWords){
+	return kernels->contains(a, b, numWords);
+}
+
+/**
+ * writes in 'out' the intersection of the cubes 'a' and 'b' (of 'numWords' words):
+ * returns false if it's empty
+ */
+bool CubeSet::intersect(const uint64_t* a, const uint64_t* b, uint64_t* out, int numWords){
+	return kernels->intersect(a, b, out, numWords);
+}
+
+/**
+ * For each cube, the index of the first cube equal to it (the cube itself if it's the first one).
+ * Cubes are found through an open addressing table of their hashes.
+ */
+vector<int> CubeSet::firstOccurrences() const{
+	int n = size();
+	vector<int> first(n);
+	size_t capacity = 16;
+	while(capacity < 2*(size_t)n)
+		capacity *= 2;
+	size_t mask = capacity-1;
+	vector<int> table(capacity, -1);
+	vector<uint64_t> hashes(n);
+	for(int c=0; c<n; c++){
+		hashes[c] = hash(c);
+		size_t i = hashes[c] & mask;
+		while(table[i]>=0 && (hashes[table[i]]!=hashes[c] || !equal(table[i],c)))
+			i = (i+1) & mask;
+		if(table[i]<0)
+			table[i] = c;
+		first[c] = table[i];
+	}
+	return first;
+}
+
+/**
+ * writes in 'positions' the literals of the cube 'c' as 2*variable (positive) or 2*variable+1 (negated),
+ * in order of variable
+ */
+void CubeSet::getLiterals(int c, vector<int>& positions) const{
+	positions.clear();
+	const uint64_t* w = cube(c);
+	for(int k=0; k<numWords; k++){
+		uint64_t missing = ~w[k];
+		while(missing){
+			positions.push_back(64*k + __builtin_ctzll(missing));
+			missing &= missing-1;
+		}
+	}
+}
+
+/**
+ * true if the cubes, all of 'numWords' words, cover every minterm (unate recursive paradigm):
+ * - a cover with a cube without literals is a tautology
+ * - a cover whose cubes hold less than 2^n minterms altogether isn't
+ * - the cubes with a literal of a unate variable (a variable appearing only in one form) can be dropped:
+ * 		a cover unate in every variable isn't a tautology
+ * - otherwise both the cofactors on the most binate variable must be tautologies
+ */
+static bool tautology(const vector<uint64_t>& cover, int numWords){
+	int n = cover.size()/numWords;
+	vector<int> count(64*numWords, 0);
+	double volume = 0;
+	for(int c=0; c<n; c++){
+		const uint64_t* w = &cover[(size_t)c*numWords];
+		int literals = 0;
+		for(int k=0; k<numWords; k++){
+			uint64_t missing = ~w[k];
+			while(missing){
+				count[64*k + __builtin_ctzll(missing)]++;
+				literals++;
+				missing &= missing-1;
+			}
+		}
+		if(literals==0)
+			return true;
+		volume += ldexp(1.0, -literals);
+	}
+	if(volume < 1)
+		return false;
+
+	int split = -1;
+	vector<uint64_t> unate(numWords, 0);
+	bool anyUnate = false;
+	for(int v=0; v<32*numWords; v++){
+		if(count[2*v]==0 && count[2*v+1]==0)
+			continue;
+		if(count[2*v]==0 || count[2*v+1]==0){
+			unate[v/32] |= 3ULL << (2*(v%32));
+			anyUnate = true;
+			continue;
+		}
+		if(split<0 || min(count[2*v],count[2*v+1]) > min(count[2*split],count[2*split+1])
+				|| (min(count[2*v],count[2*v+1]) == min(count[2*split],count[2*split+1])
+						&& count[2*v]+count[2*v+1] > count[2*split]+count[2*split+1]))
+			split = v;
+	}
+	if(split<0)
+		return false;
+
+	if(anyUnate){
+		vector<uint64_t> binate;
+		for(int c=0; c<n; c++){
+			const uint64_t* w = &cover[(size_t)c*numWords];
+			bool keep = true;
+			for(int k=0; k<numWords && keep; k++)
+				keep = (~w[k] & unate[k]) == 0;
+			if(keep)
+				binate.insert(binate.end(), w, w+numWords);
+		}
+		return tautology(binate, numWords);
+	}
+
+	//cofactors: the cubes admitting the value (the odd bit admits 1, the even one 0), without the variable
+	uint64_t field = 3ULL << (2*(split%32));
+	for(int value=1; value>=0; value--){
+		uint64_t admits = 1ULL << (2*(split%32) + value);
+		vector<uint64_t> cofactor;
+		cofactor.reserve(cover.size());
+		for(int c=0; c<n; c++){
+			const uint64_t* w = &cover[(size_t)c*numWords];
+			if((w[split/32] & admits) == 0)
+				continue;
+			cofactor.insert(cofactor.end(), w, w+numWords);
+			cofactor[cofactor.size()-numWords+split/32] |= field;
+		}
+		if(!tautology(cofactor, numWords))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * the cubes, all of 'numWords' words, covering the minterms that the cubes of 'cover' don't cover
+ * (unate recursive paradigm): the complement of a single cube is given by De Morgan's law, otherwise
+ * it's split on the most binate variable (or on the most frequent one) and the complements
+ * of the two cofactors are joined, each restricted to its value of the variable
+ */
+static void complement(const vector<uint64_t>& cover, int numWords, vector<uint64_t>& result){
+	int n = cover.size()/numWords;
+	if(n==0){
+		result.insert(result.end(), numWords, ~0ULL);
+		return;
+	}
+	vector<int> count(64*numWords, 0);
+	for(int c=0; c<n; c++){
+		const uint64_t* w = &cover[(size_t)c*numWords];
+		bool universal = true;
+		for(int k=0; k<numWords; k++){
+			uint64_t missing = ~w[k];
+			universal = universal && missing==0;
+			while(missing){
+				count[64*k + __builtin_ctzll(missing)]++;
+				missing &= missing-1;
+			}
+		}
+		if(universal)
+			return;
+	}
+	if(n==1){
+		for(int k=0; k<numWords; k++){
+			uint64_t missing = ~cover[k];
+			while(missing){
+				int bit = __builtin_ctzll(missing);
+				//the opposite literal: the variable only admits the value excluded by the cube
+				size_t first = result.size();
+				result.insert(result.end(), numWords, ~0ULL);
+				result[first+k] &= ~(1ULL << (bit^1));
+				missing &= missing-1;
+			}
+		}
+		return;
+	}
+
+	int split = -1;
+	bool binate = false;
+	for(int v=0; v<32*numWords; v++){
+		int both = min(count[2*v],count[2*v+1]), total = count[2*v]+count[2*v+1];
+		if(total==0)
+			continue;
+		if(split<0 || (both>0 && !binate) || (((both>0) == binate) &&
+				(both > min(count[2*split],count[2*split+1]) || (both == min(count[2*split],count[2*split+1])
+						&& total > count[2*split]+count[2*split+1])))){
+			split = v;
+			binate = both>0;
+		}
+	}
+
+	uint64_t field = 3ULL << (2*(split%32));
+	for(int value=1; value>=0; value--){
+		uint64_t admits = 1ULL << (2*(split%32) + value);
+		vector<uint64_t> cofactor;
+		cofactor.reserve(cover.size());
+		for(int c=0; c<n; c++){
+			const uint64_t* w = &cover[(size_t)c*numWords];
+			if((w[split/32] & admits) == 0)
+				continue;
+			cofactor.insert(cofactor.end(), w, w+numWords);
+			cofactor[cofactor.size()-numWords+split/32] |= field;
+		}
+		size_t first = result.size();
+		complement(cofactor, numWords, result);
+		for(size_t c=first; c<result.size(); c+=numWords)
+			result[c+split/32] &= ~field | admits;
+	}
+}
+
+/**
+ * Grows 'super' (an OR of cubes, all of 'numWords' words) so that it contains the minterms of the cube 'point'
+ * that the cubes of 'cover' (already restricted to 'point') don't cover: returns true if there are any
+ * (or if 'point' is already in 'super'). Splits like complement(), but the parts of 'point' already in 'super'
+ * are skipped.
+ */
+static bool uncoveredSupercube(const vector<uint64_t>& cover, int numWords, vector<uint64_t>& point, uint64_t* super){
+	//'point' can't make 'super' any bigger: whether it has uncovered minterms doesn't matter any more
+	bool inside = true;
+	for(int k=0; k<numWords && inside; k++)
+		inside = (point[k] & ~super[k]) == 0;
+	if(inside)
+		return true;
+	int n = cover.size()/numWords;
+	if(n==0){
+		for(int k=0; k<numWords; k++)
+			super[k] |= point[k];
+		return true;
+	}
+	vector<int> count(64*numWords, 0);
+	for(int c=0; c<n; c++){
+		const uint64_t* w = &cover[(size_t)c*numWords];
+		bool universal = true;
+		for(int k=0; k<numWords; k++){
+			uint64_t missing = ~w[k];
+			universal = universal && missing==0;
+			while(missing){
+				count[64*k + __builtin_ctzll(missing)]++;
+				missing &= missing-1;
+			}
+		}
+		if(universal)
+			return false;
+	}
+	if(n==1){
+		//De Morgan: the parts of 'point' with a literal of the cube negated
+		for(int k=0; k<numWords; k++){
+			uint64_t missing = ~cover[k];
+			while(missing){
+				int bit = __builtin_ctzll(missing);
+				for(int j=0; j<numWords; j++)
+					super[j] |= j==k? point[j] & ~(1ULL << (bit^1)) : point[j];
+				missing &= missing-1;
+			}
+		}
+		return true;
+	}
+
+	int split = -1;
+	for(int v=0; v<32*numWords; v++){
+		int both = min(count[2*v],count[2*v+1]), total = count[2*v]+count[2*v+1];
+		if(total==0)
+			continue;
+		if(split<0 || both > min(count[2*split],count[2*split+1])
+				|| (both == min(count[2*split],count[2*split+1]) && total > count[2*split]+count[2*split+1]))
+			split = v;
+	}
+
+	//on a unate variable, the value making its literal false comes first: the minterms uncovered with the other
+	//value are uncovered with this one too, so they only add that value to 'super' (if there are any)
+	bool unate = min(count[2*split],count[2*split+1]) == 0;
+	int first = count[2*split]==0? 1 : 0;
+	bool found = false;
+	uint64_t field = 3ULL << (2*(split%32));
+	for(int value=first, i=0; i<2; value=1-value, i++){
+		uint64_t admits = 1ULL << (2*(split%32) + value);
+		vector<uint64_t> cofactor;
+		cofactor.reserve(cover.size());
+		for(int c=0; c<n; c++){
+			const uint64_t* w = &cover[(size_t)c*numWords];
+			if((w[split/32] & admits) == 0)
+				continue;
+			cofactor.insert(cofactor.end(), w, w+numWords);
+			cofactor[cofactor.size()-numWords+split/32] |= field;
+		}
+		if(unate && i==1){
+			if(found && (super[split/32] & admits) == 0 && !tautology(cofactor, numWords))
+				super[split/32] |= admits;
+			break;
+		}
+		uint64_t saved = point[split/32];
+		point[split/32] &= ~field | admits;
+		found = uncoveredSupercube(cofactor, numWords, point, super) || found;
+		point[split/32] = saved;
+	}
+	return found;
+}
+
+/**
+ * writes in 'super' the smallest cube containing the minterms of the cube 'w' that the cubes of the set
+ * don't cover: returns false if there aren't any
+ */
+bool CubeSet::uncoveredSupercube(const uint64_t* w, uint64_t* super) const{
+	vector<uint64_t> cofactor;
+	vector<uint64_t> buffer(numWords);
+	for(int c=0; c<size(); c++){
+		if(!kernels->intersect(cube(c), w, &buffer[0], numWords))
+			continue;
+		for(int k=0; k<numWords; k++)
+			cofactor.push_back(cube(c)[k] | ~w[k]);
+	}
+	vector<uint64_t> point(w, w+numWords);
+	fill(super, super+numWords, 0);
+	return ::uncoveredSupercube(cofactor, numWords, point, super);
+}
+
+/**
+ * the set of cubes covering the minterms not covered by this set
+ */
+CubeSet CubeSet::complement() const{
+	CubeSet result(numVars);
+	::complement(words, numWords, result.words);
+	return result;
+}
+
+/**
+ * true if the cubes of the set (but the cube 'except') cover the cube 'w':
+ * i.e. if their cofactor with respect to 'w' is a tautology
+ */
+bool CubeSet::covers(const uint64_t* w, int except) const{
+	vector<uint64_t> cofactor;
+	vector<uint64_t> buffer(numWords);
+	for(int c=0; c<size(); c++){
+		if(c==except || !kernels->intersect(cube(c), w, &buffer[0], numWords))
+			continue;
+		//the variables of 'w' leave the cube
+		for(int k=0; k<numWords; k++)
+			cofactor.push_back(cube(c)[k] | ~w[k]);
+	}
+	return tautology(cofactor, numWords);
+}
@@ -0,0 +1,100 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * DependencyGraph.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "entities.h"
+
+/**
+ * adds the node of the signal 's' (or returns it, if it's already in the graph)
+ */
+ListDigraph::Node DependencyGraph::addNode(symbol s){
+	if(s >= this->nodes.size())
+		this->nodes.resize(s+1, INVALID);
+	if(this->nodes[s] == INVALID){
+		this->nodes[s] = ListDigraph::addNode();
+		this->names[this->nodes[s]] = s;
+	}
+	return this->nodes[s];
+}
+
+/**
+ * removes the node 'n' (and its arcs) from the graph and from the index
+ */
+void DependencyGraph::erase(ListDigraph::Node n){
+	this->nodes[this->names[n]] = INVALID;
+	ListDigraph::erase(n);
+}
+
+void DependencyGraph::clear(){
+	ListDigraph::clear();
+	this->nodes.clear();
+}
+
+/**
+ * copies the graph 'g': nodes are numbered in the order the list graph iterates them,
+ * the arcs leaving a node keep their order too, the arcs entering a node are sorted by source
+ */
+void FrozenGraph::build(const DependencyGraph& g){
+	clear();
+	ListDigraph::NodeMap<int> index(g);
+	for(ListDigraph::NodeIt n(g); n != INVALID; ++n){
+		index[n] = this->names.size();
+		this->names.push_back(g.name(n));
+		if(g.name(n) >= this->nodes.size())
+			this->nodes.resize(g.name(n)+1, -1);
+		this->nodes[g.name(n)] = index[n];
+	}
+
+	int numNodes = this->names.size();
+	this->outBegin.reserve(numNodes+1);
+	this->targets.reserve(countArcs(g));
+	this->inBegin.assign(numNodes+1, 0);
+	for(ListDigraph::NodeIt n(g); n != INVALID; ++n){
+		this->outBegin.push_back(this->targets.size());
+		for(ListDigraph::OutArcIt a(g, n); a != INVALID; ++a){
+			this->targets.push_back(index[g.target(a)]);
+			this->inBegin[index[g.target(a)]+1]++;
+		}
+	}
+	this->outBegin.push_back(this->targets.size());
+
+	//the in-adjacency is the transpose of the out-adjacency
+	for(int v=0; v<numNodes; v++)
+		this->inBegin[v+1] += this->inBegin[v];
+	this->sources.resize(this->targets.size());
+	vector<int> next(this->inBegin.begin(), this->inBegin.end()-1);
+	for(int v=0; v<numNodes; v++)
+		for(int k=this->outBegin[v]; k<this->outBegin[v+1]; k++)
+			this->sources[next[this->targets[k]]++] = v;
+}
+
+void FrozenGraph::clear(){
+	this->names.clear();
+	this->nodes.clear();
+	this->outBegin.clear();
+	this->targets.clear();
+	this->inBegin.clear();
+	this->sources.clear();
+}
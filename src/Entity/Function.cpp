@@ -26,90 +26,153 @@
  */
 
 #include "entities.h"
+#include "my_utils.h"
 #include <iostream>
 #include <cstring>
 #include <set>
+#include <iterator>
+#include <algorithm>
+#include <unordered_map>
 
-void Function::addInputs(vector<string> s){
-	for(vector<string>::const_iterator i = s.begin(); i!= s.end(); i++){
+void Function::addInputs(vector<literal> l){
+	for(vector<literal>::const_iterator i = l.begin(); i!= l.end(); i++){
 		this->inputs.push_back(*i);
 	}
 }
 
-void Function::addOutputs(vector<string> s){
-	for(vector<string>::const_iterator i = s.begin(); i!= s.end(); i++){
+void Function::addOutputs(vector<symbol> s){
+	for(vector<symbol>::const_iterator i = s.begin(); i!= s.end(); i++){
 		this->outputs.push_back(*i);
 	}
 }
 
-void Function::printInput(){
-	for(vector<string>::const_iterator i = this->inputs.begin(); i != this->inputs.end(); ++i) {
-		cout << *i << " ";
+void Function::printInput(ostream& out){
+	for(vector<literal>::const_iterator i = this->inputs.begin(); i != this->inputs.end(); ++i) {
+		out << signalTable().literalName(*i) << " ";
 	}
 }
 
-void Function::printOutput(){
-	for(vector<string>::const_iterator i = this->outputs.begin(); i != this->outputs.end(); ++i) {
-		cout << *i << " ";
+void Function::printOutput(ostream& out){
+	for(vector<symbol>::const_iterator i = this->outputs.begin(); i != this->outputs.end(); ++i) {
+		out << signalTable().name(*i) << " ";
 	}
 }
 
-void Function::printFunction(){
-	string prec("");
-	for(multimap<string,vector<string> >::const_iterator i = this->minterms.begin(); i != this->minterms.end(); ++i) {
-		if(i->first != prec)
-			cout << endl <<i->first << "=(";
+void Function::printFunction(ostream& out){
+	MintermView minterms = getMinterms();
+	for(MintermView::const_iterator i = minterms.begin(), previous = minterms.end(); i != minterms.end(); previous = i, ++i) {
+		if(previous == minterms.end() || i->first != previous->first)
+			out << endl << signalTable().name(i->first) << "=(";
 		else
-			cout << "+(";
-		prec = i->first;
-		for(vector<string>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
+			out << "+(";
+		for(vector<literal>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
 			if(j+1 != i->second.end())
-				cout << *j << "*";
+				out << signalTable().literalName(*j) << "*";
 			else
-				cout << *j<<")";
+				out << signalTable().literalName(*j)<<")";
 		}
 	}
 }
 
-void Function::addMinterm(string out,string minterm){
-	vector<string> v;
-	char* pch = strtok ((char*)minterm.c_str()," ");
-	while (pch != NULL)
-	{
-		v.push_back(string(pch));
-		pch = strtok (NULL, " ");
-	}
-	this->minterms.insert(make_pair(out,v));
+void Function::addMinterm(symbol out,const vector<literal>& literals){
+	//minterms usually come grouped by output, in order of definition: hint the end
+	this->minterms.insert(this->minterms.end(),make_pair(out,literals));
 }
 
-map<string, int> Function::countLiterals(){
-	set<string> counter;
+/**
+ * Builds the cube form of a two-level function: its variables are the inputs (in order of first appearance)
+ * and each minterm becomes a cube, in the same order as 'minterms'
+ */
+void Function::buildCubes(){
+	unordered_map<symbol,int> variableOf;
+	this->variables.clear();
+	for(vector<literal>::const_iterator i = this->inputs.begin(); i != this->inputs.end(); ++i)
+		if(variableOf.insert(make_pair(symbolOf(*i),(int)this->variables.size())).second)
+			this->variables.push_back(symbolOf(*i));
+	//literals which aren't inputs still get their own variable
+	MintermView minterms = getMinterms();
+	for(MintermView::const_iterator i = minterms.begin(); i != minterms.end(); ++i)
+		for(vector<literal>::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
+			if(variableOf.insert(make_pair(symbolOf(*j),(int)this->variables.size())).second)
+				this->variables.push_back(symbolOf(*j));
 
-	for(multimap<string,vector<string> >::const_iterator i = this->minterms.begin(); i != this->minterms.end(); ++i) {
-		string minterm;
+	this->cubes = CubeSet(this->variables.size());
+	this->cubeOutputs.clear();
+	for(MintermView::const_iterator i = minterms.begin(); i != minterms.end(); ++i) {
+		int c = this->cubes.addCube();
+		for(vector<literal>::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
+			this->cubes.addLiteral(c, variableOf[symbolOf(*j)], isNegated(*j));
+		this->cubeOutputs.push_back(i->first);
+	}
+}
 
-		for(vector<string>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			if(j+1 != i->second.end())
-				minterm+=*j+"*";
-			else
-				minterm+=*j;
+/**
+ * writes in 'literals' the literals of the cube 'c' (in order of variable)
+ */
+void Function::getCubeLiterals(int c, vector<literal>& literals) const{
+	vector<int> positions;
+	this->cubes.getLiterals(c, positions);
+	literals.clear();
+	for(vector<int>::const_iterator i = positions.begin(); i != positions.end(); ++i)
+		literals.push_back(makeLiteral(this->variables[*i/2], (*i%2)!=0));
+}
+
+/**
+ * Evaluates the two-level function on 64*'words' input vectors at a time: 'values' holds, for each signal
+ * (indexed by symbol), 'words' words with a bit per vector. The value of each output (in order of output)
+ * is written in 'outputs', 'words' words each.
+ */
+void Function::evaluate(const uint64_t* values, int words, uint64_t* outputs) const{
+	unordered_map<symbol,int> outputOf;
+	for(size_t k=0; k<this->outputs.size(); k++)
+		outputOf.insert(make_pair(this->outputs[k],(int)k));
+	fill(outputs, outputs+this->outputs.size()*words, 0);
+	vector<uint64_t> product(words);
+	vector<literal> literals;
+	for(int c=0; c<this->cubes.size(); c++){
+		fill(product.begin(), product.end(), ~0ULL);
+		getCubeLiterals(c, literals);
+		for(vector<literal>::const_iterator l = literals.begin(); l != literals.end(); ++l){
+			const uint64_t* v = &values[(size_t)symbolOf(*l)*words];
+			uint64_t flip = isNegated(*l)? ~0ULL : 0;
+			for(int w=0; w<words; w++)
+				product[w] &= v[w] ^ flip;
 		}
+		uint64_t* out = &outputs[(size_t)outputOf[this->cubeOutputs[c]]*words];
+		for(int w=0; w<words; w++)
+			out[w] |= product[w];
+	}
+}
 
-		pair<set<string>::iterator,bool> result = counter.insert(minterm);
-		if(result.second){
-			for(vector<string>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
-				map<string, int>::iterator it = this->literalCount.find(*j);
-				if(it != this->literalCount.end())
-					(*it).second++;
-				else
-					this->literalCount.insert(pair<string,int>(*j,1));
+/**
+ * counts the occurrences of each literal within the distinct cubes of the two-level function:
+ * the literals of a cube are the zero bits of its words
+ */
+map<literal, int> Function::countLiterals(){
+	vector<int> first = this->cubes.firstOccurrences();
+	vector<int> counter(2*this->cubes.getNumWords()*32, 0);
+
+	for(int c=0; c<this->cubes.size(); c++){
+		if(first[c]!=c)
+			continue;
+		const uint64_t* w = this->cubes.cube(c);
+		for(int k=0; k<this->cubes.getNumWords(); k++){
+			uint64_t missing = ~w[k];
+			while(missing){
+				counter[64*k + __builtin_ctzll(missing)]++;
+				missing &= missing-1;
 			}
 		}
-
 	}
 
+	this->literalCount.clear();
+	for(size_t v=0; v<this->variables.size(); v++){
+		if(counter[2*v]>0)
+			this->literalCount[makeLiteral(this->variables[v])] = counter[2*v];
+		if(counter[2*v+1]>0)
+			this->literalCount[makeLiteral(this->variables[v],true)] = counter[2*v+1];
+	}
 	return this->literalCount;
-
 }
 
 int Function::getNumInput(){
@@ -121,30 +184,124 @@ int Function::getNumOutput(){
 }
 
 int Function::getNumMinterms(){
-	return this->minterms.size();
+	return getMinterms().size();
 }
 
+/**
+ * number of distinct cubes of the two-level function
+ */
 int Function::getNumMinterms_NoDuplicate(){
-	//a set can't contain duplicates
-	set<string> counter;
+	vector<int> first = this->cubes.firstOccurrences();
+	int n = 0;
+	for(int c=0; c<(int)first.size(); c++)
+		if(first[c]==c)
+			n++;
+	return n;
+}
 
-	for(multimap<string,vector<string> >::const_iterator i = this->minterms.begin(); i != this->minterms.end(); ++i) {
-		string minterm;
+/**
+ * number of memristors of the crossbar implementing the two-level function: one for each input in the IL row,
+ * one for each literal and for each output of a distinct cube in its row, two in each output row
+ */
+int Function::getNumMemristors(){
+	vector<int> first = this->cubes.firstOccurrences();
+	set<pair<int,symbol> > rowOutputs;
+	int n = this->inputs.size() + 2*this->outputs.size();
+	for(int c=0; c<(int)first.size(); c++){
+		if(first[c]==c)
+			n += this->cubes.literalCount(c);
+		if(rowOutputs.insert(make_pair(first[c],this->cubeOutputs[c])).second)
+			n++;
+	}
+	return n;
+}
 
-		for(vector<string>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			if(j+1 != i->second.end())
-				minterm+=*j+"*";
-			else
-				minterm+=*j;
-		}
+map<literal, int> Function::getLiteralCount(){
+	return this->literalCount;
+}
 
-		counter.insert(minterm);
+/**
+ * two functions are equal if they have the same inputs, outputs and minterms (in the same order)
+ */
+bool Function::operator==(const Function& f) const{
+	return this->inputs == f.inputs && this->outputs == f.outputs && getMinterms() == f.getMinterms();
+}
 
+/**
+ * Canonical form of the two-level function up to a renaming of its signals: each input and each output
+ * is replaced by its position and the cubes (each one with the position of its output) are sorted.
+ * Two functions with the same form compute the same outputs from the same inputs, taken in order.
+ */
+string Function::canonicalForm() const{
+	string form;
+	unordered_map<symbol,int> variableOf;
+	int count = this->variables.size();
+	appendBytes(&form, &count, sizeof(int));
+	for(int v=0; v<count; v++)
+		variableOf[this->variables[v]] = v;
+	count = this->inputs.size();
+	appendBytes(&form, &count, sizeof(int));
+	for(vector<literal>::const_iterator i = this->inputs.begin(); i != this->inputs.end(); ++i){
+		int in = 2*variableOf[symbolOf(*i)] + (isNegated(*i)? 1 : 0);
+		appendBytes(&form, &in, sizeof(int));
 	}
+	unordered_map<symbol,int> outputOf;
+	count = this->outputs.size();
+	appendBytes(&form, &count, sizeof(int));
+	for(int o=0; o<count; o++)
+		outputOf[this->outputs[o]] = o;
 
-	return counter.size();
+	vector<string> cubes(this->cubes.size());
+	size_t cubeBytes = this->cubes.getNumWords()*sizeof(uint64_t);
+	for(int c=0; c<this->cubes.size(); c++){
+		int o = outputOf[this->cubeOutputs[c]];
+		appendBytes(&cubes[c], &o, sizeof(int));
+		appendBytes(&cubes[c], this->cubes.cube(c), cubeBytes);
+	}
+	sort(cubes.begin(), cubes.end());
+	count = cubes.size();
+	appendBytes(&form, &count, sizeof(int));
+	for(vector<string>::const_iterator c = cubes.begin(); c != cubes.end(); ++c)
+		form += *c;
+	return form;
 }
 
-map<string, int> Function::getLiteralCount(){
-	return this->literalCount;
+/**
+ * view over the minterms of the outputs 'outs' of a function owning its minterms
+ */
+MintermView Function::getMinterms(vector<symbol> outs) const{
+	sort(outs.begin(), outs.end());
+	MintermView view;
+	for(vector<symbol>::const_iterator o = outs.begin(); o != outs.end(); ++o)
+		view.addOutput(this->minterms, *o);
+	return view;
+}
+
+/**
+ * adds to the view the minterms of the output 'out' of 'm' (they're contiguous, since 'm' is sorted by output).
+ * Adding the outputs in order is cheaper: the span goes at the end.
+ */
+void MintermView::addOutput(const multimap<symbol,vector<literal> >& m, symbol out){
+	pair<span_iterator,span_iterator> range = m.equal_range(out);
+	if(range.first == range.second)
+		return;
+	if(this->spans.empty() || this->spans.back().first->first < out)
+		this->spans.push_back(range);
+	else
+		this->spans.insert(upper_bound(this->spans.begin(), this->spans.end(), range,
+				[](const pair<span_iterator,span_iterator>& x, const pair<span_iterator,span_iterator>& y){return x.first->first < y.first->first;}),
+				range);
+	this->count += distance(range.first, range.second);
+}
+
+/**
+ * two views are equal if they have the same minterms in the same order
+ */
+bool MintermView::operator==(const MintermView& v) const{
+	if(this->count != v.count)
+		return false;
+	for(const_iterator i = begin(), j = v.begin(); i != end(); ++i, ++j)
+		if(*i != *j)
+			return false;
+	return true;
 }
@@ -0,0 +1,217 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Minimize.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "entities.h"
+#include <algorithm>
+
+/**
+ * total number of literals of the cubes
+ */
+static int coverLiterals(const CubeSet& f){
+	int n = 0;
+	for(int c=0; c<f.size(); c++)
+		n += f.literalCount(c);
+	return n;
+}
+
+/**
+ * copy of the cubes sorted by number of literals: the biggest cubes (fewest literals) first,
+ * or the smallest ones first
+ */
+static CubeSet sortByLiterals(const CubeSet& f, bool biggestFirst){
+	vector<pair<int,int> > order;
+	for(int c=0; c<f.size(); c++)
+		order.push_back(make_pair(biggestFirst? f.literalCount(c) : -f.literalCount(c), c));
+	stable_sort(order.begin(), order.end());
+	CubeSet sorted(f.getNumVars());
+	for(size_t i=0; i<order.size(); i++)
+		sorted.addCube(f.cube(order[i].second));
+	return sorted;
+}
+
+/**
+ * true if the cube 'w' intersects one of the cubes of 'offset'
+ */
+static bool hitsOffset(const CubeSet& offset, const uint64_t* w, uint64_t* buffer){
+	for(int c=0; c<offset.size(); c++)
+		if(CubeSet::intersect(offset.cube(c), w, buffer, offset.getNumWords()))
+			return true;
+	return false;
+}
+
+/**
+ * EXPAND: each cube (the biggest ones first) loses every literal it can lose while it doesn't
+ * intersect the complement of the function ('offset'); then the cubes it contains are dropped.
+ * A cube keeps at least one literal, since a crossbar row needs an input memristor.
+ */
+static CubeSet expand(const CubeSet& cover, const CubeSet& offset){
+	CubeSet f = sortByLiterals(cover, true);
+	CubeSet expanded(f.getNumVars());
+	int numWords = f.getNumWords();
+	vector<bool> dropped(f.size(), false);
+	vector<uint64_t> raised(numWords), buffer(numWords);
+	vector<int> positions;
+	for(int c=0; c<f.size(); c++){
+		if(dropped[c])
+			continue;
+		copy(f.cube(c), f.cube(c)+numWords, raised.begin());
+		f.getLiterals(c, positions);
+		int literals = positions.size();
+		for(vector<int>::const_iterator p = positions.begin(); p != positions.end() && literals>1; ++p){
+			//setting the missing bit gives the variable both the values back
+			uint64_t bit = 1ULL << (*p%64);
+			raised[*p/64] |= bit;
+			if(hitsOffset(offset, &raised[0], &buffer[0]))
+				raised[*p/64] &= ~bit;
+			else
+				literals--;
+		}
+		expanded.addCube(&raised[0]);
+		for(int d=c; d<f.size(); d++)
+			if(!dropped[d] && CubeSet::contains(&raised[0], f.cube(d), numWords))
+				dropped[d] = true;
+	}
+	return expanded;
+}
+
+/**
+ * IRREDUNDANT: drops, one at a time, the cubes covered by the remaining ones
+ * (the smallest cubes are the first ones to be tried)
+ */
+static void irredundant(CubeSet& cover){
+	CubeSet f = sortByLiterals(cover, false);
+	for(int c=0; c<f.size(); ){
+		if(f.covers(f.cube(c), c))
+			f.removeCube(c);
+		else
+			c++;
+	}
+	cover = f;
+}
+
+/**
+ * REDUCE: each cube (the biggest ones first) shrinks to the smallest cube containing
+ * the minterms that the other cubes don't cover
+ */
+static void reduce(CubeSet& cover){
+	CubeSet f = sortByLiterals(cover, true);
+	vector<uint64_t> super(f.getNumWords());
+	for(int c=0; c<f.size(); c++){
+		//only the cubes intersecting 'c' can cover a part of it
+		CubeSet others(f.getNumVars());
+		for(int d=0; d<f.size(); d++)
+			if(d!=c && f.intersects(c,d))
+				others.addCube(f.cube(d));
+		if(others.uncoveredSupercube(f.cube(c), &super[0]))
+			copy(super.begin(), super.end(), f.cube(c));
+	}
+	cover = f;
+}
+
+/**
+ * Espresso-style heuristic minimization of a single-output cover (without don't cares):
+ * the complement is computed once, then expand and irredundant, then reduce, expand and irredundant
+ * as long as the number of cubes (or of literals) decreases
+ */
+static CubeSet espresso(const CubeSet& onset){
+	CubeSet offset = onset.complement();
+	CubeSet best = expand(onset, offset);
+	irredundant(best);
+	while(true){
+		CubeSet f = best;
+		reduce(f);
+		f = expand(f, offset);
+		irredundant(f);
+		if(f.size() > best.size() || (f.size() == best.size() && coverLiterals(f) >= coverLiterals(best)))
+			return best;
+		best = f;
+	}
+}
+
+/**
+ * Minimizes the two-level function: each output is minimized on its own and the cubes of the outputs
+ * are put back together (equal cubes are still shared by different outputs).
+ * The minimized cubes replace both the cubes and the minterms, unless they'd give a crossbar with more
+ * rows or more memristors (e.g. when a cube shared by some outputs is expanded differently for each of them).
+ */
+void Function::minimize(){
+	CubeSet minimized(this->cubes.getNumVars());
+	vector<symbol> minimizedOutputs;
+	vector<bool> done(this->cubes.size(), false);
+	for(int c=0; c<this->cubes.size(); c++){
+		if(done[c])
+			continue;
+		symbol out = this->cubeOutputs[c];
+		CubeSet onset(this->cubes.getNumVars());
+		for(int d=c; d<this->cubes.size(); d++){
+			if(this->cubeOutputs[d] != out)
+				continue;
+			done[d] = true;
+			//an empty cube (a literal and its negation) doesn't add anything to the output
+			if(!this->cubes.isEmpty(d))
+				onset.addCube(this->cubes.cube(d));
+		}
+		CubeSet f = espresso(onset);
+		for(int d=0; d<f.size(); d++){
+			minimized.addCube(f.cube(d));
+			minimizedOutputs.push_back(out);
+		}
+	}
+
+	int rows = getNumMinterms_NoDuplicate();
+	int memristors = getNumMemristors();
+	swap(this->cubes, minimized);
+	swap(this->cubeOutputs, minimizedOutputs);
+	if(getNumMinterms_NoDuplicate() > rows || (getNumMinterms_NoDuplicate() == rows && getNumMemristors() >= memristors)){
+		swap(this->cubes, minimized);
+		swap(this->cubeOutputs, minimizedOutputs);
+		return;
+	}
+
+	mintermsFromCubes();
+}
+
+/**
+ * Replaces the cubes of the function (over its variables) with 'cubes', the cube 'c' being of the output 'outputs[c]'
+ */
+void Function::setCubes(CubeSet cubes, vector<symbol> outputs){
+	this->cubes = move(cubes);
+	this->cubeOutputs = move(outputs);
+	mintermsFromCubes();
+}
+
+/**
+ * the minterms follow the cubes (a view stops referring to the function it's taken from)
+ */
+void Function::mintermsFromCubes(){
+	this->minterms.clear();
+	this->isView = false;
+	vector<literal> literals;
+	for(int c=0; c<this->cubes.size(); c++){
+		getCubeLiterals(c, literals);
+		addMinterm(this->cubeOutputs[c], literals);
+	}
+}
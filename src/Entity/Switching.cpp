@@ -0,0 +1,342 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Switching.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "entities.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <random>
+#include <climits>
+#include <set>
+
+/**
+ * The function as the switching engines see it: only the variables used by the cubes (renumbered from 0),
+ * the NAND memristors switching for each value of each variable and the literals of the distinct cubes of each output
+ * which aren't empty
+ */
+struct switchingModel{
+	vector<int> variables;	//variable of the function of each one
+	vector<int> nandIfZero;	//positive literals of the variable in the distinct cubes (they're 0 when it's 0)
+	vector<int> nandIfOne;	//negative literals of the variable in the distinct cubes
+	vector< vector<int> > cubes;	//literals of the cube of each output memristor: 2*variable, +1 if negated
+	vector< vector<int> > occurrences;	//literals of each variable: 2*cube, +1 if negated
+};
+
+/**
+ * an input vector and the memristors it makes switch
+ */
+struct switchingCase{
+	int value;
+	vector<char> x;
+};
+
+static const int numRestarts = 16;
+static const uint64_t blocksPerChunk = 1024;
+
+/**
+ * number of memristors switching for the input vector 'x'
+ */
+static int switchingOf(const switchingModel& m, const vector<char>& x){
+	int n = 0;
+	for(size_t v=0; v<m.variables.size(); v++)
+		n += x[v]? m.nandIfOne[v] : m.nandIfZero[v];
+	for(vector< vector<int> >::const_iterator c = m.cubes.begin(); c != m.cubes.end(); ++c){
+		bool on = true;
+		for(vector<int>::const_iterator l = c->begin(); on && l != c->end(); ++l)
+			on = (x[*l/2]!=0) != (*l%2!=0);
+		n += on? 1 : 0;
+	}
+	return n;
+}
+
+/**
+ * Exhaustive search over the vectors from 64*'first' to 64*'last' (excluded), 64 at a time: the lowest variables
+ * (up to 6) take a different value on each of the 64 lanes of a word, the others are the same on all of them.
+ * The memristors switching on each lane are counted by a bit-sliced adder (a word for each bit of the counts),
+ * so that the lanes with the most and the fewest of them are found with a word operation per bit.
+ * The first vector of the most (fewest) switching ones goes to 'worst' ('best'), as an index (bit v: variable v).
+ */
+static void exhaustiveRange(const switchingModel& m, uint64_t first, uint64_t last,
+		pair<int,uint64_t>* worst, pair<int,uint64_t>* best){
+	static const uint64_t laneOf[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+			0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+	int n = m.variables.size();
+	int low = min(n,6);
+	int lanes = 1<<low;
+
+	//the lanes of each cube and the values it needs on the other variables
+	vector<uint64_t> lowMask(m.cubes.size(), ~0ULL);
+	vector<uint64_t> highCare(m.cubes.size(), 0), highValue(m.cubes.size(), 0);
+	for(size_t c=0; c<m.cubes.size(); c++)
+		for(vector<int>::const_iterator l = m.cubes[c].begin(); l != m.cubes[c].end(); ++l){
+			int v = *l/2;
+			bool negated = *l%2!=0;
+			if(v<low)
+				lowMask[c] &= negated? ~laneOf[v] : laneOf[v];
+			else{
+				highCare[c] |= 1ULL<<(v-low);
+				highValue[c] |= negated? 0 : 1ULL<<(v-low);
+			}
+		}
+	//NAND memristors switching on each lane for the lowest variables: the adder starts from them
+	vector<int> lowNand(lanes, 0);
+	for(int lane=0; lane<lanes; lane++)
+		for(int v=0; v<low; v++)
+			lowNand[lane] += ((lane>>v)&1)? m.nandIfOne[v] : m.nandIfZero[v];
+	int bits = 1;
+	while((1ULL<<bits) <= *max_element(lowNand.begin(), lowNand.end()) + m.cubes.size())
+		bits++;
+	vector<uint64_t> lowPlanes(bits, 0);
+	for(int lane=0; lane<lanes; lane++)
+		for(int k=0; k<bits; k++)
+			lowPlanes[k] |= (uint64_t)((lowNand[lane]>>k)&1)<<lane;
+	uint64_t validLanes = lanes==64? ~0ULL : (1ULL<<lanes)-1;
+	vector<uint64_t> planes(bits);
+
+	for(uint64_t b=first; b<last; b++){
+		int highNand = 0;
+		for(int v=low; v<n; v++)
+			highNand += ((b>>(v-low))&1)? m.nandIfOne[v] : m.nandIfZero[v];
+		planes = lowPlanes;
+		for(size_t c=0; c<m.cubes.size(); c++){
+			if((b & highCare[c]) != highValue[c])
+				continue;
+			uint64_t carry = lowMask[c];
+			for(int k=0; carry && k<bits; k++){
+				uint64_t t = planes[k] & carry;
+				planes[k] ^= carry;
+				carry = t;
+			}
+		}
+		//the lanes with the highest (lowest) count are found from the most significant bit down
+		uint64_t most = validLanes, fewest = validLanes;
+		int mostValue = 0, fewestValue = 0;
+		for(int k=bits-1; k>=0; k--){
+			if(most & planes[k]){
+				most &= planes[k];
+				mostValue |= 1<<k;
+			}
+			if(fewest & ~planes[k])
+				fewest &= ~planes[k];
+			else
+				fewestValue |= 1<<k;
+		}
+		if(highNand + mostValue > worst->first)
+			*worst = make_pair(highNand + mostValue, (b<<low) | __builtin_ctzll(most));
+		if(highNand + fewestValue < best->first)
+			*best = make_pair(highNand + fewestValue, (b<<low) | __builtin_ctzll(fewest));
+	}
+}
+
+/**
+ * Hill climbing from the vector 'start': the variable whose flip makes the most (fewest, if not 'maximize')
+ * memristors switch is flipped, until no flip improves it. The gain of each flip is kept up to date
+ * through the number of literals of each cube which are 0.
+ */
+static switchingCase localSearch(const switchingModel& m, vector<char> start, bool maximize){
+	int n = m.variables.size();
+	switchingCase result;
+	result.x = move(start);
+	vector<int> zeros(m.cubes.size(), 0);
+	for(size_t c=0; c<m.cubes.size(); c++)
+		for(vector<int>::const_iterator l = m.cubes[c].begin(); l != m.cubes[c].end(); ++l)
+			zeros[c] += ((result.x[*l/2]!=0) != (*l%2!=0))? 0 : 1;
+	result.value = switchingOf(m, result.x);
+	int sign = maximize? 1 : -1;
+	while(true){
+		int bestGain = 0, bestVariable = -1;
+		for(int v=0; v<n; v++){
+			int gain = result.x[v]? m.nandIfZero[v]-m.nandIfOne[v] : m.nandIfOne[v]-m.nandIfZero[v];
+			for(vector<int>::const_iterator o = m.occurrences[v].begin(); o != m.occurrences[v].end(); ++o){
+				bool on = (result.x[v]!=0) != (*o%2!=0);
+				if(on && zeros[*o/2]==0)
+					gain--;
+				else if(!on && zeros[*o/2]==1)
+					gain++;
+			}
+			if(sign*gain>bestGain){
+				bestGain = sign*gain;
+				bestVariable = v;
+			}
+		}
+		if(bestVariable<0)
+			break;
+		for(vector<int>::const_iterator o = m.occurrences[bestVariable].begin(); o != m.occurrences[bestVariable].end(); ++o){
+			bool on = (result.x[bestVariable]!=0) != (*o%2!=0);
+			zeros[*o/2] += on? 1 : -1;
+		}
+		result.x[bestVariable] = !result.x[bestVariable];
+		result.value += sign*bestGain;
+	}
+	return result;
+}
+
+/**
+ * Computes the worst and best case switching activity of the crossbar of the two-level function (see SwitchingActivity).
+ * Up to maxExactVariables variables used by the cubes, all the input vectors are tried (on 'jobs' threads);
+ * with more variables, a local search starts from the greedy choice (each variable set to the value which
+ * makes the most, or fewest, NAND memristors switch) and from random vectors (on 'jobs' threads).
+ * On equal activity, the first vector (or the first search) wins, so the result doesn't depend on 'jobs'.
+ */
+SwitchingActivity Function::switchingActivity(int jobs) const{
+	//the model keeps the variables with a literal in some cube
+	switchingModel m;
+	vector<int> first = this->cubes.firstOccurrences();
+	vector<int> modelOf(this->cubes.getNumVars(), -1);
+	vector<int> positions;
+	//an output memristor per distinct cube of each output (as in getNumMemristors)
+	set<pair<int,symbol> > rowOutputs;
+	for(int c=0; c<this->cubes.size(); c++){
+		if(!rowOutputs.insert(make_pair(first[c],this->cubeOutputs[c])).second || this->cubes.isEmpty(c))
+			continue;
+		this->cubes.getLiterals(c, positions);
+		vector<int> literals;
+		for(vector<int>::const_iterator p = positions.begin(); p != positions.end(); ++p){
+			int v = *p/2;
+			if(modelOf[v]<0){
+				modelOf[v] = m.variables.size();
+				m.variables.push_back(v);
+				m.nandIfZero.push_back(0);
+				m.nandIfOne.push_back(0);
+				m.occurrences.push_back(vector<int>());
+			}
+			literals.push_back(2*modelOf[v] + *p%2);
+			m.occurrences[modelOf[v]].push_back(2*m.cubes.size() + *p%2);
+		}
+		m.cubes.push_back(literals);
+	}
+	//NAND memristors are counted on the distinct cubes, empty ones included (as the crossbar has them)
+	for(int c=0; c<this->cubes.size(); c++){
+		if(first[c]!=c)
+			continue;
+		this->cubes.getLiterals(c, positions);
+		for(vector<int>::const_iterator p = positions.begin(); p != positions.end(); ++p){
+			int v = modelOf[*p/2];
+			if(v<0){
+				//a variable only found in empty cubes
+				v = modelOf[*p/2] = m.variables.size();
+				m.variables.push_back(*p/2);
+				m.nandIfZero.push_back(0);
+				m.nandIfOne.push_back(0);
+				m.occurrences.push_back(vector<int>());
+			}
+			if(*p%2)
+				m.nandIfOne[v]++;
+			else
+				m.nandIfZero[v]++;
+		}
+	}
+	int n = m.variables.size();
+
+	SwitchingActivity activity;
+	switchingCase worst, best;
+	activity.exact = n<=maxExactVariables;
+	if(activity.exact){
+		uint64_t blocks = n>6? 1ULL<<(n-6) : 1;
+		pair<int,uint64_t> worstIndex(-1,0), bestIndex(INT_MAX,0);
+		if(jobs>1 && blocks>blocksPerChunk){
+			//chunks of blocks on the threads, merged in order
+			uint64_t chunks = (blocks+blocksPerChunk-1)/blocksPerChunk;
+			vector< pair<int,uint64_t> > worsts(chunks, worstIndex), bests(chunks, bestIndex);
+			ThreadPool pool(min<uint64_t>(jobs,chunks));
+			for(uint64_t k=0; k<chunks; k++)
+				pool.submit([&m,&worsts,&bests,k,blocks]{
+					exhaustiveRange(m, k*blocksPerChunk, min(blocks,(k+1)*blocksPerChunk), &worsts[k], &bests[k]);
+				});
+			pool.wait();
+			for(uint64_t k=0; k<chunks; k++){
+				if(worsts[k].first>worstIndex.first)
+					worstIndex = worsts[k];
+				if(bests[k].first<bestIndex.first)
+					bestIndex = bests[k];
+			}
+		}
+		else
+			exhaustiveRange(m, 0, blocks, &worstIndex, &bestIndex);
+		worst.value = worstIndex.first;
+		best.value = bestIndex.first;
+		for(int v=0; v<n; v++){
+			worst.x.push_back((worstIndex.second>>v)&1);
+			best.x.push_back((bestIndex.second>>v)&1);
+		}
+	}
+	else{
+		//the first search starts from the greedy vectors, the others from random ones
+		vector<switchingCase> worsts(numRestarts), bests(numRestarts);
+		auto search = [&m,&worsts,&bests,n](int r){
+			vector<char> start(n);
+			if(r==0){
+				for(int v=0; v<n; v++)
+					start[v] = m.nandIfOne[v]>m.nandIfZero[v];
+				worsts[r] = localSearch(m, start, true);
+				for(int v=0; v<n; v++)
+					start[v] = !start[v];
+				bests[r] = localSearch(m, start, false);
+			}
+			else{
+				mt19937 random(r);
+				for(int v=0; v<n; v++)
+					start[v] = random()&1;
+				worsts[r] = localSearch(m, start, true);
+				bests[r] = localSearch(m, start, false);
+			}
+		};
+		if(jobs>1){
+			ThreadPool pool(min(jobs,numRestarts));
+			for(int r=0; r<numRestarts; r++)
+				pool.submit([&search,r]{search(r);});
+			pool.wait();
+		}
+		else
+			for(int r=0; r<numRestarts; r++)
+				search(r);
+		worst = worsts[0];
+		best = bests[0];
+		for(int r=1; r<numRestarts; r++){
+			if(worsts[r].value>worst.value)
+				worst = worsts[r];
+			if(bests[r].value<best.value)
+				best = bests[r];
+		}
+		//how far they can be: all the NAND memristors of the best choice and all the output ones
+		int most = m.cubes.size(), fewest = 0;
+		for(int v=0; v<n; v++){
+			most += max(m.nandIfZero[v], m.nandIfOne[v]);
+			fewest += min(m.nandIfZero[v], m.nandIfOne[v]);
+		}
+		activity.worstError = most-worst.value;
+		activity.bestError = best.value-fewest;
+	}
+
+	activity.worst = worst.value;
+	activity.best = best.value;
+	activity.worstVector.assign(this->variables.size(), false);
+	activity.bestVector.assign(this->variables.size(), false);
+	for(int v=0; v<n; v++){
+		activity.worstVector[m.variables[v]] = worst.x[v]!=0;
+		activity.bestVector[m.variables[v]] = best.x[v]!=0;
+	}
+	return activity;
+}
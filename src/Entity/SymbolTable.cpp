@@ -0,0 +1,103 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * SymbolTable.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "entities.h"
+#include <cstring>
+
+using namespace std;
+
+/**
+ * FNV-1a hash of the 'length' characters starting at 's'
+ */
+unsigned int SymbolTable::hashOf(const char* s, size_t length){
+	unsigned int h = 2166136261u;
+	for(size_t i=0; i<length; i++){
+		h ^= (unsigned char)s[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/**
+ * doubles the open addressing table (each slot keeps the hash of its name, so that
+ * neither rehashing nor most of the mismatches need to touch the names)
+ */
+void SymbolTable::grow(){
+	vector<slot> old;
+	old.swap(this->slots);
+	size_t capacity = old.empty()? 1024 : old.size()*2;
+	slot empty = {0,0};
+	this->slots.assign(capacity, empty);
+	size_t mask = capacity-1;
+	for(vector<slot>::const_iterator s = old.begin(); s != old.end(); s++){
+		if(s->id==0)
+			continue;
+		size_t i = s->hash & mask;
+		while(this->slots[i].id!=0)
+			i = (i+1) & mask;
+		this->slots[i] = *s;
+	}
+}
+
+/**
+ * returns the symbol of the name made of 'length' characters starting at 's', adding it if it's new
+ */
+symbol SymbolTable::intern(const char* s, size_t length){
+	if((this->names.size()+1)*2 > this->slots.size())
+		grow();
+	unsigned int h = hashOf(s,length);
+	size_t mask = this->slots.size()-1;
+	size_t i = h & mask;
+	while(this->slots[i].id!=0){
+		if(this->slots[i].hash==h){
+			const string& found = this->names[this->slots[i].id-1];
+			if(found.size()==length && memcmp(found.data(),s,length)==0)
+				return this->slots[i].id-1;
+		}
+		i = (i+1) & mask;
+	}
+	this->names.push_back(string(s,length));
+	this->slots[i].hash = h;
+	this->slots[i].id = this->names.size();
+	return this->names.size()-1;
+}
+
+/**
+ * retrieves the symbol of the name 's' without adding it
+ */
+bool SymbolTable::lookup(const string& s, symbol* sym) const{
+	if(this->slots.empty())
+		return false;
+	unsigned int h = hashOf(s.data(),s.size());
+	size_t mask = this->slots.size()-1;
+	for(size_t i = h & mask; this->slots[i].id!=0; i = (i+1) & mask){
+		if(this->slots[i].hash==h && this->names[this->slots[i].id-1]==s){
+			*sym = this->slots[i].id-1;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,71 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures. 
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * allocation_counter.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+//the global operator new is replaced only in the programs which link this file,
+//so that the library doesn't change the allocator of the programs embedding it
+
+#include "profiler.h"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+void* operator new(size_t size){
+	Profiler::countAllocation();
+	void* p = malloc(size==0? 1 : size);
+	if(p==NULL)
+		throw bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size){
+	return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept{
+	Profiler::countAllocation();
+	return malloc(size==0? 1 : size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept{
+	return operator new(size, nothrow);
+}
+
+void operator delete(void* p) noexcept{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept{
+	free(p);
+}
+
+void operator delete(void* p, const nothrow_t&) noexcept{
+	free(p);
+}
+
+void operator delete[](void* p, const nothrow_t&) noexcept{
+	free(p);
+}
@@ -29,52 +29,82 @@
 #include <sys/wait.h>
 #include <chrono>
 #include <my_utils.h>
+#include <thread_pool.h>
+#include <profiler.h>
+#include <cstdlib>
 
 using namespace std;
 
-executionParameters execParameters;
-chrono::high_resolution_clock::time_point startTime;
-
-bool evaluate(string s);
+bool evaluate(string s, executionParameters& options);
 string usage();
+int compileBatch(XbarGenContext&, const vector<string>&, string);
 
 int main (int argc, char *argv[]){
+	//the synthesis runs in the context of the command line
+	XbarGenContext context;
+	executionParameters& options = context.options;
 	if(argc>1){
 		int file=0;
+		vector<string> batch;
+		string outputDir;
 		for(int i=1; i<argc;i++){
+			//the number of jobs is the next argument
+			if(string(argv[i])=="--jobs"){
+				if(i+1<argc){
+					options.jobs = atoi(argv[++i]);
+					if(options.jobs<=0)
+						options.jobs = ThreadPool::hardwareThreads();
+				}
+				else
+					cout<<"--jobs ignored\n";
+				continue;
+			}
+			//the trace file is the next argument
+			if(string(argv[i])=="--trace"){
+				if(i+1<argc)
+					options.traceFile = argv[++i];
+				else
+					cout<<"--trace ignored\n";
+				continue;
+			}
+			if(string(argv[i])=="--cache"){
+				if(i+1<argc)
+					options.cacheDir = argv[++i];
+				else
+					cout<<"--cache ignored\n";
+				continue;
+			}
+			//the list (or the directory) of the designs to compile is the next argument
+			if(string(argv[i])=="--batch"){
+				if(i+1<argc)
+					batch.push_back(argv[++i]);
+				else
+					cout<<"--batch ignored\n";
+				continue;
+			}
+			//the output directory of the batch is the next argument
+			if(string(argv[i])=="--out"){
+				if(i+1<argc)
+					outputDir = argv[++i];
+				else
+					cout<<"--out ignored\n";
+				continue;
+			}
 			//evaluate option
-			if(evaluate(string(argv[i])))
+			if(evaluate(string(argv[i]),options))
 				file=i;
 		}
+		if(!batch.empty())
+			return compileBatch(context,batch,outputDir);
 		if(file!=0){
-			//if user wants statistics
-			if(execParameters.stat){
-				//start taking time
-				startTime = chrono::high_resolution_clock::now();
-			}
-			string str(argv[file]);
-			Analyzer an(str);
-
-			//the analyzer extracts a model of the input function
-			an.analyzeFunctionFromEQN();
-
-			//the analyzer explores the function's subsets
-			an.createDependenciesGraph();
-
-			//for each subset, the analyzer generates the corresponding crossbar
-			an.generateCrossbar();
-
-			//if user wants the vhdl implementation of the circuit
-			if(execParameters.vhdl){
-				if(!loadVHDLReservedWords())
-					cout<<"WARNING: VHDL reserved words are not loaded\n";
-				//generate the VHDL output
-				an.generateOutputVHDL();
-			}
-			//if user wants statistics
-			if(execParameters.stat)
-				//print out statistics
-				an.printOutputStats();
+			//the phases are profiled for the statistics' report and for the trace
+			if(options.stat || !options.traceFile.empty())
+				context.profiler.enable();
+			if(!context.compile(argv[file]))
+				return 1;
+			//if user wants the trace of the phases
+			if(!options.traceFile.empty())
+				context.profiler.writeTrace(options.traceFile);
 		}
 		else
 			//print help
@@ -87,41 +117,99 @@ int main (int argc, char *argv[]){
 
 	return 0;
 }
+
+/**
+ * compiles the designs of the lists (or directories) 'inputs' in the same process, with the options of 'context',
+ * each one in its own subdirectory of 'outputDir', and prints the statistics of the batch.
+ * The designs are compiled --jobs at a time (one per hardware thread if it isn't given), and the levels
+ * of each design one at a time. Returns 1 if a design fails, also when its crossbars don't pass the checks
+ * demanded (--simulate, --verify).
+ */
+int compileBatch(XbarGenContext& context, const vector<string>& inputs, string outputDir){
+	if(context.options.stat || !context.options.traceFile.empty())
+		context.profiler.enable();
+	BatchCompiler batch(context, outputDir);
+	for(vector<string>::const_iterator i = inputs.begin(); i != inputs.end(); ++i)
+		if(!batch.addInputs(*i))
+			return 1;
+
+	int failed = batch.run(context.options.jobs>0? context.options.jobs : ThreadPool::hardwareThreads());
+	batch.printStats();
+	if(!context.options.traceFile.empty())
+		context.profiler.writeTrace(context.options.traceFile);
+	return failed>0? 1 : 0;
+}
+
 /**
 *returns the usage guide
 */
 string usage(){
 	return 	"Usage:\n"
-			"\tXbarGen <filename.eqn> [--help] [--graph] [--dgraph] [--stat] [--vhdl] [--verbose]\n"
+			"\tXbarGen <filename.eqn> [--help] [--graph] [--dgraph] [--stat] [--vhdl] [--verbose] [--minimize] [--no-share] [--simulate] [--verify] [--shared-clock] [--sparse] [--jobs N] [--trace FILE] [--cache DIR]\n"
+			"\tXbarGen --batch <directory|list> [--out DIR] [--graph] [--dgraph] [--stat] [--vhdl] [--minimize] [--no-share] [--simulate] [--verify] [--shared-clock] [--sparse] [--jobs N] [--trace FILE] [--cache DIR]\n"
 			"\n"
 			"\n"
 			"\tOptions:\n"
 			"\t--help     Show this screen.\n"
 			"\t--graph    Produce the dependencies' graph of the boolean function (.dot format).\n"
 			"\t--dgraph   If --graph is set, produce dependencies' graph of each 'level'(*) of the function.\n"
-			"\t--stat     Produce a textual file with some statistics about the circuit.\n"
+			"\t--stat     Produce a textual file with some statistics about the circuit, and its JSON version\n"
+			"\t           with the time, the memory and the allocations of each phase.\n"
 			"\t--vhdl     Produce a memristor based crossbar behavioral implementation of the given function (VHDL language).\n"
-			"\t--verbose  Print informations about the translation's process.\n";
+			"\t--verbose  Print informations about the translation's process.\n"
+			"\t--minimize Minimize the function of each crossbar (Espresso-like heuristic) before generating it.\n"
+			"\t--no-share Write the VHDL entity of each crossbar, even when another crossbar computes the same function\n"
+			"\t           of its inputs (by default such crossbars are instances of the same entity).\n"
+			"\t--simulate Simulate the stages of each crossbar (memristor thresholds included) on all the input vectors\n"
+			"\t           (a random sample of them beyond 20 inputs), and check its outputs against its function:\n"
+			"\t           a wrong output fails the compilation (in a batch, the design).\n"
+			"\t--verify   Check that the crossbars compute the function of the EQN file: on all the input vectors up to\n"
+			"\t           20 inputs, otherwise on a random sample of them and then by SAT; a difference is reported\n"
+			"\t           with an input vector which shows it, and fails the compilation (in a batch, the design).\n"
+			"\t--shared-clock Generate the VHDL with one clock, in the top entity, for all the controllers and their\n"
+			"\t           memristors (Memristor_behavioral_Snider_shared_clock models), instead of one clock each.\n"
+			"\t--sparse   Write the structure of each crossbar as the list of its memristors (row, column, tag)\n"
+			"\t           instead of the whole matrix, and instantiate them with a loop over the list.\n"
+			"\t--jobs N   Generate the crossbars of N levels at a time, in parallel (0 = one per hardware thread).\n"
+			"\t--trace FILE Write the phases of the execution to FILE as Chrome trace events (chrome://tracing).\n"
+			"\t--cache DIR Keep the crossbars (and their VHDL files) in DIR: the levels already translated by a previous\n"
+			"\t           run with the same options are taken from there instead of being generated again.\n"
+			"\t--batch PATH Compile all the .eqn files of the directory PATH (or the files listed in PATH, one per line)\n"
+			"\t           in the same process, N designs at a time (--jobs, one per hardware thread by default),\n"
+			"\t           each one in its own directory; then print a table with the statistics of the batch.\n"
+			"\t--out DIR  Write the directories of the designs of the batch inside DIR (default: current directory).\n";
 }
 
 /**
  * evaluate 's' for understanding whether it is an option or the input file
- * if it's an option, activate such option
+ * if it's an option, activate such option in 'options'
  */
-bool evaluate(string s){
+bool evaluate(string s, executionParameters& options){
 	if(s.at(0)=='-'){
 		if(s=="--help")
 			cout<<usage();
 		else if(s=="--graph")
-			execParameters.dot = true;
+			options.dot = true;
 		else if(s=="--dgraph")
-			execParameters.deepDot = true;
+			options.deepDot = true;
 		else if(s=="--stat")
-			execParameters.stat = true;
+			options.stat = true;
 		else if(s=="--vhdl")
-			execParameters.vhdl = true;
+			options.vhdl = true;
 		else if(s=="--verbose")
-			execParameters.verbose = true;
+			options.verbose = true;
+		else if(s=="--minimize")
+			options.minimize = true;
+		else if(s=="--no-share")
+			options.shareEntities = false;
+		else if(s=="--simulate")
+			options.simulate = true;
+		else if(s=="--verify")
+			options.verify = true;
+		else if(s=="--shared-clock")
+			options.sharedClock = true;
+		else if(s=="--sparse")
+			options.sparseStructure = true;
 		else
 			cout<<s<<" ignored\n";
 		return false;
@@ -25,12 +25,10 @@
  *      Author: Marcello Traiola
  */
 #include <my_utils.h>
+#include "boundary.h"
 #include <iostream>
 using namespace std;
 
-unordered_map<string,char> VHDL_Reserved_Words;
-unordered_map<string,string> badStringMap;
-
 
 /**
  * returns the trimmed string 'str' without modifying the original one
@@ -92,44 +90,37 @@ void replace_substring(string* s, const string old_string, const string new_stri
 }
 
 /**
- * retrieves, from the set of Nodes 'n', the one named as string 's'
+ * retrieves, from the graph 'g', the node named as symbol 's' (INVALID if there isn't)
  */
-ListDigraph::NodeIt getVertexByName(ListDigraph* g,ListDigraph::NodeMap<string> *n, string s){
-	for(ListDigraph::NodeIt i(*g); i != INVALID; ++i){
-		if((*n)[i] == s)
-			return i;
-	}
-	return INVALID;
+ListDigraph::Node getVertexByName(const DependencyGraph* g, symbol s){
+	return g->node(s);
 }
 
 /**
- * generates a file .dot of the graph composed by the set of nodes 'nodeNames'
+ * generates a file .dot of the graph 'g', in the directory 'dir'
  */
-void generateDOTfromGraph(int level, ListDigraph* g,ListDigraph::NodeMap<string>* nodeNames){
-	typedef ListDigraph::ArcIt EdgeIt;
-	typedef ListDigraph::NodeIt NodeIt;
-
-	string file("./dependency_graph"+ (level!=-1? "_"+to_string(level):"") +".dot");
-	std::ofstream out(file.c_str());
-	std::streambuf *coutbuf = std::cout.rdbuf(); //save old buf
-	std::cout.rdbuf(out.rdbuf()); //redirect std::cout
-
-	cout << "digraph lemon_dot_example {" << endl;
-	cout << "  node [ shape=ellipse, fontname=Helvetica, fontsize=10 ];" << endl;
-	for(NodeIt n(*g); n!=INVALID; ++n) {
-		string name = (*nodeNames)[n];
-		replace_substring(&name,"not_","");
-		cout << name << " [ label=\"" << name << "\" ]; " << endl;
+void generateDOTfromGraph(const string& dir, int level, const FrozenGraph* g){
+
+	string file(dir+"dependency_graph"+ (level!=-1? "_"+to_string(level):"") +".dot");
+	FileWriter out(file);
+
+	out << "digraph lemon_dot_example {" << '\n';
+	out << "  node [ shape=ellipse, fontname=Helvetica, fontsize=10 ];" << '\n';
+	for(int n=0; n<g->numNodes(); n++) {
+		const string& name = signalTable().name(g->name(n));
+		out << name << " [ label=\"" << name << "\" ]; " << '\n';
 	}
-	cout << "  edge [ shape=ellipse, fontname=Helvetica, fontsize=10 ];" << endl;
-	for(EdgeIt e(*g); e!=INVALID; ++e) {
-		string sourceName = (*nodeNames)[(*g).source(e)], targetName = (*nodeNames)[(*g).target(e)];
-		replace_substring(&sourceName,"not_","");
-		replace_substring(&targetName,"not_","");
-		cout <<sourceName << " -> " << targetName << " [ label=\"" << (*g).id(e) << "\" ]; " << endl;
+	out << "  edge [ shape=ellipse, fontname=Helvetica, fontsize=10 ];" << '\n';
+	//arcs are numbered in the order they're stored
+	int arc = 0;
+	for(int n=0; n<g->numNodes(); n++) {
+		const string& sourceName = signalTable().name(g->name(n));
+		for(int t : g->outNodes(n)) {
+			const string& targetName = signalTable().name(g->name(t));
+			out <<sourceName << " -> " << targetName << " [ label=\"" << arc++ << "\" ]; " << '\n';
+		}
 	}
-	cout << "}" << endl;
-	std::cout.rdbuf(coutbuf); //reset to standard output again
+	out << "}" << '\n';
 
 	//automatically open Graphviz on MacOS
 	//	chmod(file.c_str(),strtol("0655", 0, 8));
@@ -141,78 +132,44 @@ void generateDOTfromGraph(int level, ListDigraph* g,ListDigraph::NodeMap<string>
 }
 
 /**
- * starting from a string 's', expected to be a VHDL name (e.g. instance of a signal), returns its 'clean' version
- * (not allowed characters and names are deleted or replaced)
+ * returns the numbers 0..n-1 in the order of their decimal strings (0, 1, 10, 100, 101, ..., 11, ..., 2, ...),
+ * i.e. the order of names such as "XbG_H<n>" in a sorted container, without building the names
  */
-string VHDLsintaxFilter(string s){
-	if(badStringMap.find(s) != badStringMap.end()){
-		s = badStringMap.find(s)->second;
-	}
-	else{
-		string initial = s;
-		while(s.find("[")!= std::string::npos){
-			s.replace(s.find("["),1,"_");
-		}
-		while(s.find("]")!= std::string::npos){
-			s.replace(s.find("]"),1,"_");
-		}
-		while(s.find("<")!= std::string::npos){
-			s.replace(s.find("<"),1,"_");
-		}
-		while(s.find(">")!= std::string::npos){
-			s.replace(s.find(">"),1,"_");
-		}
-		while(s.find(".")!= std::string::npos){
-			s.replace(s.find("."),1,"_");
+vector<int> decimalOrder(int n){
+	vector<int> order;
+	order.reserve(n);
+	if(n>0)
+		order.push_back(0);
+	long long x = 1;
+	while((int)order.size() < n){
+		order.push_back(x);
+		if(x*10 < n)
+			x *= 10;
+		else{
+			//back to the closest prefix with a next sibling
+			while(x%10 == 9 || x+1 >= n)
+				x /= 10;
+			x++;
 		}
-		while(s.find("__")!= std::string::npos){
-			s.replace(s.find("__"),2,"_");
-		}
-		while(s.back()=='_' || s.front()=='_' || s.front()=='-'|| isdigit(s.front())){
-			if(s.back()=='_'){
-				s.erase(--s.end());
-			}
-			if(s.front()=='_'){
-				s.erase(s.begin());
-			}
-			if(s.front()=='-'){
-				s.erase(s.begin());
-			}
-			while(isdigit(s.front())){
-				s.erase(s.begin());
-			}
-		}
-		if(!VHDL_Reserved_Words.empty()){
-			if(VHDL_Reserved_Words.find(s) != VHDL_Reserved_Words.end())
-				s = "XbG_" + s;
-		}
-
-		if(s.empty()){
-			//get a 7 random character string (lowercase)
-			for (int i=0;i<7;i++)
-				s += rand() % 25 + 97;
-		}
-		badStringMap.insert(make_pair(initial,s));
 	}
-	return s;
+	return order;
 }
 
 /**
- * load the VHDL 'reserved keywords' from file VHDLrsrvdWords.dat
+ * appends the 'size' bytes starting at 'data' to 's' (binary serialization)
  */
-bool loadVHDLReservedWords(){
-	string line;
-	ifstream myfile("./VHDLrsrvdWords.dat");
-	if (myfile.is_open())
-	{
-		while ( getline (myfile,line) )
-		{
-			VHDL_Reserved_Words.insert(make_pair(trim(line),NULL));
-		}
-		myfile.close();
-		return true;
-	}
-	else cout << "Unable to open file";
-	return false;
+void appendBytes(string* s, const void* data, size_t size){
+	s->append((const char*)data, size);
 }
 
+/**
+ * copies 'size' bytes of 's', starting at '*pos', into 'data' and moves '*pos' after them.
+ * Returns false if 's' is too short.
+ */
+bool readBytes(const string& s, size_t* pos, void* data, size_t size){
+	if(*pos > s.size() || s.size() - *pos < size)
+		return false;
+	memcpy(data, s.data() + *pos, size);
+	*pos += size;
+	return true;
+}
@@ -0,0 +1,294 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * profiler.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "profiler.h"
+#include "control.h"
+#include "boundary.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*** ALLOCATION COUNTING ***/
+
+//set by the first profiler enabled (the profilers of the batch's designs are enabled by the workers)
+static atomic<bool> countAllocations(false);
+
+//each thread counts its own allocations; the process count is spread over padded slots,
+//so that threads don't contend for the same cache line
+static thread_local uint64_t allocationsOfThread = 0;
+static thread_local int allocationSlot = -1;
+static const int numAllocationSlots = 64;
+struct alignas(64) paddedCounter{
+	atomic<uint64_t> count;
+};
+static paddedCounter allocationSlots[numAllocationSlots];
+static atomic<unsigned int> nextAllocationSlot(0);
+
+/**
+ * counts an allocation of the calling thread (it's called by the operator new of allocation_counter.cpp)
+ */
+void Profiler::countAllocation(){
+	if(!countAllocations.load(memory_order_relaxed))
+		return;
+	allocationsOfThread++;
+	if(allocationSlot<0)
+		allocationSlot = nextAllocationSlot++ % numAllocationSlots;
+	allocationSlots[allocationSlot].count.fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * allocations made by the calling thread since the profiler was enabled
+ */
+uint64_t Profiler::threadAllocations(){
+	return allocationsOfThread;
+}
+
+/**
+ * allocations made by all the threads since the profiler was enabled
+ */
+uint64_t Profiler::processAllocations(){
+	uint64_t n = 0;
+	for(int i=0; i<numAllocationSlots; i++)
+		n += allocationSlots[i].count.load(memory_order_relaxed);
+	return n;
+}
+
+/*** MEMORY ***/
+
+/**
+ * resident memory of the process (kB), 0 if it can't be read
+ */
+long Profiler::residentMemory(){
+	//read without allocating (it's sampled inside the phases)
+	char buffer[128];
+	int fd = open("/proc/self/statm", O_RDONLY);
+	if(fd<0)
+		return 0;
+	ssize_t n = read(fd, buffer, sizeof(buffer)-1);
+	close(fd);
+	if(n<=0)
+		return 0;
+	buffer[n] = '\0';
+	long pages = 0, resident = 0;
+	if(sscanf(buffer, "%ld %ld", &pages, &resident)!=2)
+		return 0;
+	return resident * (sysconf(_SC_PAGESIZE)/1024);
+}
+
+/**
+ * peak resident memory of the process (kB)
+ */
+long Profiler::peakResidentMemory(){
+	//the kernel updates the peak lazily: it can be behind the current resident memory
+	long current = residentMemory();
+	long peak = 0;
+	//VmHWM follows resetPeakResidentMemory(), getrusage() doesn't
+	char buffer[4096];
+	int fd = open("/proc/self/status", O_RDONLY);
+	if(fd>=0){
+		ssize_t n = read(fd, buffer, sizeof(buffer)-1);
+		close(fd);
+		buffer[n>0? n : 0] = '\0';
+		const char* hwm = strstr(buffer, "VmHWM:");
+		if(hwm==NULL || sscanf(hwm+6, "%ld", &peak)!=1)
+			peak = 0;
+	}
+	if(peak==0){
+		struct rusage usage;
+		if(getrusage(RUSAGE_SELF, &usage)==0)
+			peak = usage.ru_maxrss;
+	}
+	return peak > current? peak : current;
+}
+
+/**
+ * Restarts the peak resident memory from the current one (Linux only: /proc/self/clear_refs),
+ * so that the following phases can be measured on their own
+ */
+bool Profiler::resetPeakResidentMemory(){
+	int fd = open("/proc/self/clear_refs", O_WRONLY);
+	if(fd<0)
+		return false;
+	bool ok = write(fd, "5", 1)==1;
+	close(fd);
+	return ok;
+}
+
+/*** PROFILER ***/
+
+/**
+ * Starts the profiling: the calling thread becomes the thread 0.
+ * It must be called before the worker threads of its context start.
+ */
+void Profiler::enable(){
+	this->enabled = true;
+	this->start = chrono::steady_clock::now();
+	this->threads[this_thread::get_id()] = 0;
+	countAllocations.store(true, memory_order_relaxed);
+}
+
+/**
+ * ms since the profiler was enabled
+ */
+double Profiler::elapsed() const{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - this->start).count();
+}
+
+/**
+ * adds a phase, numbering the thread that ran it
+ */
+void Profiler::record(phaseRecord& phase){
+	lock_guard<mutex> g(this->lock);
+	map<thread::id, int>::iterator t = this->threads.find(this_thread::get_id());
+	if(t==this->threads.end())
+		t = this->threads.insert(make_pair(this_thread::get_id(), (int)this->threads.size())).first;
+	phase.thread = t->second;
+	this->phases.push_back(phase);
+}
+
+/**
+ * returns the phases recorded so far and forgets them (e.g. between the runs of a benchmark)
+ */
+vector<phaseRecord> Profiler::takePhases(){
+	lock_guard<mutex> g(this->lock);
+	vector<phaseRecord> taken;
+	taken.swap(this->phases);
+	return taken;
+}
+
+/**
+ * returns 's' as a JSON string
+ */
+static string jsonString(const string& s){
+	string quoted = "\"";
+	for(size_t i=0; i<s.size(); i++){
+		if(s[i]=='"' || s[i]=='\\')
+			quoted += '\\';
+		if((unsigned char)s[i] < 0x20)
+			quoted += ' ';
+		else
+			quoted += s[i];
+	}
+	return quoted + "\"";
+}
+
+/**
+ * Writes the JSON report of the execution of 'entity': its statistics ('stats', in the given order),
+ * the peak memory, the allocations and the phases (in the order they ended)
+ */
+bool Profiler::writeReport(string file, string entity, const vector< pair<string, double> >& stats){
+	lock_guard<mutex> g(this->lock);
+	FileWriter out(file);
+	out<<"{\n"
+			"\"entity\": "<<jsonString(entity)<<",\n"
+			"\"stats\": {";
+	for(size_t i=0; i<stats.size(); i++){
+		out<<(i==0? "\n\t" : ",\n\t")<<jsonString(stats[i].first)<<": ";
+		//counts are written with all their digits
+		double value = stats[i].second;
+		if(value==(double)(long long)value)
+			out<<(long long)value;
+		else
+			out<<value;
+	}
+	out<<"\n},\n"
+			"\"elapsed_ms\": "<<elapsed()<<",\n"
+			"\"peak_rss_kb\": "<<peakResidentMemory()<<",\n"
+			"\"allocations\": "<<(unsigned long long)processAllocations()<<",\n"
+			"\"threads\": "<<(unsigned long)this->threads.size()<<",\n"
+			"\"phases\": [";
+	for(size_t i=0; i<this->phases.size(); i++){
+		const phaseRecord& p = this->phases[i];
+		out<<(i==0? "\n\t" : ",\n\t")<<"{\"name\": "<<jsonString(p.name)<<", \"level\": "<<p.level
+				<<", \"thread\": "<<p.thread<<", \"start_ms\": "<<p.start<<", \"duration_ms\": "<<p.duration
+				<<", \"allocations\": "<<(unsigned long long)p.allocations
+				<<", \"process_allocations\": "<<(unsigned long long)p.processAllocations
+				<<", \"rss_kb\": "<<p.rss<<", \"peak_rss_kb\": "<<p.peakRss<<"}";
+	}
+	out<<"\n]\n"
+			"}\n";
+	return out.close();
+}
+
+/**
+ * Writes the phases as Chrome trace events ("complete" events, one track per thread),
+ * so that the execution can be opened in a trace viewer
+ */
+bool Profiler::writeTrace(string file){
+	lock_guard<mutex> g(this->lock);
+	FileWriter out(file);
+	out<<"{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+	//the threads' names come first, as metadata events
+	const char* separator = "\n";
+	for(map<thread::id, int>::const_iterator t = this->threads.begin(); t != this->threads.end(); t++){
+		out<<separator<<"{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "<<t->second
+				<<", \"args\": {\"name\": "<<jsonString(t->second==0? "main" : "worker "+to_string(t->second))<<"}}";
+		separator = ",\n";
+	}
+	for(size_t i=0; i<this->phases.size(); i++){
+		const phaseRecord& p = this->phases[i];
+		string name = p.level<0? p.name : p.name+" (level "+to_string(p.level)+")";
+		out<<separator<<"{\"name\": "<<jsonString(name)<<", \"cat\": \"phase\", \"ph\": \"X\", \"pid\": 1, \"tid\": "<<p.thread
+				<<", \"ts\": "<<(long long)(p.start*1000)<<", \"dur\": "<<(long long)(p.duration*1000)
+				<<", \"args\": {\"level\": "<<p.level<<", \"allocations\": "<<(unsigned long long)p.allocations
+				<<", \"rss_kb\": "<<p.rss<<", \"peak_rss_kb\": "<<p.peakRss<<"}}";
+		separator = ",\n";
+	}
+	out<<"\n]}\n";
+	return out.close();
+}
+
+/*** TIMER ***/
+
+PhaseTimer::PhaseTimer(const char* name, int level) : profiler(currentContext().profiler), name(name), level(level),
+		active(profiler.isEnabled()){
+	if(!this->active)
+		return;
+	this->allocations = Profiler::threadAllocations();
+	this->processAllocations = Profiler::processAllocations();
+	this->start = this->profiler.elapsed();
+}
+
+PhaseTimer::~PhaseTimer(){
+	if(!this->active)
+		return;
+	phaseRecord phase;
+	phase.duration = this->profiler.elapsed() - this->start;
+	phase.allocations = Profiler::threadAllocations() - this->allocations;
+	phase.processAllocations = Profiler::processAllocations() - this->processAllocations;
+	phase.rss = Profiler::residentMemory();
+	phase.peakRss = Profiler::peakResidentMemory();
+	phase.name = this->name;
+	phase.level = this->level;
+	phase.start = this->start;
+	this->profiler.record(phase);
+}
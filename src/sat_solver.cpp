@@ -0,0 +1,425 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * sat_solver.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "sat_solver.h"
+#include <algorithm>
+
+using namespace std;
+
+//conflicts before the first restart (multiplied by the Luby sequence)
+static const long restartBase = 100;
+static const double variableDecay = 0.95;
+static const float clauseDecay = 0.999f;
+
+/**
+ * returns the element 'i' of the Luby sequence (1 1 2 1 1 2 4 1 1 2 ...)
+ */
+static long luby(long i){
+	long size = 1;
+	int seq = 0;
+	while(size<i+1){
+		seq++;
+		size = 2*size+1;
+	}
+	while(size-1!=i){
+		size = (size-1)>>1;
+		seq--;
+		i = i%size;
+	}
+	return 1L<<seq;
+}
+
+SatSolver::SatSolver() : numLearned(0), propagated(0), activityStep(1), clauseStep(1), consistent(true){
+}
+
+/**
+ * Adds a variable to the formula and returns it
+ */
+int SatSolver::newVar(){
+	int v = assigns.size();
+	assigns.push_back(-1);
+	phase.push_back(0);
+	levels.push_back(0);
+	reasons.push_back(-1);
+	activity.push_back(0);
+	heapIndex.push_back(-1);
+	seen.push_back(0);
+	watches.resize(2*assigns.size());
+	heapInsert(v);
+	return v;
+}
+
+/**
+ * Adds a clause (a disjunction of literals) to the formula, before solve() is called.
+ * Returns false if the formula can't be satisfied anymore.
+ */
+bool SatSolver::addClause(vector<lit> c){
+	if(!consistent)
+		return false;
+	sort(c.begin(), c.end());
+	size_t n = 0;
+	for(size_t i=0; i<c.size(); i++){
+		int v = valueOf(c[i]);
+		if(v==1 || (n>0 && c[n-1]==(c[i]^1)))
+			return true;	//already satisfied, or a tautology
+		if(v==0 || (n>0 && c[n-1]==c[i]))
+			continue;
+		c[n++] = c[i];
+	}
+	c.resize(n);
+	if(c.empty())
+		return consistent = false;
+	if(c.size()==1){
+		assign(c[0], -1);
+		return consistent = propagate()<0;
+	}
+	clause k = {(int)literals.size(), (int)c.size(), false, 0};
+	literals.insert(literals.end(), c.begin(), c.end());
+	clauses.push_back(k);
+	watch(clauses.size()-1);
+	return true;
+}
+
+/**
+ * Watches the clause 'c' through its first two literals
+ */
+void SatSolver::watch(int c){
+	const lit* l = &literals[clauses[c].start];
+	watches[l[0]].push_back(watcher{c, l[1]});
+	watches[l[1]].push_back(watcher{c, l[0]});
+}
+
+/**
+ * Makes 'l' true at the current decision level, implied by the clause 'reason' (-1 for a decision)
+ */
+void SatSolver::assign(lit l, int reason){
+	int v = l>>1;
+	assigns[v] = (l&1)? 0 : 1;
+	levels[v] = decisionLevel();
+	reasons[v] = reason;
+	trail.push_back(l);
+}
+
+/**
+ * Propagates the literals of the trail not propagated yet: a clause with all its literals false but one
+ * implies that one. Returns the clause found with all its literals false, or -1.
+ */
+int SatSolver::propagate(){
+	int conflict = -1;
+	while(propagated<trail.size() && conflict<0){
+		lit falsified = trail[propagated++]^1;
+		vector<watcher>& ws = watches[falsified];
+		size_t i = 0, j = 0;
+		while(i<ws.size()){
+			watcher w = ws[i++];
+			if(valueOf(w.blocker)==1){
+				ws[j++] = w;
+				continue;
+			}
+			clause& c = clauses[w.clause];
+			lit* l = &literals[c.start];
+			//the false literal goes second
+			if(l[0]==falsified)
+				swap(l[0], l[1]);
+			if(l[0]!=w.blocker && valueOf(l[0])==1){
+				ws[j++] = watcher{w.clause, l[0]};
+				continue;
+			}
+			int k = 2;
+			while(k<c.size && valueOf(l[k])==0)
+				k++;
+			if(k<c.size){
+				swap(l[1], l[k]);
+				watches[l[1]].push_back(watcher{w.clause, l[0]});
+				continue;
+			}
+			ws[j++] = watcher{w.clause, l[0]};
+			if(valueOf(l[0])==0){
+				conflict = w.clause;
+				while(i<ws.size())
+					ws[j++] = ws[i++];
+			}
+			else
+				assign(l[0], w.clause);
+		}
+		ws.resize(j);
+	}
+	return conflict;
+}
+
+/**
+ * Learns a clause from the clause 'conflict' (all its literals false): the literals of the lower levels
+ * which imply it, and the negation of the first unique implication point of the current level, which goes first.
+ * The literals implied by other literals of the clause are removed. Returns in 'back' the level to backtrack to.
+ */
+void SatSolver::analyze(int conflict, vector<lit>& learned, int* back){
+	learned.assign(1, 0);
+	int pending = 0;
+	int index = trail.size()-1;
+	lit p = 0;
+	bool first = true;
+	do{
+		clause& c = clauses[conflict];
+		if(c.learned)
+			bumpClause(c);
+		const lit* l = &literals[c.start];
+		//the first literal of a reason is the one it implied
+		for(int k = first? 0 : 1; k<c.size; k++){
+			int v = l[k]>>1;
+			if(seen[v] || levels[v]==0)
+				continue;
+			seen[v] = 1;
+			bumpVariable(v);
+			if(levels[v]>=decisionLevel())
+				pending++;
+			else
+				learned.push_back(l[k]);
+		}
+		first = false;
+		while(!seen[trail[index]>>1])
+			index--;
+		p = trail[index--];
+		conflict = reasons[p>>1];
+		seen[p>>1] = 0;
+		pending--;
+	}while(pending>0);
+	learned[0] = p^1;
+
+	//a literal is redundant if the other literals of its reason are already there
+	analyzed = learned;
+	size_t n = 1;
+	for(size_t i=1; i<learned.size(); i++){
+		int r = reasons[learned[i]>>1];
+		bool keep = r<0;
+		if(!keep){
+			const lit* l = &literals[clauses[r].start];
+			for(int k=1; k<clauses[r].size && !keep; k++)
+				keep = !seen[l[k]>>1] && levels[l[k]>>1]>0;
+		}
+		if(keep)
+			learned[n++] = learned[i];
+	}
+	learned.resize(n);
+	for(size_t i=1; i<analyzed.size(); i++)
+		seen[analyzed[i]>>1] = 0;
+
+	//the literal of the highest level goes second, to be watched
+	*back = 0;
+	for(size_t i=1; i<learned.size(); i++){
+		if(levels[learned[i]>>1]>*back){
+			*back = levels[learned[i]>>1];
+			swap(learned[1], learned[i]);
+		}
+	}
+}
+
+/**
+ * Unassigns the variables of the levels above 'level', saving their values
+ */
+void SatSolver::backtrack(int level){
+	if(decisionLevel()<=level)
+		return;
+	for(int i = trail.size()-1; i>=trailLimits[level]; i--){
+		int v = trail[i]>>1;
+		phase[v] = assigns[v];
+		assigns[v] = -1;
+		reasons[v] = -1;
+		heapInsert(v);
+	}
+	trail.resize(trailLimits[level]);
+	trailLimits.resize(level);
+	propagated = trail.size();
+}
+
+void SatSolver::bumpVariable(int v){
+	activity[v] += activityStep;
+	if(activity[v]>1e100){
+		for(size_t i=0; i<activity.size(); i++)
+			activity[i] *= 1e-100;
+		activityStep *= 1e-100;
+	}
+	if(heapIndex[v]>=0)
+		heapUp(heapIndex[v]);
+}
+
+void SatSolver::bumpClause(clause& c){
+	c.activity += clauseStep;
+	if(c.activity>1e20f){
+		for(size_t i=0; i<clauses.size(); i++)
+			clauses[i].activity *= 1e-20f;
+		clauseStep *= 1e-20f;
+	}
+}
+
+void SatSolver::heapUp(int i){
+	int v = heap[i];
+	while(i>0 && activity[heap[(i-1)/2]]<activity[v]){
+		heap[i] = heap[(i-1)/2];
+		heapIndex[heap[i]] = i;
+		i = (i-1)/2;
+	}
+	heap[i] = v;
+	heapIndex[v] = i;
+}
+
+void SatSolver::heapDown(int i){
+	int v = heap[i];
+	int n = heap.size();
+	while(2*i+1<n){
+		int child = 2*i+1;
+		if(child+1<n && activity[heap[child+1]]>activity[heap[child]])
+			child++;
+		if(activity[heap[child]]<=activity[v])
+			break;
+		heap[i] = heap[child];
+		heapIndex[heap[i]] = i;
+		i = child;
+	}
+	heap[i] = v;
+	heapIndex[v] = i;
+}
+
+void SatSolver::heapInsert(int v){
+	if(heapIndex[v]>=0)
+		return;
+	heap.push_back(v);
+	heapUp(heap.size()-1);
+}
+
+int SatSolver::heapPop(){
+	int v = heap[0];
+	heapIndex[v] = -1;
+	heap[0] = heap.back();
+	heap.pop_back();
+	if(!heap.empty()){
+		heapIndex[heap[0]] = 0;
+		heapDown(0);
+	}
+	return v;
+}
+
+/**
+ * Drops the less active half of the learned clauses (but the binary ones), at decision level 0:
+ * the clauses are compacted, so the reasons of the variables assigned at level 0 are forgotten
+ * (they're never analyzed)
+ */
+void SatSolver::reduceLearned(){
+	vector<float> active;
+	for(size_t c=0; c<clauses.size(); c++)
+		if(clauses[c].learned && clauses[c].size>2)
+			active.push_back(clauses[c].activity);
+	if(active.empty())
+		return;
+	nth_element(active.begin(), active.begin()+active.size()/2, active.end());
+	float median = active[active.size()/2];
+
+	vector<lit> kept;
+	vector<clause> keptClauses;
+	numLearned = 0;
+	for(size_t c=0; c<clauses.size(); c++){
+		clause k = clauses[c];
+		if(k.learned && k.size>2 && k.activity<median)
+			continue;
+		numLearned += k.learned? 1 : 0;
+		kept.insert(kept.end(), literals.begin()+k.start, literals.begin()+k.start+k.size);
+		k.start = kept.size()-k.size;
+		keptClauses.push_back(k);
+	}
+	literals.swap(kept);
+	clauses.swap(keptClauses);
+	for(size_t l=0; l<watches.size(); l++)
+		watches[l].clear();
+	for(size_t c=0; c<clauses.size(); c++)
+		watch(c);
+	for(size_t i=0; i<trail.size(); i++)
+		reasons[trail[i]>>1] = -1;
+}
+
+/**
+ * Looks for an assignment which satisfies the formula, within 'budget' conflicts (no limit if it's negative).
+ * If it's found, the value of each variable is given by value().
+ */
+SatSolver::result SatSolver::solve(long budget){
+	if(!consistent || propagate()>=0)
+		return (consistent = false), unsatisfiable;
+	long conflicts = 0;
+	long maxLearned = clauses.size()/3+1000;
+	vector<lit> learned;
+	for(long restart=0; ; restart++){
+		long limit = conflicts+restartBase*luby(restart);
+		while(true){
+			int conflict = propagate();
+			if(conflict>=0){
+				conflicts++;
+				if(decisionLevel()==0)
+					return (consistent = false), unsatisfiable;
+				int back;
+				analyze(conflict, learned, &back);
+				backtrack(back);
+				if(learned.size()==1)
+					assign(learned[0], -1);
+				else{
+					clause k = {(int)literals.size(), (int)learned.size(), true, 0};
+					literals.insert(literals.end(), learned.begin(), learned.end());
+					clauses.push_back(k);
+					numLearned++;
+					bumpClause(clauses.back());
+					watch(clauses.size()-1);
+					assign(learned[0], clauses.size()-1);
+				}
+				activityStep /= variableDecay;
+				clauseStep /= clauseDecay;
+				continue;
+			}
+			if(budget>=0 && conflicts>=budget){
+				backtrack(0);
+				return undecided;
+			}
+			if(conflicts>=limit)
+				break;
+			int v = -1;
+			while(!heap.empty() && v<0){
+				v = heapPop();
+				if(assigns[v]>=0)
+					v = -1;
+			}
+			if(v<0){
+				model.assign(assigns.size(), false);
+				for(size_t i=0; i<assigns.size(); i++)
+					model[i] = assigns[i]==1;
+				backtrack(0);
+				return satisfiable;
+			}
+			trailLimits.push_back(trail.size());
+			assign(makeLit(v, phase[v]==0), -1);
+		}
+		backtrack(0);
+		if(numLearned>maxLearned){
+			reduceLearned();
+			maxLearned += maxLearned/10;
+		}
+	}
+}
@@ -0,0 +1,134 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * thread_pool.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "thread_pool.h"
+
+using namespace std;
+
+/**
+ * Constructor: starts 'numThreads' workers (at least one)
+ */
+ThreadPool::ThreadPool(int numThreads) : nextQueue(0), queued(0), unfinished(0), stopping(false){
+	if(numThreads<1)
+		numThreads = 1;
+	for(int i=0; i<numThreads; i++)
+		queues.push_back(new workQueue());
+	for(int i=0; i<numThreads; i++)
+		threads.push_back(thread(&ThreadPool::work, this, i));
+}
+
+/**
+ * returns the number of hardware threads (1 if it can't be detected)
+ */
+int ThreadPool::hardwareThreads(){
+	unsigned int n = thread::hardware_concurrency();
+	return n>0? n : 1;
+}
+
+/**
+ * Queues a task. Tasks are dealt round robin to the workers' queues,
+ * so the first ones submitted are the first ones to start
+ */
+void ThreadPool::submit(function<void()> task){
+	workQueue* q = queues[nextQueue];
+	nextQueue = (nextQueue+1)%queues.size();
+	//the task is counted before it can be taken, so that it can't be finished before being counted
+	{
+		lock_guard<mutex> g(stateLock);
+		unfinished++;
+		queued++;
+	}
+	{
+		lock_guard<mutex> g(q->lock);
+		q->tasks.push_back(task);
+	}
+	wakeUp.notify_one();
+}
+
+/**
+ * Takes a task for the worker 'self': from the front of its own queue or,
+ * if it's empty, from the back of another worker's queue
+ */
+bool ThreadPool::take(size_t self, function<void()>& task){
+	for(size_t i=0; i<queues.size(); i++){
+		workQueue* q = queues[(self+i)%queues.size()];
+		lock_guard<mutex> g(q->lock);
+		if(q->tasks.empty())
+			continue;
+		if(i==0){
+			task = q->tasks.front();
+			q->tasks.pop_front();
+		}
+		else{
+			task = q->tasks.back();
+			q->tasks.pop_back();
+		}
+		queued--;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Loop of the worker 'self': runs tasks until the pool is destroyed
+ */
+void ThreadPool::work(size_t self){
+	function<void()> task;
+	while(true){
+		if(take(self,task)){
+			task();
+			task = nullptr;
+			lock_guard<mutex> g(stateLock);
+			if(--unfinished==0)
+				allDone.notify_all();
+			continue;
+		}
+		unique_lock<mutex> l(stateLock);
+		wakeUp.wait(l, [this]{return stopping || queued>0;});
+		if(stopping && queued==0)
+			return;
+	}
+}
+
+/**
+ * Waits until all the submitted tasks are done
+ */
+void ThreadPool::wait(){
+	unique_lock<mutex> l(stateLock);
+	allDone.wait(l, [this]{return unfinished==0;});
+}
+
+ThreadPool::~ThreadPool(){
+	{
+		lock_guard<mutex> g(stateLock);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+	for(size_t i=0; i<threads.size(); i++)
+		threads[i].join();
+	for(size_t i=0; i<queues.size(); i++)
+		delete queues[i];
+}
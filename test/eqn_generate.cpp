@@ -0,0 +1,63 @@
+/*
+*   This file is part of XbarGen
+*   XbarGen is an open-source software system for synthesizing memristor-based crossbar architectures.
+*
+*    Copyright (C) 2016-2017  Marcello Traiola
+*
+*    This program is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Affero General Public License as
+*    published by the Free Software Foundation, either version 3 of the
+*    License, or (at your option) any later version.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * eqn_generate.cpp
+ *
+ *  Created on: 17/ott/2026
+ */
+
+#include "eqn_generator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+
+/**
+ * Usage: eqn_generate FILE FAMILY ARGS...
+ * Writes in FILE a netlist of the family:
+ * - random INPUTS NODES OUTPUTS SEED: random multi-level netlist (at most 4 minterms of 4 literals per signal)
+ * - pla INPUTS OUTPUTS CUBES SEED: random two-level PLA (at most 8 literals per cube)
+ * - adder BITS, multiplier BITS, comparator BITS
+ * Returns 1 if the arguments don't match the family.
+ */
+int main(int argc, char* argv[]){
+	string family = argc>2? argv[2] : "";
+	int a[4];
+	for(int i=0; i<4; i++)
+		a[i] = argc>3+i? atoi(argv[3+i]) : 0;
+	if(family=="random" && argc==7)
+		generateRandomNetlist(argv[1], a[0], a[1], a[2], 4, 4, a[3]);
+	else if(family=="pla" && argc==7)
+		generateWidePLA(argv[1], a[0], a[1], a[2], 8, a[3]);
+	else if(family=="adder" && argc==4)
+		generateCarryChain(argv[1], a[0]);
+	else if(family=="multiplier" && argc==4)
+		generateArrayMultiplier(argv[1], a[0]);
+	else if(family=="comparator" && argc==4)
+		generateComparator(argv[1], a[0]);
+	else{
+		printf("Usage: eqn_generate FILE random INPUTS NODES OUTPUTS SEED | pla INPUTS OUTPUTS CUBES SEED"
+				" | adder BITS | multiplier BITS | comparator BITS\n");
+		return 1;
+	}
+	return 0;
+}